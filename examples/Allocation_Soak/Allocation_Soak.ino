@@ -0,0 +1,187 @@
+#include <Arduino.h>
+#include "DMR828S.h"
+#include "DMR828S_sim.h"
+#include "DMR828S_mem.h"
+
+// Heap allocations per site over simulated hours (DMR828S_mem.h). Each
+// simulated minute carries a firmware-like load against the simulator: an
+// SMS received and answered, RSSI and status polls, and the String
+// notifications the application builds in its callbacks. The simulator
+// answers at once and the tracker runs on a simulated clock, so an hour
+// takes a fraction of a second and every rate is per simulated hour.
+//
+// Checks that the library stack itself does not allocate, that the
+// callbacks allocate at the same rate every hour, that live blocks come back
+// to where they started, and that a deliberate leak shows up.
+//
+// Build with -DDMR_MEM_HOOKS=1 so the allocator is counted; on the ESP32
+// the link also needs -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free.
+
+#define SOAK_HOURS          3
+#define SAMPLE_EVERY_MIN    10
+
+enum SoakSite : uint8_t { SITE_OTHER, SITE_STACK, SITE_CALLBACKS, SITE_LEAK, SITE_COUNT };
+static const char *const siteNames[SITE_COUNT] = { "other", "dmr stack", "callbacks", "leak" };
+DMRMemTracker mem(siteNames, SITE_COUNT);
+
+DMR828S_Simulator sim;
+DMR828S dmr(sim);
+
+static uint32_t simMs = 0;                  // Simulated clock
+static String lastNotice;                   // What the app would put on the display
+static uint16_t smsSeen = 0;
+static uint16_t smsWanted = 0;
+static bool smsStatusSeen = false;
+static char *leaked[60];
+static uint8_t passed = 0, failed = 0;
+
+void check(const char *name, bool ok) {
+    Serial.printf("  %s %s\n", ok ? "PASS" : "FAIL", name);
+    if (ok) passed++; else failed++;
+}
+
+// Callbacks build their messages the way the firmware does, in their own site
+void onSMS(const DMRSMSMessage &sms) {
+    DMR_MEM_SCOPE(SITE_CALLBACKS);
+    String output = "SMS from 0x" + String(sms.sourceID, HEX);
+    output += ": " + String(sms.message) + " (" + String(sms.parts) + " part)";
+    lastNotice = output;
+    smsSeen++;
+}
+
+void onSMSStatus(uint32_t targetID, SMSSendStatus status) {
+    DMR_MEM_SCOPE(SITE_CALLBACKS);
+    lastNotice = "SMS to 0x" + String(targetID, HEX) + (status == SMS_SEND_SUCCESS ? " delivered" : " failed");
+    smsStatusSeen = true;
+}
+
+static void pump(bool (*cond)()) {
+    unsigned long start = millis();
+    while (!cond() && millis() - start < 500) {
+        dmr.update();
+    }
+}
+
+static void simulatedMinute(uint16_t minute) {
+    DMR_MEM_SCOPE(SITE_STACK);
+    // Fixed length, so every minute allocates alike
+    char text[24];
+    snprintf(text, sizeof(text), "position %05u", minute);
+    smsWanted = smsSeen + 1;
+    sim.injectSMS(0x000002, text);
+    pump([]() { return smsSeen == smsWanted; });
+
+    smsStatusSeen = false;
+    dmr.sendSMS(0x000002, "ack", false);
+    pump([]() { return smsStatusSeen; });
+
+    sim.rssi = 0x20 + minute % 16;
+    dmr.getRSSI();
+    dmr.getModuleStatus();
+    simMs += 60000;
+    if (minute % SAMPLE_EVERY_MIN == SAMPLE_EVERY_MIN - 1) {
+        mem.sample(simMs);
+    }
+}
+
+static void runHour(uint16_t hour) {
+    for (uint16_t m = 0; m < 60; m++) {
+        simulatedMinute(hour * 60 + m);
+    }
+}
+
+static void runScopes() {
+    uint8_t outer = DMRMemTracker::currentSite();
+    bool nested;
+    {
+        DMR_MEM_SCOPE(SITE_STACK);
+        {
+            DMR_MEM_SCOPE(SITE_CALLBACKS);
+            nested = DMRMemTracker::currentSite() == SITE_CALLBACKS;
+        }
+        nested = nested && DMRMemTracker::currentSite() == SITE_STACK;
+    }
+    check("scopes nest and restore the outer site", nested && DMRMemTracker::currentSite() == outer);
+}
+
+static void runSoak() {
+    // One hour to settle: first-use allocations are not part of the steady rate
+    runHour(0);
+    mem.reset(simMs);
+    mem.sample(simMs);
+    int32_t liveStart = mem.getLiveBlocks();
+
+    DMRMemSiteStats hours[SOAK_HOURS + 1];
+    mem.getSite(SITE_CALLBACKS, hours[0]);
+    for (uint16_t h = 1; h <= SOAK_HOURS; h++) {
+        runHour(h);
+        mem.getSite(SITE_CALLBACKS, hours[h]);
+    }
+
+    DMRMemSiteStats stack, callbacks;
+    mem.getSite(SITE_STACK, stack);
+    mem.getSite(SITE_CALLBACKS, callbacks);
+    Serial.printf("  callbacks: %lu allocations per simulated hour\n",
+                  (unsigned long)(callbacks.operations() / SOAK_HOURS));
+    check("String callbacks are counted at their site", callbacks.allocs >= 2 * 60 * SOAK_HOURS);
+    check("library stack does not allocate", stack.operations() == 0);
+    bool steady = true;
+    for (uint16_t h = 2; h <= SOAK_HOURS; h++) {
+        steady = steady && hours[h].operations() - hours[h - 1].operations() ==
+                           hours[1].operations() - hours[0].operations();
+    }
+    check("same allocation rate every hour", steady);
+    check("no live-block growth over the soak", mem.getLiveBlocks() == liveStart);
+
+    // One hour leaking a block a minute: the leak site shows it, and the
+    // samples show live blocks climbing
+    uint32_t leakStart = simMs;
+    for (uint8_t m = 0; m < 60; m++) {
+        {
+            DMR_MEM_SCOPE(SITE_LEAK);
+            leaked[m] = new char[32];
+        }
+        simulatedMinute((SOAK_HOURS + 1) * 60 + m);
+    }
+    DMRMemSiteStats leak;
+    mem.getSite(SITE_LEAK, leak);
+    DMRHeapSample newest, hourAgo;
+    mem.getSample(0, newest);
+    mem.getSample(60 / SAMPLE_EVERY_MIN, hourAgo);
+    check("leak shows as live blocks per hour", leak.allocs == 60 && leak.frees == 0 &&
+          mem.getLiveBlocks() == liveStart + 60 && newest.liveBlocks - hourAgo.liveBlocks == 60 &&
+          DMRMemTracker::perHour(leak.allocs, simMs - leakStart) == 60);
+
+    Serial.println();
+    mem.printTo(Serial, simMs);
+    for (uint8_t m = 0; m < 60; m++) {
+        delete[] leaked[m];
+    }
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(500);
+    mem.attach();
+
+    dmr.enableChecksum(false);
+    dmr.enableDebug(false);
+    dmr.setSMSReceivedCallback(onSMS);
+    dmr.setSMSSendStatusCallback(onSMSStatus);
+    sim.config.latencyUs = 0;
+    sim.config.smsLatencyUs = 0;
+
+    Serial.println("DMR828S allocation soak");
+    Serial.println("=======================");
+    runScopes();
+    if (DMRMemTracker::hooksBuiltIn()) {
+        runSoak();
+    } else {
+        Serial.println("  Allocation hooks not built in: rebuild with -DDMR_MEM_HOOKS=1");
+    }
+    Serial.printf("\n%u passed, %u failed\n", passed, failed);
+}
+
+void loop() {
+    delay(1000);
+}
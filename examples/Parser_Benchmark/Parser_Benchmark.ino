@@ -0,0 +1,150 @@
+#include <Arduino.h>
+#include "DMR828S_utils.h"
+
+// Receive parser benchmark: feeds a synthetic frame corpus straight into the
+// ring (no UART involved) and reports frames/sec plus loss under injected noise.
+// Only DMR828S_Utils is used, so the sketch also builds against a host Arduino shim.
+
+DMR828S_Utils parser(Serial2);   // Serial2 is never started; bytes come from feed()
+
+#define BENCH_FRAMES     5000
+#define BLOCK_FRAMES     100     // corpus is generated block by block to bound RAM use
+#define MAX_FRAME_BYTES  (DMR_FRAME_OVERHEAD + DMR_MAX_PAYLOAD)
+
+static uint8_t stream[BLOCK_FRAMES * 72];
+static uint32_t streamLen = 0;
+static bool corrupted[BENCH_FRAMES];
+static bool received[BENCH_FRAMES];
+
+// Simple xorshift so runs are reproducible on every target
+static uint32_t rngState = 0x12345678;
+uint32_t nextRandom() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+// Build one frame carrying a 16-bit sequence number in its payload.
+// Mix of shapes seen on the link: short responses, call events, SMS uploads.
+uint16_t buildFrame(uint8_t *out, uint16_t seq) {
+    static const uint8_t cmds[] = {0x05, 0x04, 0x06, 0x07, 0x07, 0x01};
+    uint8_t cmd = cmds[seq % sizeof(cmds)];
+    uint16_t payloadLen = (cmd == 0x07) ? 6 + (seq % 24) * 2 : 4;
+    uint16_t pos = 0;
+
+    out[pos++] = DMR_FRAME_HEAD;
+    out[pos++] = cmd;
+    out[pos++] = (cmd == 0x06 || cmd == 0x07) ? 0x02 : 0x00;
+    out[pos++] = (cmd == 0x07) ? 0x70 : 0x00;
+    uint16_t chk = parser.calcChecksum(out, 4);
+    out[pos++] = chk >> 8;
+    out[pos++] = chk & 0xFF;
+    out[pos++] = payloadLen >> 8;
+    out[pos++] = payloadLen & 0xFF;
+    out[pos++] = seq >> 8;
+    out[pos++] = seq & 0xFF;
+    for (uint16_t i = 2; i < payloadLen; i++)
+        out[pos++] = (i & 1) ? 0x00 : 'A' + (i % 26);
+    out[pos++] = DMR_FRAME_TAIL;
+
+    return pos;
+}
+
+// noisePercent: chance per frame of one corrupted byte and of a garbage burst before it
+void buildBlock(uint16_t firstSeq, uint8_t noisePercent) {
+    uint8_t frame[MAX_FRAME_BYTES];
+    streamLen = 0;
+
+    for (uint16_t seq = firstSeq; seq < firstSeq + BLOCK_FRAMES; seq++) {
+        uint16_t len = buildFrame(frame, seq);
+        corrupted[seq] = false;
+        received[seq] = false;
+
+        if (nextRandom() % 100 < noisePercent) {
+            uint8_t burst = 1 + nextRandom() % 6;
+            for (uint8_t i = 0; i < burst; i++)
+                stream[streamLen++] = (nextRandom() & 1) ? DMR_FRAME_HEAD : nextRandom();
+        }
+        if (nextRandom() % 100 < noisePercent) {
+            frame[nextRandom() % len] ^= 1 + nextRandom() % 255;
+            corrupted[seq] = true;
+        }
+
+        memcpy(&stream[streamLen], frame, len);
+        streamLen += len;
+    }
+}
+
+void runPass(const char *name, uint8_t noisePercent) {
+    parser.resetParser();
+    parser.resetParserStats();
+
+    uint32_t delivered = 0;
+    uint32_t totalBytes = 0;
+    unsigned long elapsed = 0;
+    DMRFrameView view;
+
+    for (uint16_t block = 0; block < BENCH_FRAMES; block += BLOCK_FRAMES) {
+        buildBlock(block, noisePercent);
+        totalBytes += streamLen;
+
+        uint32_t fed = 0;
+        unsigned long start = micros();
+        while (fed < streamLen) {
+            // Feed in UART-FIFO-sized chunks, like bytes arriving from Serial2
+            uint32_t chunk = 1 + nextRandom() % 64;
+            if (chunk > streamLen - fed) chunk = streamLen - fed;
+            fed += parser.feed(&stream[fed], chunk);
+
+            while (parser.parseFrame(view)) {
+                if (view.valid && view.length >= 2) {
+                    uint16_t seq = (view.data[0] << 8) | view.data[1];
+                    if (seq < BENCH_FRAMES) received[seq] = true;
+                }
+                delivered++;
+            }
+        }
+        elapsed += micros() - start;
+    }
+
+    uint32_t lost = 0, collateral = 0, hit = 0;
+    for (uint16_t seq = 0; seq < BENCH_FRAMES; seq++) {
+        if (corrupted[seq]) hit++;
+        if (!received[seq]) {
+            lost++;
+            if (!corrupted[seq]) collateral++;
+        }
+    }
+
+    const DMRParserStats &st = parser.getParserStats();
+    Serial.printf("%-8s noise=%2u%%  %6lu frames/s  %5.2f us/frame  bytes=%lu\n",
+                  name, noisePercent,
+                  elapsed ? (unsigned long)((uint64_t)delivered * 1000000ULL / elapsed) : 0UL,
+                  delivered ? (float)elapsed / delivered : 0.0f,
+                  (unsigned long)totalBytes);
+    Serial.printf("         corrupted=%lu lost=%lu (%.2f%%) collateral=%lu  drop=%lu resync=%lu crc=%lu\n",
+                  (unsigned long)hit, (unsigned long)lost, 100.0f * lost / BENCH_FRAMES,
+                  (unsigned long)collateral, (unsigned long)st.droppedBytes,
+                  (unsigned long)st.resyncs, (unsigned long)st.checksumErrors);
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(500);
+
+    parser.debug = false;
+    parser.checksumEnabled = true;
+
+    Serial.println("DMR828S receive parser benchmark");
+    Serial.println("================================");
+    runPass("clean", 0);
+    runPass("noisy", 1);
+    runPass("noisy", 5);
+    runPass("hostile", 20);
+    Serial.println("'collateral' = intact frames lost because a neighbour was corrupted");
+}
+
+void loop() {
+    delay(1000);
+}
@@ -0,0 +1,330 @@
+#include <Arduino.h>
+#include "DMR828S.h"
+
+// Protocol microbenchmarks: throughput, per-call latency percentiles and stack
+// use of the encode/decode paths (calcChecksum, sendFrame, readFrame and the
+// update() dispatch into processIncomingFrame/processSMSEvent).
+// Uses frames recorded from the module (protocol document and field captures)
+// plus a synthetic corpus. No UART is involved: transmit goes to a counting
+// sink and receive replays the corpus, so the sketch runs on the ESP32 and
+// against a host Arduino shim.
+
+#define BENCH_SAMPLES       2000
+#define BENCH_STACK_BYTES   8192    // Task stack on ESP32 / probe window on host
+
+/********************************************************
+ * TIMING
+ ********************************************************/
+#if defined(ESP32)
+static inline uint32_t benchTicks() { return ESP.getCycleCount(); }
+static inline uint32_t ticksToNs(uint32_t t) { return (uint64_t)t * 1000 / getCpuFrequencyMhz(); }
+#elif !defined(ARDUINO)
+#include <chrono>
+static inline uint32_t benchTicks() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+static inline uint32_t ticksToNs(uint32_t t) { return t; }
+#else
+static inline uint32_t benchTicks() { return micros(); }
+static inline uint32_t ticksToNs(uint32_t t) { return t * 1000; }
+#endif
+
+/********************************************************
+ * STREAMS
+ ********************************************************/
+
+// Swallows transmitted frames
+class SinkStream : public Stream {
+public:
+    uint32_t bytes = 0;
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    size_t write(uint8_t) override { bytes++; return 1; }
+    size_t write(const uint8_t *, size_t n) override { bytes += n; return n; }
+    using Print::write;
+};
+
+// Replays a corpus forever, as if the module never stopped talking
+class ReplayStream : public Stream {
+public:
+    void load(const uint8_t *buf, uint32_t len) { data = buf; size = len; pos = 0; }
+    int available() override { return size ? 256 : 0; }
+    int read() override {
+        if (!size) return -1;
+        uint8_t b = data[pos];
+        if (++pos == size) pos = 0;
+        return b;
+    }
+    int peek() override { return size ? data[pos] : -1; }
+    size_t write(uint8_t) override { return 1; }
+    using Print::write;
+private:
+    const uint8_t *data = nullptr;
+    uint32_t size = 0;
+    uint32_t pos = 0;
+};
+
+SinkStream sink;
+ReplayStream replay;
+DMR828S_Utils txUtils(sink);
+DMR828S_Utils rxUtils(replay);
+DMR828S dmr(sink);
+
+/********************************************************
+ * CORPORA
+ ********************************************************/
+
+// Module output as recorded (DM828_PROTOCOL.md examples and bench captures)
+static const uint8_t recorded[] = {
+    0x68, 0x01, 0x00, 0x00, 0x87, 0xFE, 0x00, 0x00, 0x10,                          // channel done
+    0x68, 0x04, 0x00, 0x00, 0x94, 0xEA, 0x00, 0x01, 0x03, 0x10,                    // status standby
+    0x68, 0x05, 0x00, 0x00, 0x94, 0xE9, 0x00, 0x01, 0x03, 0x10,                    // RSSI 3
+    0x68, 0x06, 0x02, 0x61, 0x83, 0x93, 0x00, 0x04, 0x02, 0x00, 0x00, 0x01, 0x10,  // call out starts
+    0x68, 0x06, 0x02, 0x62, 0x85, 0x97, 0x00, 0x00, 0x10,                          // call out ends
+    0x68, 0x07, 0x00, 0x71, 0x87, 0x87, 0x00, 0x00, 0x10,                          // SMS sent
+    0x68, 0x07, 0x02, 0x70, 0x92, 0xA9, 0x00, 0x09,                                // SMS "ABC" from 2
+    0x00, 0x00, 0x02, 0x41, 0x00, 0x42, 0x00, 0x43, 0x00, 0x10,
+    0x68, 0x07, 0x02, 0x70, 0x00, 0x00, 0x00, 0x09,                                // SMS "123" (field)
+    0x00, 0x00, 0x02, 0x31, 0x00, 0x32, 0x00, 0x33, 0x00, 0x10,
+    0x68, 0x09, 0x02, 0x91, 0x94, 0x52, 0x00, 0x03, 0x00, 0x00, 0x01, 0x10,        // alarm from 1
+    0x68, 0x10, 0x00, 0x01, 0x85, 0xE9, 0x00, 0x04, 0x02, 0x00, 0x00, 0x01, 0x10,  // call-in contact
+};
+#define RECORDED_FRAMES 10
+
+#define SYNTH_FRAMES 64
+static uint8_t synthetic[SYNTH_FRAMES * (DMR_FRAME_OVERHEAD + 150)];
+static uint32_t syntheticLen = 0;
+
+// Frames handed straight to handleFrame()
+static uint8_t smsShort[3 + 6];
+static uint8_t smsLong[3 + 144];
+static uint8_t callStart[4] = {0x02, 0x00, 0x00, 0x07};
+static uint8_t alarmData[3] = {0x00, 0x00, 0x09};
+
+static uint32_t rngState = 0x9E3779B9;
+static uint32_t nextRandom() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+void buildCorpora() {
+    // Synthetic: the traffic mix of an exercise - mostly SMS of random length
+    // with query responses and call events in between
+    for (uint16_t n = 0; n < SYNTH_FRAMES; n++) {
+        uint8_t *f = &synthetic[syntheticLen];
+        uint8_t kind = nextRandom() % 4;
+        uint16_t len = kind == 0 ? 3 + 2 * (1 + nextRandom() % 72) : (kind == 1 ? 4 : 1);
+        f[0] = DMR_FRAME_HEAD;
+        f[1] = kind == 0 ? 0x07 : (kind == 1 ? 0x06 : 0x05);
+        f[2] = kind <= 1 ? 0x02 : 0x00;
+        f[3] = kind == 0 ? 0x70 : (kind == 1 ? 0x60 : 0x00);
+        f[4] = 0x00;
+        f[5] = 0x00;
+        f[6] = len >> 8;
+        f[7] = len & 0xFF;
+        for (uint16_t i = 0; i < len; i++)
+            f[DMR_FRAME_HEADER_LEN + i] = (kind == 0 && i >= 3 && (i & 1)) ? 0x00 : 'a' + nextRandom() % 26;
+        f[DMR_FRAME_HEADER_LEN + len] = DMR_FRAME_TAIL;
+        syntheticLen += DMR_FRAME_OVERHEAD + len;
+    }
+
+    smsShort[0] = 0x00; smsShort[1] = 0x00; smsShort[2] = 0x02;
+    for (uint8_t i = 0; i < 3; i++) { smsShort[3 + 2 * i] = 'A' + i; smsShort[4 + 2 * i] = 0x00; }
+    smsLong[0] = 0x00; smsLong[1] = 0x00; smsLong[2] = 0x02;
+    for (uint8_t i = 0; i < 72; i++) { smsLong[3 + 2 * i] = 'a' + i % 26; smsLong[4 + 2 * i] = 0x00; }
+}
+
+/********************************************************
+ * BENCHMARKS
+ ********************************************************/
+typedef void (*BenchFn)();
+
+static volatile uint32_t sinkValue;
+static uint8_t payload148[148];
+static DMRFrameView viewSMSShort, viewSMSLong, viewCall, viewAlarm;
+
+static void benchNothing() {}
+static void benchChecksumHeader() { sinkValue = txUtils.calcChecksum(recorded, 4); }
+static void benchChecksumFrame() { sinkValue = txUtils.calcChecksum(&recorded[60], 18); }  // SMS "ABC"
+static void benchChecksumLong() { sinkValue = txUtils.calcChecksum(payload148, sizeof(payload148)); }
+static void benchSendRuntime() { uint8_t d = 0x01; txUtils.sendFrame(0x05, 0x01, 0x01, &d, 1, false); }
+static void benchSendTemplate() { uint8_t d = 0x01; txUtils.sendFrame<DMR_CMD_RSSI>(&d, 1, false); }
+static void benchSendSMS() { txUtils.sendFrame<DMR_CMD_SMS>(payload148, sizeof(payload148), false); }
+static void benchReadFrame() { DMRFrameView v; sinkValue = rxUtils.readFrame(v); }
+static void benchDispatchCall() { dmr.handleFrame(viewCall); }
+static void benchDispatchAlarm() { dmr.handleFrame(viewAlarm); }
+static void benchSMSShort() { dmr.handleFrame(viewSMSShort); }
+static void benchSMSLong() { dmr.handleFrame(viewSMSLong); }
+static char textUtf8[DMR_SMS_MAX_TEXT + 1];
+static uint8_t textUtf16[144];
+static void benchToUtf16() { sinkValue = dmrUtf8ToUtf16le("Contact at grid 4471, moving north", 34, textUtf16, sizeof(textUtf16)); }
+static void benchToUtf8() { sinkValue = dmrUtf16leToUtf8(&smsLong[3], 144, textUtf8, sizeof(textUtf8)); }
+
+static uint32_t samples[BENCH_SAMPLES];
+
+struct BenchJob {
+    const char *name;
+    BenchFn fn;
+    uint32_t totalNs;
+    uint32_t stackBytes;
+};
+
+static int compareU32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static void runSamples(BenchJob &job) {
+    // Warm caches and the parser ring before timing
+    for (uint16_t i = 0; i < 64; i++) job.fn();
+
+    job.totalNs = 0;
+    for (uint16_t i = 0; i < BENCH_SAMPLES; i++) {
+        uint32_t t0 = benchTicks();
+        job.fn();
+        samples[i] = ticksToNs(benchTicks() - t0);
+        job.totalNs += samples[i];
+    }
+}
+
+#if defined(ESP32)
+// Each benchmark runs in a fresh task so its stack high-water mark is its own
+static SemaphoreHandle_t benchDone;
+
+static void benchTask(void *arg) {
+    BenchJob *job = (BenchJob *)arg;
+    runSamples(*job);
+    job->stackBytes = BENCH_STACK_BYTES - uxTaskGetStackHighWaterMark(NULL);
+    xSemaphoreGive(benchDone);
+    vTaskDelete(NULL);
+}
+
+static void measure(BenchJob &job) {
+    if (!benchDone) benchDone = xSemaphoreCreateBinary();
+    xTaskCreatePinnedToCore(benchTask, "bench", BENCH_STACK_BYTES, &job, 1, NULL, 1);
+    xSemaphoreTake(benchDone, portMAX_DELAY);
+}
+#else
+// Host: paint a window below the caller's frame, run, then read the same
+// bytes back and count what got overwritten. The window is the dead frame
+// of paintStack(), which the benchmark's own frames reuse; its address is
+// kept as an integer so the read-back is not seen as a dangling access.
+// Approximate (compiler-dependent) but consistent between benchmarks.
+static uintptr_t paintedWindow = 0;
+
+__attribute__((noinline)) static void paintStack() {
+    volatile uint8_t window[BENCH_STACK_BYTES];
+    for (uint32_t i = 0; i < BENCH_STACK_BYTES; i++) window[i] = 0xA5;
+    paintedWindow = (uintptr_t)window;
+}
+
+// Stacks grow down: the deepest bytes, at the low end, are the last to be reached
+static uint32_t probeStack() {
+    const volatile uint8_t *window = (const volatile uint8_t *)paintedWindow;
+    uint32_t untouched = 0;
+    while (untouched < BENCH_STACK_BYTES && window[untouched] == 0xA5) untouched++;
+    return BENCH_STACK_BYTES - untouched;
+}
+
+static void measure(BenchJob &job) {
+    paintStack();
+    runSamples(job);
+    job.stackBytes = probeStack();
+}
+#endif
+
+static uint32_t baselineStack = 0;
+
+void bench(const char *name, BenchFn fn) {
+    BenchJob job = { name, fn, 0, 0 };
+    measure(job);
+    qsort(samples, BENCH_SAMPLES, sizeof(samples[0]), compareU32);
+
+    uint32_t stack = job.stackBytes > baselineStack ? job.stackBytes - baselineStack : 0;
+    float meanNs = (float)job.totalNs / BENCH_SAMPLES;
+    Serial.printf("%-26s %10.0f/s %8lu %8lu %8lu %8lu %7lu\n", name,
+                  meanNs > 0 ? 1e9f / meanNs : 0.0f,
+                  (unsigned long)samples[BENCH_SAMPLES / 2],
+                  (unsigned long)samples[BENCH_SAMPLES * 90 / 100],
+                  (unsigned long)samples[BENCH_SAMPLES * 99 / 100],
+                  (unsigned long)samples[BENCH_SAMPLES - 1],
+                  (unsigned long)stack);
+}
+
+static void noSMS(const DMRSMSMessage &) {}
+static void noCall(const DMRCallInfo &) {}
+static void noAlarm(uint32_t) {}
+
+static DMRFrameView makeView(uint8_t cmd, uint8_t sr, const uint8_t *data, uint16_t len) {
+    DMRFrameView v;
+    v.cmd = cmd;
+    v.rw = 0x02;
+    v.sr = sr;
+    v.length = len;
+    v.data = data;
+    v.valid = true;
+    return v;
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(500);
+
+    buildCorpora();
+    for (uint16_t i = 0; i < sizeof(payload148); i++) payload148[i] = i;
+
+    txUtils.debug = false;
+    rxUtils.debug = false;
+    rxUtils.checksumEnabled = false;
+    dmr.enableDebug(false);
+    dmr.enableChecksum(false);
+    dmr.setSMSReceivedCallback(noSMS);
+    dmr.setCallReceivedCallback(noCall);
+    dmr.setEmergencyCallback(noAlarm);
+    dmrTraceSetLevel(DMR_TRACE_LVL_OFF);   // measure the protocol, not the trace ring
+
+    viewSMSShort = makeView(DMR_CMD_SMS, 0x70, smsShort, sizeof(smsShort));
+    viewSMSLong = makeView(DMR_CMD_SMS, 0x70, smsLong, sizeof(smsLong));
+    viewCall = makeView(DMR_CMD_CALL, 0x60, callStart, sizeof(callStart));
+    viewAlarm = makeView(DMR_CMD_EMERGENCY, 0x91, alarmData, sizeof(alarmData));
+
+    Serial.println("DMR828S protocol microbenchmarks");
+    Serial.printf("%u samples per path, latency in ns, stack in bytes above harness\n\n", BENCH_SAMPLES);
+
+    BenchJob base = { "baseline", benchNothing, 0, 0 };
+    measure(base);
+    baselineStack = base.stackBytes;
+
+    Serial.printf("%-26s %12s %8s %8s %8s %8s %7s\n", "path", "throughput", "p50", "p90", "p99", "max", "stack");
+    bench("calcChecksum 4B", benchChecksumHeader);
+    bench("calcChecksum 18B", benchChecksumFrame);
+    bench("calcChecksum 148B", benchChecksumLong);
+    bench("sendFrame runtime 1B", benchSendRuntime);
+    bench("sendFrame<CMD> 1B", benchSendTemplate);
+    bench("sendFrame<SMS> 148B", benchSendSMS);
+
+    replay.load(recorded, sizeof(recorded));
+    rxUtils.resetParser();
+    bench("readFrame recorded", benchReadFrame);
+    replay.load(synthetic, syntheticLen);
+    rxUtils.resetParser();
+    bench("readFrame synthetic", benchReadFrame);
+
+    bench("dispatch call 0x60", benchDispatchCall);
+    bench("dispatch alarm 0x91", benchDispatchAlarm);
+    bench("processSMSEvent 3 chars", benchSMSShort);
+    bench("processSMSEvent 72 chars", benchSMSLong);
+    bench("UTF-8 -> UTF-16LE 34 chars", benchToUtf16);
+    bench("UTF-16LE -> UTF-8 72 chars", benchToUtf8);
+
+    Serial.printf("\nrecorded corpus: %u frames / %u bytes, synthetic: %u frames / %lu bytes\n",
+                  RECORDED_FRAMES, (unsigned)sizeof(recorded), SYNTH_FRAMES, (unsigned long)syntheticLen);
+}
+
+void loop() {
+    delay(1000);
+}
@@ -0,0 +1,265 @@
+#include <Arduino.h>
+#include "DMR828S_queue.h"
+
+// Checks and throughput for the lock-free queues in DMR828S_queue.h.
+// Single-threaded checks first (order, full/empty, wrap-around), then
+// producers and a consumer running at the same time: tasks on both cores on
+// the ESP32, std::thread against a host Arduino shim. Every item must arrive
+// exactly once and in order per producer. On the ESP32 a FreeRTOS queue of
+// the same item is timed alongside for comparison.
+
+#define BENCH_ITEMS         200000  // Per producer
+#define MPSC_PRODUCERS      3
+#define BENCH_CAPACITY      64
+
+struct BenchItem {
+    uint16_t producer;
+    uint32_t seq;
+};
+
+static uint8_t passed = 0, failed = 0;
+
+void check(const char *name, bool ok) {
+    Serial.printf("  %s %s\n", ok ? "PASS" : "FAIL", name);
+    if (ok) passed++; else failed++;
+}
+
+/********************************************************
+ * THREADS
+ ********************************************************/
+#if defined(ESP32)
+struct Worker {
+    void (*fn)(void *);
+    void *arg;
+    volatile bool done;
+};
+
+static void workerEntry(void *p) {
+    Worker *w = (Worker *)p;
+    w->fn(w->arg);
+    w->done = true;
+    vTaskDelete(NULL);
+}
+
+// Producers on core 0; the consumer runs in the calling task on core 1
+static void runWorkers(Worker *workers, uint8_t count, void (*consumer)(void *), void *arg) {
+    for (uint8_t i = 0; i < count; i++) {
+        workers[i].done = false;
+        xTaskCreatePinnedToCore(workerEntry, "qbench", 4096, &workers[i], 1, NULL, 0);
+    }
+    consumer(arg);
+    for (uint8_t i = 0; i < count; i++) {
+        while (!workers[i].done) delay(1);
+    }
+}
+
+static inline void benchYield() { taskYIELD(); }
+#else
+#include <thread>
+
+struct Worker {
+    void (*fn)(void *);
+    void *arg;
+    bool done;
+};
+
+static void runWorkers(Worker *workers, uint8_t count, void (*consumer)(void *), void *arg) {
+    std::thread threads[MPSC_PRODUCERS];
+    for (uint8_t i = 0; i < count; i++) {
+        threads[i] = std::thread(workers[i].fn, workers[i].arg);
+    }
+    consumer(arg);
+    for (uint8_t i = 0; i < count; i++) {
+        threads[i].join();
+    }
+}
+
+static inline void benchYield() { std::this_thread::yield(); }
+#endif
+
+/********************************************************
+ * SINGLE-THREADED
+ ********************************************************/
+template <typename Q>
+static bool checkFillDrain(Q &q) {
+    BenchItem item;
+    if (q.pop(item) || !q.empty()) return false;
+    for (uint32_t i = 0; i < Q::capacity(); i++) {
+        if (!q.push(BenchItem{0, i})) return false;
+    }
+    if (q.push(BenchItem{0, 999}) || q.size() != Q::capacity()) return false;
+    for (uint32_t i = 0; i < Q::capacity(); i++) {
+        if (!q.pop(item) || item.seq != i) return false;
+    }
+    return !q.pop(item) && q.empty();
+}
+
+// Offset push/pop so head and tail both cross the end of the ring many times
+template <typename Q>
+static bool checkWrap(Q &q) {
+    BenchItem item;
+    uint32_t next = 0, expect = 0;
+    for (uint16_t round = 0; round < 10 * Q::capacity(); round++) {
+        if (!q.push(BenchItem{0, next++})) return false;
+        if (round % 3 == 0 && !q.push(BenchItem{0, next++})) return false;
+        if (!q.pop(item) || item.seq != expect++) return false;
+        if (q.size() >= Q::capacity() - 1) {
+            while (q.pop(item)) {
+                if (item.seq != expect++) return false;
+            }
+        }
+    }
+    while (q.pop(item)) {
+        if (item.seq != expect++) return false;
+    }
+    return expect == next;
+}
+
+static void runSingleThreaded() {
+    static DMRSPSCQueue<BenchItem, 8> spsc;
+    static DMRMPSCQueue<BenchItem, 8> mpsc;
+    check("SPSC fill, refuse when full, drain in order", checkFillDrain(spsc));
+    check("SPSC order across wrap-around", checkWrap(spsc));
+    check("MPSC fill, refuse when full, drain in order", checkFillDrain(mpsc));
+    check("MPSC order across wrap-around", checkWrap(mpsc));
+
+    BenchItem item;
+    spsc.push(BenchItem{0, 7});
+    const BenchItem *front = spsc.peek();
+    check("SPSC peek leaves the item", front && front->seq == 7 && spsc.size() == 1 &&
+          spsc.pop(item) && item.seq == 7 && spsc.peek() == nullptr);
+}
+
+/********************************************************
+ * CONCURRENT
+ ********************************************************/
+struct ProducerArg {
+    void *queue;
+    uint16_t id;
+};
+
+struct ConsumeResult {
+    uint32_t received;
+    uint32_t outOfOrder;
+    uint32_t elapsedUs;
+};
+
+static DMRSPSCQueue<BenchItem, BENCH_CAPACITY> spscShared;
+static DMRMPSCQueue<BenchItem, BENCH_CAPACITY> mpscShared;
+static ConsumeResult result;
+
+template <typename Q>
+static void produce(void *p) {
+    ProducerArg *arg = (ProducerArg *)p;
+    Q *q = (Q *)arg->queue;
+    for (uint32_t i = 0; i < BENCH_ITEMS; i++) {
+        BenchItem item = { arg->id, i };
+        while (!q->push(item)) benchYield();
+    }
+}
+
+template <typename Q, uint8_t PRODUCERS>
+static void consume(void *p) {
+    Q *q = (Q *)p;
+    uint32_t next[PRODUCERS] = {0};
+    uint32_t total = (uint32_t)PRODUCERS * BENCH_ITEMS;
+    uint32_t start = micros();
+    result = ConsumeResult();
+    while (result.received < total) {
+        BenchItem item;
+        if (!q->pop(item)) {
+            benchYield();
+            continue;
+        }
+        if (item.producer >= PRODUCERS || item.seq != next[item.producer]) {
+            result.outOfOrder++;
+        }
+        if (item.producer < PRODUCERS) {
+            next[item.producer] = item.seq + 1;
+        }
+        result.received++;
+    }
+    result.elapsedUs = micros() - start;
+}
+
+static void printThroughput(const char *name, uint32_t items, uint32_t us) {
+    Serial.printf("  %-28s %8lu items in %7lu us  %6lu k items/s\n", name, (unsigned long)items,
+                  (unsigned long)us, us ? (unsigned long)((uint64_t)items * 1000 / us) : 0);
+}
+
+static void runConcurrent() {
+    ProducerArg spscArg = { &spscShared, 0 };
+    Worker spscWorker = { produce<DMRSPSCQueue<BenchItem, BENCH_CAPACITY> >, &spscArg, false };
+    runWorkers(&spscWorker, 1, consume<DMRSPSCQueue<BenchItem, BENCH_CAPACITY>, 1>, &spscShared);
+    ConsumeResult spsc = result;
+    check("SPSC 1 producer: every item once, in order",
+          spsc.received == BENCH_ITEMS && spsc.outOfOrder == 0 && spscShared.empty());
+
+    ProducerArg mpscArgs[MPSC_PRODUCERS];
+    Worker mpscWorkers[MPSC_PRODUCERS];
+    for (uint8_t i = 0; i < MPSC_PRODUCERS; i++) {
+        mpscArgs[i] = ProducerArg{ &mpscShared, i };
+        mpscWorkers[i] = Worker{ produce<DMRMPSCQueue<BenchItem, BENCH_CAPACITY> >, &mpscArgs[i], false };
+    }
+    runWorkers(mpscWorkers, MPSC_PRODUCERS,
+               consume<DMRMPSCQueue<BenchItem, BENCH_CAPACITY>, MPSC_PRODUCERS>, &mpscShared);
+    ConsumeResult mpsc = result;
+    check("MPSC 3 producers: every item once, in order per producer",
+          mpsc.received == (uint32_t)MPSC_PRODUCERS * BENCH_ITEMS && mpsc.outOfOrder == 0 && mpscShared.empty());
+
+    Serial.println();
+    printThroughput("DMRSPSCQueue 1P/1C", spsc.received, spsc.elapsedUs);
+    printThroughput("DMRMPSCQueue 3P/1C", mpsc.received, mpsc.elapsedUs);
+}
+
+/********************************************************
+ * FREERTOS BASELINE
+ ********************************************************/
+#if defined(ESP32)
+static QueueHandle_t rtosQueue;
+
+static void rtosProduce(void *p) {
+    for (uint32_t i = 0; i < BENCH_ITEMS; i++) {
+        BenchItem item = { 0, i };
+        xQueueSend(rtosQueue, &item, portMAX_DELAY);
+    }
+}
+
+static void rtosConsume(void *p) {
+    uint32_t start = micros();
+    result = ConsumeResult();
+    BenchItem item;
+    while (result.received < BENCH_ITEMS) {
+        xQueueReceive(rtosQueue, &item, portMAX_DELAY);
+        if (item.seq != result.received) result.outOfOrder++;
+        result.received++;
+    }
+    result.elapsedUs = micros() - start;
+}
+
+static void runBaseline() {
+    rtosQueue = xQueueCreate(BENCH_CAPACITY, sizeof(BenchItem));
+    Worker worker = { rtosProduce, NULL, false };
+    runWorkers(&worker, 1, rtosConsume, NULL);
+    printThroughput("FreeRTOS queue 1P/1C", result.received, result.elapsedUs);
+    vQueueDelete(rtosQueue);
+}
+#endif
+
+void setup() {
+    Serial.begin(115200);
+    delay(500);
+
+    Serial.println("DMR828S lock-free queues");
+    Serial.println("========================");
+    runSingleThreaded();
+    runConcurrent();
+#if defined(ESP32)
+    runBaseline();
+#endif
+    Serial.printf("\n%u passed, %u failed\n", passed, failed);
+}
+
+void loop() {
+    delay(1000);
+}
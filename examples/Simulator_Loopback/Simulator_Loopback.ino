@@ -0,0 +1,407 @@
+#include <Arduino.h>
+#include "DMR828S.h"
+#include "DMR828S_sim.h"
+#include "DMR828S_link.h"
+#include "DMR828S_scan.h"
+#include "DMR828S_hop.h"
+#include "DMR828S_perf.h"
+
+// Drives the full DMR828S stack against DMR828S_Simulator instead of a radio:
+// settings, queries, SMS TX/RX, call and emergency events, then a lossy link.
+// Nothing touches a UART, so the sketch also builds against a host Arduino shim.
+// The update() calls are profiled per stage, as in the firmware's 'perf' command.
+
+DMR828S_Simulator sim;
+DMR828S dmr(sim);
+
+static uint32_t smsFrom = 0;
+static char smsText[80];
+static uint8_t smsParts = 0;
+static uint8_t smsStatusCount = 0;
+static SMSSendStatus smsStatus = SMS_SEND_TIMEOUT;
+static bool smsStatusSeen = false;
+static DMRSMSHandle doneHandles[3];
+static uint8_t doneCount = 0;
+static uint32_t callFrom = 0;
+static bool callEnded = false;
+static uint32_t alarmFrom = 0;
+static uint8_t frames06 = 0;
+static uint32_t callOutTo = 0;
+static uint8_t callOutEvents = 0;
+static DMRModuleStatus lastStatus = STATUS_STANDBY;
+static bool scanDone = false;
+static uint8_t passed = 0, failed = 0;
+
+enum LoopbackStage : uint8_t { STAGE_UPDATE, STAGE_SAMPLER, STAGE_SCANNER, STAGE_HOPPING, STAGE_COUNT };
+static const char *const stageNames[STAGE_COUNT] = { "dmr.update", "link sampler", "scanner", "hopping" };
+DMRPerfProfiler perf(stageNames, STAGE_COUNT);
+
+static uint8_t overBudgetStage = 0xFF;
+static void onOverBudget(uint8_t stage, uint32_t ticks, void *context) { overBudgetStage = stage; }
+
+static void updateDMR() {
+    DMR_PERF_SCOPE(perf, STAGE_UPDATE);
+    dmr.update();
+}
+
+void onSMS(const DMRSMSMessage &sms) {
+    smsFrom = sms.sourceID;
+    snprintf(smsText, sizeof(smsText), "%s", sms.message);
+    smsParts = sms.parts;
+}
+void onSMSStatus(uint32_t targetID, SMSSendStatus status) {
+    smsStatus = status;
+    smsStatusSeen = true;
+    smsStatusCount++;
+}
+void onQueuedSMS(DMRSMSHandle handle, uint32_t targetID, SMSSendStatus status, void *context) {
+    if (status == SMS_SEND_SUCCESS && doneCount < 3) doneHandles[doneCount++] = handle;
+}
+void onCall(const DMRCallInfo &call) { callFrom = call.contactID; }
+void onCallEnd() { callEnded = true; }
+void onAlarm(uint32_t sourceID) { alarmFrom = sourceID; }
+
+void onCallFrame(const DMRFrameView &frame, void *context) { (*(uint8_t *)context)++; }
+void onCallOutEvent(const DMREvent &event, void *context) {
+    if (event.type == DMR_EVENT_CALL_OUT_START) callOutTo = event.targetID;
+    callOutEvents++;
+}
+void onStatusEvent(const DMREvent &event, void *context) { lastStatus = event.status; }
+static uint16_t nestedRSSI = 0xFFFF;
+void onNestedQuery(const DMREvent &event, void *context) { nestedRSSI = dmr.getRSSI(); }
+void onScanDone(const DMRChannelScanner &scanner, void *context) { scanDone = true; }
+
+void check(const char *name, bool ok) {
+    Serial.printf("  %s %s\n", ok ? "PASS" : "FAIL", name);
+    if (ok) passed++; else failed++;
+}
+
+// Run update() until cond() holds or timeout_ms passes
+bool pumpUntil(bool (*cond)(), uint32_t timeout_ms) {
+    unsigned long start = millis();
+    while (!cond() && millis() - start < timeout_ms) {
+        updateDMR();
+        delay(1);
+    }
+    return cond();
+}
+
+void runFunctional() {
+    Serial.println("Functional (clean link)");
+
+    dmr.beginConfig();
+    dmr.setChannel(3);
+    dmr.setVolume(7);
+    dmr.setTXPower(1);
+    DMRConfigResult result;
+    check("config transaction acked", dmr.commitConfig(result) && result.acked == 3);
+    check("channel/volume applied", sim.channel == 3 && sim.volume == 7);
+    check("out-of-range channel rejected", !dmr.setChannel(17));
+
+    // Acked writes fill the shadow registers; cached reads send nothing
+    uint32_t commands = sim.getStats().commands;
+    check("shadow from acked writes", dmr.getChannel() == 3 && dmr.getVolume() == 7 &&
+          dmr.getTXPower() == 1 && sim.getStats().commands == commands);
+    sim.channel = 5;
+    check("shadow refresh", dmr.getChannel() == 3 && dmr.getChannel(true) == 5 &&
+          dmr.getColorCode() == 1 && sim.getStats().commands == commands + 1);
+    dmr.resetToDefaults();
+    check("shadow reset", dmr.getCacheAge(SHADOW_VOLUME) == DMR_SHADOW_NEVER &&
+          dmr.getCacheAge(SHADOW_CHANNEL) == DMR_SHADOW_NEVER);
+    pumpUntil([]() { return false; }, 20);
+
+    // Changes the module uploads itself drop what they touch; a restart drops everything
+    dmr.setVolume(6);
+    check("shadow filled again", dmr.getChannel(true) == 1 && dmr.getCacheAge(SHADOW_COLOR_CODE) != DMR_SHADOW_NEVER);
+    sim.injectChannelChange(9);
+    pumpUntil([]() { return false; }, 20);
+    check("shadow dropped on unsolicited channel change",
+          dmr.getCacheAge(SHADOW_CHANNEL) == DMR_SHADOW_NEVER &&
+          dmr.getCacheAge(SHADOW_COLOR_CODE) == DMR_SHADOW_NEVER &&
+          dmr.getVolume() == 6 && dmr.getChannel() == 9);
+    sim.injectRestart();
+    pumpUntil([]() { return false; }, 20);
+    check("shadow dropped on module restart",
+          dmr.getCacheAge(SHADOW_VOLUME) == DMR_SHADOW_NEVER &&
+          dmr.getCacheAge(SHADOW_CHANNEL) == DMR_SHADOW_NEVER && dmr.getChannel() == 1);
+
+    sim.rssi = 0x42;
+    check("RSSI query", dmr.getRSSI() == 0x42);
+    sim.radioID = 0x00ABCD;
+    check("radio ID query", dmr.getRadioID() == 0x00ABCD);
+
+    dmr.sendSMS(0x0000C8, "123", false);
+    check("SMS TX payload", sim.getLastSentSMS().targetID == 0x0000C8 && sim.getLastSentSMS().length == 6);
+    check("SMS TX result 0x71", pumpUntil([]() { return smsStatusSeen; }, 2000) && smsStatus == SMS_SEND_SUCCESS);
+
+    sim.config.smsFailPercent = 100;
+    smsStatusSeen = false;
+    dmr.sendSMS(0x0000C8, "fail", false);
+    check("SMS TX result 0x7E", pumpUntil([]() { return smsStatusSeen; }, 2000) && smsStatus == SMS_SEND_FAILED);
+    sim.config.smsFailPercent = 0;
+
+    // Three queued messages against a module that is busy half the time:
+    // each resolves once, in order, to its own handle
+    sim.config.smsBusyPercent = 50;
+    DMRSMSHandle h[3];
+    h[0] = dmr.queueSMS(0x0000C8, "one", false, onQueuedSMS);
+    h[1] = dmr.queueSMS(0x0000C9, "two", false, onQueuedSMS);
+    h[2] = dmr.queueSMS(0x0000CA, "three", false, onQueuedSMS);
+    check("SMS queue accepts 3", h[0] && h[1] && h[2] && dmr.getSMSQueueLength() == 3);
+    check("SMS queue drains in order", pumpUntil([]() { return doneCount == 3; }, 5000) &&
+          doneHandles[0] == h[0] && doneHandles[1] == h[1] && doneHandles[2] == h[2]);
+    Serial.printf("    busy refusals=%lu retries=%lu\n", (unsigned long)sim.getStats().smsBusy,
+                  (unsigned long)dmr.getSMSQueueStats().retries);
+    sim.config.smsBusyPercent = 0;
+
+    sim.injectSMS(0x000002, "ABC");
+    check("SMS RX upload", pumpUntil([]() { return smsText[0] != 0; }, 500) && strcmp(smsText, "ABC") == 0);
+
+    // 160 chars -> three parts, one status for the whole message
+    char longText[161];
+    for (uint8_t i = 0; i < 160; i++) longText[i] = 'a' + i % 26;
+    longText[160] = '\0';
+    uint32_t partsBefore = sim.getStats().smsSent;
+    smsStatusSeen = false;
+    smsStatusCount = 0;
+    dmr.sendSMS(0x0000C8, longText, false);
+    check("multi-part SMS TX", pumpUntil([]() { return smsStatusSeen; }, 2000) && smsStatus == SMS_SEND_SUCCESS &&
+          smsStatusCount == 1 && sim.getStats().smsSent - partsBefore == 3);
+
+    // UTF-8 goes out as UTF-16LE and comes back unchanged, surrogate pairs included
+    const char *utf8 = "Gr\xC3\xBC\xC3\x9F \xE2\x9C\x93 \xF0\x9F\x93\xA1";     // "Grüß ✓ 📡"
+    smsStatusSeen = false;
+    dmr.sendSMS(0x0000C8, utf8, false);
+    pumpUntil([]() { return smsStatusSeen; }, 2000);
+    check("SMS TX UTF-16LE", sim.getLastSentSMS().length == 2 * 9 && sim.getLastSentSMS().data[4] == 0xFC &&
+          sim.getLastSentSMS().data[14] == 0x3D && sim.getLastSentSMS().data[15] == 0xD8);
+    smsText[0] = 0;
+    sim.injectSMS(0x000102, utf8);
+    check("SMS RX UTF-8 + 3-byte source", pumpUntil([]() { return smsText[0] != 0; }, 500) &&
+          strcmp(smsText, utf8) == 0 && smsFrom == 0x000102);
+
+    // Parts arriving out of order are joined before the callback
+    smsText[0] = 0;
+    sim.injectSMS(0x000002, "~K22|world");
+    sim.injectSMS(0x000002, "~K12|hello ");
+    check("multi-part SMS RX", pumpUntil([]() { return smsText[0] != 0; }, 500) &&
+          strcmp(smsText, "hello world") == 0 && smsParts == 2);
+
+    // Text that merely resembles a header is delivered as written
+    const char *const plainTexts[] = { "~ABC hello", "~K11|one part", "~K32|part 3 of 2", "~K12|", "~k12|lower" };
+    bool allPlain = true;
+    for (uint8_t i = 0; i < sizeof(plainTexts) / sizeof(plainTexts[0]); i++) {
+        smsText[0] = 0;
+        sim.injectSMS(0x000003, plainTexts[i]);
+        allPlain &= pumpUntil([]() { return smsText[0] != 0; }, 500) &&
+                    strcmp(smsText, plainTexts[i]) == 0 && smsParts == 1;
+    }
+    check("header look-alikes delivered as-is", allPlain);
+
+    // ...and one that would pass as a header is sent as two parts
+    partsBefore = sim.getStats().smsSent;
+    smsStatusSeen = false;
+    dmr.sendSMS(0x0000C8, "~K12|hi", false);
+    const DMRSimSMS &last = sim.getLastSentSMS();
+    check("header look-alike sent as two parts", pumpUntil([]() { return smsStatusSeen; }, 2000) &&
+          sim.getStats().smsSent - partsBefore == 2 && last.length == 2 * 7 &&
+          last.data[4] == '2' && last.data[6] == '2' && last.data[10] == 'h');
+
+    sim.injectCallStart(0x02, 0x000007);
+    check("call start 0x60", pumpUntil([]() { return callFrom != 0; }, 500) && callFrom == 0x000007);
+    sim.injectCallEnd();
+    check("call end 0x6F", pumpUntil([]() { return callEnded; }, 500));
+
+    sim.injectEmergency(0x000009);
+    check("emergency upload", pumpUntil([]() { return alarmFrom != 0; }, 500) && alarmFrom == 0x000009);
+
+    // Several consumers of the same call frames
+    DMRSubscription subs[5];
+    subs[0] = dmr.subscribeFrame(DMR_CMD_CALL, onCallFrame, &frames06);
+    subs[1] = dmr.subscribeEvent(DMR_EVENT_CALL_OUT_START, onCallOutEvent);
+    subs[2] = dmr.subscribeEvent(DMR_EVENT_CALL_OUT_END, onCallOutEvent);
+    subs[3] = dmr.subscribeEvent(DMR_EVENT_CALL_OUT_FAILED, onCallOutEvent);
+    subs[4] = dmr.subscribeEvent(DMR_EVENT_STATUS, onStatusEvent);
+    sim.injectCallOut(0x01, 0x000011);
+    check("call-out 0x61 event + status", pumpUntil([]() { return callOutEvents == 1; }, 500) &&
+          callOutTo == 0x000011 && lastStatus == STATUS_TRANSMITTING);
+    sim.injectCallOutEnd();
+    sim.injectCallOutEnd(true);
+    check("call-out 0x62/0x6D + frame listener", pumpUntil([]() { return callOutEvents == 3; }, 500) &&
+          frames06 == 3 && lastStatus == STATUS_STANDBY);
+    for (uint8_t i = 0; i < 5; i++) dmr.unsubscribe(subs[i]);
+    sim.injectCallOut(0x01, 0x000012);
+    pumpUntil([]() { return false; }, 50);
+    check("unsubscribe", callOutEvents == 3 && frames06 == 3 && !dmr.unsubscribe(subs[0]));
+
+    // A blocking getter inside update() cannot wait: it returns its default and is traced
+    DMRSubscription nested = dmr.subscribeEvent(DMR_EVENT_EMERGENCY, onNestedQuery);
+    dmrTraceClear();
+    sim.injectEmergency(0x00000A);
+    pumpUntil([]() { return nestedRSSI != 0xFFFF; }, 500);
+    dmr.unsubscribe(nested);
+    bool rejected = false;
+    DMRTraceEvent traced;
+    while (dmrTracePop(traced)) {
+        rejected |= traced.id == TRACE_QUERY_REJECTED && traced.args[0] == DMR_CMD_RSSI &&
+                    traced.args[1] == QUERY_IN_UPDATE;
+    }
+    check("getter in a listener rejected and traced", nestedRSSI == 0 && rejected);
+
+    // Background RSSI sampler: rising signal, no blocking queries
+    DMRLinkSampler sampler(dmr);
+    sampler.begin(DMR_LINK_MIN_INTERVAL_MS);
+    for (uint8_t i = 0; i < 10; i++) {
+        sim.rssi = 10 + 10 * i;
+        uint16_t before = sampler.getCount();
+        unsigned long start = millis();
+        while (sampler.getCount() == before && millis() - start < 1000) {
+            updateDMR();
+            DMR_PERF_SCOPE(perf, STAGE_SAMPLER);
+            sampler.update();
+        }
+    }
+    sampler.stop();
+    DMRLinkStats ls;
+    check("link sampler stats", sampler.getStats(ls) && ls.samples == 10 && ls.min == 10 &&
+          ls.max == 100 && ls.p50 == 50 && ls.p90 == 90 && ls.trendPerMin > 0 && ls.missed == 0);
+
+    // Occupancy scan of channels 2-5: traffic on 4, RSSI rising with the channel
+    DMRChannelScanner scanner(dmr);
+    dmr.setChannel(7);
+    pumpUntil([]() { return sim.channel == 7; }, 500);
+    scanDone = false;
+    bool started = scanner.start(0x001E, 60, onScanDone, nullptr, 7);
+    unsigned long scanStart = millis();
+    while (started && !scanDone && millis() - scanStart < 5000) {
+        sim.status = sim.channel == 4 ? 0x01 : 0x03;
+        sim.rssi = sim.channel * 10;
+        updateDMR();
+        DMR_PERF_SCOPE(perf, STAGE_SCANNER);
+        scanner.update();
+    }
+    sim.status = 0x03;
+    const DMRChannelScanResult &busy = scanner.getResult(2);
+    check("channel scan", scanDone && scanner.getResultCount() == 4 && busy.channel == 4 &&
+          busy.samples > 0 && busy.occupancy() == 100 && scanner.getResult(0).occupancy() == 0 &&
+          scanner.getResult(1).rssiMean() == 30 && scanner.getBestChannel() == 2 &&
+          scanner.wasRestored() && sim.channel == 7);
+
+    // GPS-timed hopping: 250 ms slots over 4 frequencies, home pair restored on stop
+    DMRHopScheduler hop(dmr), peer(dmr);
+    dmr.setFrequency(430000000UL, 430000000UL);
+    pumpUntil([]() { return sim.txFreq == 430000000UL; }, 500);
+    hop.setFrequencies(440000000UL, 25000UL, 4);
+    peer.setFrequencies(440000000UL, 25000UL, 4);
+    bool permuted = true;
+    for (uint64_t round = 0; round < 8; round++) {
+        uint32_t seen = 0;
+        for (uint8_t i = 0; i < 4; i++) {
+            seen |= 1UL << ((hop.frequencyForSlot(round * 4 + i) - 440000000UL) / 25000UL);
+        }
+        permuted = permuted && seen == 0x0F;
+    }
+    hop.start(0xC0FFEE, DMR_HOP_MIN_SLOT_MS);
+    peer.start(0xC0FFEE, DMR_HOP_MIN_SLOT_MS);
+    bool agree = true;
+    for (uint64_t slot = 1000; slot < 1100; slot++) {
+        agree = agree && hop.frequencyForSlot(slot) == peer.frequencyForSlot(slot);
+    }
+    peer.stop();
+    bool waited = true;
+    hop.update();
+    waited = hop.getStats().retunes == 0;       // No time yet: hold
+    hop.setTime(1767225600000ULL, millis());    // 2026-01-01T00:00:00Z
+    unsigned long hopStart = millis();
+    while (millis() - hopStart < 1300) {
+        updateDMR();
+        DMR_PERF_SCOPE(perf, STAGE_HOPPING);
+        hop.update();
+    }
+    const DMRHopStats &hs = hop.getStats();
+    bool onSchedule = sim.txFreq == hop.getFrequency() && sim.rxFreq == hop.getFrequency();
+    bool nextDue = hop.msUntilUpdate() <= DMR_HOP_MIN_SLOT_MS;
+    check("frequency hopping", permuted && agree && waited && onSchedule && nextDue && hs.retunes >= 4 &&
+          hs.acked >= hs.retunes - 1 && hs.refused == 0 && hs.minUs > 0 && hs.maxUs < 100000);
+    hop.stop();
+    check("hop stop restores home", pumpUntil([]() { return sim.txFreq == 430000000UL; }, 500));
+}
+
+void runLossy(uint8_t dropPercent, uint8_t corruptPercent) {
+    sim.reset();
+    dmr.getLowLevel().resetParser();
+    sim.config.dropPercent = dropPercent;
+    sim.config.corruptPercent = corruptPercent;
+
+    const uint16_t queries = 100;
+    uint16_t answered = 0;
+    unsigned long start = millis();
+    for (uint16_t i = 0; i < queries; i++) {
+        sim.rssi = i & 0x7F;
+        if (dmr.getRSSI() == (i & 0x7F)) answered++;
+    }
+
+    const DMRSimStats &st = sim.getStats();
+    Serial.printf("Lossy drop=%u%% corrupt=%u%%: %u/%u RSSI queries answered in %lu ms "
+                  "(sim dropped=%lu corrupted=%lu)\n",
+                  dropPercent, corruptPercent, answered, queries, millis() - start,
+                  (unsigned long)st.dropped, (unsigned long)st.corrupted);
+
+    sim.config.dropPercent = 0;
+    sim.config.corruptPercent = 0;
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(500);
+
+    // The simulator checks the protocol's full-frame checksum; the library's
+    // header-only checksum does not match it, so run with checksums off like the app
+    dmr.enableChecksum(false);
+    dmr.enableDebug(false);
+    dmr.setSMSReceivedCallback(onSMS);
+    dmr.setSMSSendStatusCallback(onSMSStatus);
+    dmr.setCallReceivedCallback(onCall);
+    dmr.setCallEndedCallback(onCallEnd);
+    dmr.setEmergencyCallback(onAlarm);
+    dmr.setSMSRetry(4, 20);
+
+    sim.config.latencyUs = 2000;
+    sim.config.smsLatencyUs = 50000;
+
+    Serial.println("DMR828S simulator loopback");
+    Serial.println("==========================");
+    runFunctional();
+
+    bool histogramsAddUp = true;
+    for (uint8_t i = 0; i < STAGE_COUNT; i++) {
+        const DMRPerfStage *stage = perf.getStage(i);
+        uint32_t inBuckets = 0;
+        for (uint8_t b = 0; b < DMR_PERF_BUCKETS; b++) inBuckets += stage->buckets[b];
+        histogramsAddUp = histogramsAddUp && stage->count > 0 && inBuckets == stage->count &&
+                          stage->percentileTicks(50) <= stage->percentileTicks(99) &&
+                          stage->percentileTicks(99) <= stage->maxTicks;
+    }
+    check("stage profiler", histogramsAddUp);
+
+    // Stall watchdog: a stage blocking past the budget is counted and reported as it ends
+    DMRPerfProfiler watchdog(stageNames, STAGE_COUNT);
+    watchdog.setBudget(2000, onOverBudget);
+    { DMR_PERF_SCOPE(watchdog, STAGE_UPDATE); dmr.update(); }
+    bool quiet = overBudgetStage == 0xFF;
+    { DMR_PERF_SCOPE(watchdog, STAGE_SCANNER); delay(5); }
+    check("stage over budget reported", quiet && overBudgetStage == STAGE_SCANNER &&
+          watchdog.getStage(STAGE_SCANNER)->overBudget == 1 && watchdog.getStage(STAGE_UPDATE)->overBudget == 0);
+    Serial.printf("%u passed, %u failed\n\n", passed, failed);
+    perf.printTo(Serial);
+    Serial.println();
+
+    sim.config.latencyUs = 500;
+    runLossy(0, 0);
+    runLossy(5, 0);
+    runLossy(0, 5);
+}
+
+void loop() {
+    delay(1000);
+}
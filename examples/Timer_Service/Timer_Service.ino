@@ -0,0 +1,165 @@
+#include <Arduino.h>
+#include "DMR828S_timer.h"
+
+// Checks and jitter for DMRTimerService (DMR828S_timer.h): deadline order,
+// one-shot and periodic firing, cancellation, skipped periods. Then a run
+// that sleeps until the next deadline instead of polling every 10 ms, with
+// the wakeups it took and how late each timer fired. Runs on the ESP32 or
+// against a host Arduino shim.
+
+#define JITTER_RUN_MS       2000
+
+static uint8_t passed = 0, failed = 0;
+
+void check(const char *name, bool ok) {
+    Serial.printf("  %s %s\n", ok ? "PASS" : "FAIL", name);
+    if (ok) passed++; else failed++;
+}
+
+// Runs the service for `ms`, sleeping until each deadline
+static void runFor(DMRTimerService &timers, uint32_t ms) {
+    uint32_t start = millis();
+    while (millis() - start < ms) {
+        uint32_t wait = timers.run();
+        uint32_t left = ms - (millis() - start);
+        delay(wait < left ? wait : left);
+    }
+    timers.run();
+}
+
+/********************************************************
+ * CHECKS
+ ********************************************************/
+static char order[8];
+static uint8_t orderLength = 0;
+static uint16_t counter = 0;
+
+static void record(void *context) {
+    if (orderLength < sizeof(order) - 1) {
+        order[orderLength++] = (char)(intptr_t)context;
+    }
+}
+
+static void count(void *context) {
+    counter++;
+}
+
+struct SelfCancel {
+    DMRTimerService *timers;
+    DMRTimerId id;
+    uint8_t fired;
+};
+
+static void cancelSelfAfterThree(void *context) {
+    SelfCancel *self = (SelfCancel *)context;
+    if (++self->fired == 3) {
+        self->timers->cancel(self->id);
+    }
+}
+
+static void runChecks() {
+    static DMRTimerService timers;
+
+    orderLength = 0;
+    timers.startOnce(30, record, (void *)(intptr_t)'c');
+    timers.startOnce(10, record, (void *)(intptr_t)'a');
+    timers.startOnce(20, record, (void *)(intptr_t)'b');
+    check("next deadline is the earliest", timers.msUntilNext() <= 10 && timers.msUntilNext() >= 9);
+    runFor(timers, 50);
+    order[orderLength] = 0;
+    check("one-shots fire once, earliest first", strcmp(order, "abc") == 0 && timers.getCount() == 0);
+    check("nothing armed: no deadline", timers.msUntilNext() == DMR_TIMER_NEVER);
+
+    orderLength = 0;
+    DMRTimerId first = timers.startOnce(10, record, (void *)(intptr_t)'x');
+    DMRTimerId second = timers.startOnce(20, record, (void *)(intptr_t)'y');
+    bool cancelled = timers.cancel(first);
+    DMRTimerId reused = timers.startOnce(40, record, (void *)(intptr_t)'z');
+    runFor(timers, 60);
+    order[orderLength] = 0;
+    check("cancelled timer never fires", cancelled && strcmp(order, "yz") == 0);
+    check("stale ids are refused", !timers.cancel(first) && !timers.isActive(second) &&
+          reused != first && reused != DMR_INVALID_TIMER);
+
+    counter = 0;
+    DMRTimerId periodic = timers.startPeriodic(10, count);
+    runFor(timers, 105);
+    timers.cancel(periodic);
+    check("periodic timer keeps its period", counter >= 9 && counter <= 11);
+
+    counter = 0;
+    periodic = timers.startPeriodic(10, count);
+    delay(55);
+    timers.run();
+    DMRTimerId id;
+    const char *name;
+    uint32_t periodMs;
+    DMRTimerStats stats;
+    timers.getTimer(0, id, name, periodMs, stats);
+    timers.cancel(periodic);
+    check("late run fires once and counts skipped periods", counter == 1 && stats.missed >= 4 &&
+          stats.maxLateUs >= 40000);
+
+    SelfCancel self = { &timers, DMR_INVALID_TIMER, 0 };
+    self.id = timers.startPeriodic(5, cancelSelfAfterThree, &self);
+    runFor(timers, 40);
+    check("callback can cancel its own timer", self.fired == 3 && timers.getCount() == 0);
+
+    uint8_t started = 0;
+    for (uint8_t i = 0; i <= DMR_TIMER_MAX; i++) {
+        if (timers.startOnce(1000 + i, count) != DMR_INVALID_TIMER) started++;
+    }
+    check("refuses past DMR_TIMER_MAX", started == DMR_TIMER_MAX);
+    while (timers.getCount() > 0) {
+        timers.getTimer(0, id, name, periodMs, stats);
+        timers.cancel(id);
+    }
+}
+
+/********************************************************
+ * JITTER
+ ********************************************************/
+static void noop(void *context) {
+}
+
+static void runJitter() {
+    static DMRTimerService timers;
+    timers.startPeriodic(20, noop, nullptr, "gps");
+    timers.startPeriodic(50, noop, nullptr, "keypad");
+    timers.startPeriodic(100, noop, nullptr, "comms");
+    timers.startPeriodic(500, noop, nullptr, "display");
+    timers.startPeriodic(1000, noop, nullptr, "config");
+    timers.clearStats();
+    runFor(timers, JITTER_RUN_MS);
+
+    Serial.printf("\n  %lu ms: %lu wakeups (a 10 ms poll loop: %lu)\n", (unsigned long)JITTER_RUN_MS,
+                  (unsigned long)timers.getRuns(), (unsigned long)(JITTER_RUN_MS / 10));
+    Serial.println("  Timer     Period  Fired  Missed  Late mean/max (us)");
+    for (uint8_t i = 0; i < timers.getCount(); i++) {
+        DMRTimerId id;
+        const char *name;
+        uint32_t periodMs;
+        DMRTimerStats stats;
+        timers.getTimer(i, id, name, periodMs, stats);
+        Serial.printf("  %-8s %7lu %6lu %7lu  %8lu/%lu\n", name, (unsigned long)periodMs,
+                      (unsigned long)stats.fired, (unsigned long)stats.missed,
+                      (unsigned long)stats.meanLateUs(), (unsigned long)stats.maxLateUs);
+    }
+    check("sleeping until the next deadline wakes less than a 10 ms poll",
+          timers.getRuns() < JITTER_RUN_MS / 10);
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(500);
+
+    Serial.println("DMR828S timer service");
+    Serial.println("=====================");
+    runChecks();
+    runJitter();
+    Serial.printf("\n%u passed, %u failed\n", passed, failed);
+}
+
+void loop() {
+    delay(1000);
+}
@@ -9,4 +9,6 @@ void showCommandsTo(Stream* stream);
 void showStatus();
 void showStatusTo(Stream* stream);
 void showDeviceInfo();
-void showDeviceInfoTo(Stream* stream);
\ No newline at end of file
+void showDeviceInfoTo(Stream* stream);
+void showLinkStatsTo(Stream* stream, uint32_t windowMs = 0);
+void showScanResultsTo(Stream* stream);
\ No newline at end of file
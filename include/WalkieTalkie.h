@@ -2,6 +2,9 @@
 
 #include <Arduino.h>
 #include "DMR828S.h"
+#include "DMR828S_link.h"
+#include "DMR828S_scan.h"
+#include "DMR828S_hop.h"
 #include "BluetoothSerial.h"
 
 // Forward declarations from DMR828S library
@@ -13,6 +16,11 @@ using CallType = DMRCallType;
 #define I2C_SDA 21
 #define I2C_SCL 22
 
+// Boot: DMR module status polled until it answers, whole boot bounded
+#define DMR_PROBE_INTERVAL_MS 100
+#define DMR_BOOT_TIMEOUT_MS 5000
+#define BOOT_DEADLINE_MS 10000
+
 // Walkie-talkie state structure
 struct WalkieTalkieState {
     uint32_t myRadioID = 0x000001;
@@ -30,6 +38,9 @@ enum DemoMode {
 
 // Global instances and state
 extern DMR828S dmr;
+extern DMRLinkSampler linkSampler;
+extern DMRChannelScanner channelScanner;
+extern DMRHopScheduler hopScheduler;
 extern BluetoothSerial SerialBT;
 extern WalkieTalkieState wtState;
 extern DemoMode currentMode;
@@ -49,13 +60,22 @@ void onSMSReceived(const DMRSMSMessage& message);
 void onCallReceived(const DMRCallInfo& callInfo);
 void onCallEnded();
 void onEmergency(uint32_t sourceID);
+void onPositionSMS(const DMREvent& event, void* context);
+void onCallOutEvent(const DMREvent& event, void* context);
 
 // GPS JSON formatting functions
-String formatGPSToJSON(double lat, double lon, String soldierId, String commMode);
+String formatGPSToJSON(double lat, double lon, String soldierId, String commMode, String timestamp = "");
 void parseIncomingGPS(String message, String commMode);
-void processGPSData(double lat, double lon, String soldierId, String commMode);
+void processGPSData(double lat, double lon, String soldierId, String commMode, String timestamp = "");
 void onSMSStatus(uint32_t targetID, SMSSendStatus status);
 
+// Link quality
+bool getRecentLinkSample(DMRLinkSample &sample);
+const char* moduleStatusName(uint8_t status);
+
+// Frequency hopping
+void updateFrequencyHopping();
+
 // Command processing
 void processCommand(Stream* stream, String command);
 void showCommands();
@@ -1,6 +1,13 @@
 #include "DMR828S.h"
 
 DMR828S::DMR828S(HardwareSerial &port) : utils(port) {
+    memset(frameHead, NO_LISTENER, sizeof(frameHead));
+    memset(eventHead, NO_LISTENER, sizeof(eventHead));
+}
+
+DMR828S::DMR828S(Stream &port) : utils(port) {
+    memset(frameHead, NO_LISTENER, sizeof(frameHead));
+    memset(eventHead, NO_LISTENER, sizeof(eventHead));
 }
 
 void DMR828S::begin(uint32_t baud) {
@@ -22,33 +29,36 @@ void DMR828S::enableChecksum(bool enable) {
 bool DMR828S::setChannel(uint8_t channel) {
     if (channel < 1 || channel > 16) return false;
     uint8_t data = channel;
-    return sendCommand(DMR_CMD_SET_CHANNEL, 0x01, 0x01, &data, 1);
+    return sendSetting<DMR_CMD_SET_CHANNEL>(&data, 1);
 }
 
 bool DMR828S::setVolume(uint8_t volume) {
     if (volume < 1 || volume > 9) return false;
     uint8_t data = volume;
-    return sendCommand(DMR_CMD_SET_VOLUME, 0x01, 0x01, &data, 1);
+    return sendSetting<DMR_CMD_SET_VOLUME>(&data, 1);
+}
+
+uint8_t DMR828S::getChannel(bool refresh) {
+    return channelShadow(SHADOW_CHANNEL, refresh);
+}
+
+uint8_t DMR828S::getVolume() {
+    uint32_t volume;
+    return getCached(SHADOW_VOLUME, volume) ? volume : 0;
 }
 
 DMRModuleStatus DMR828S::getModuleStatus() {
-    uint8_t data = 0x01;
-    if (sendCommand(DMR_CMD_CHECK_STATUS, 0x01, 0x01, &data, 1)) {
-        DMRFrame frame;
-        if (waitForResponse(frame) && frame.length >= 1) {
-            return (DMRModuleStatus)frame.data[0];
-        }
+    DMRFrame frame;
+    if (query(DMR_CMD_CHECK_STATUS, frame) && frame.length >= 1) {
+        return (DMRModuleStatus)frame.data[0];
     }
     return STATUS_STANDBY;
 }
 
 uint8_t DMR828S::getRSSI() {
-    uint8_t data = 0x01;
-    if (sendCommand(DMR_CMD_RSSI, 0x01, 0x01, &data, 1)) {
-        DMRFrame frame;
-        if (waitForResponse(frame) && frame.length >= 1) {
-            return frame.data[0];
-        }
+    DMRFrame frame;
+    if (query(DMR_CMD_RSSI, frame) && frame.length >= 1) {
+        return frame.data[0];
     }
     return 0;
 }
@@ -61,24 +71,21 @@ bool DMR828S::startCall(DMRCallType type, uint32_t contactID) {
     uint8_t data[4];
     data[0] = (uint8_t)type;
     uint32ToBytes3(contactID, &data[1]);
-    return sendCommand(DMR_CMD_CALL, 0x01, 0x01, data, 4);
+    return sendCommand<DMR_CMD_CALL>(data, 4);
 }
 
 bool DMR828S::stopCall() {
     uint8_t data[4] = {0x00, 0x00, 0x00, 0x00};
-    return sendCommand(DMR_CMD_CALL, 0x01, 0xFF, data, 4);
+    return sendCommand<DMR_CMD_CALL, 0xFF>(data, 4);
 }
 
 bool DMR828S::getCallInContact(DMRCallInfo &callInfo) {
-    uint8_t data = 0x01;
-    if (sendCommand(DMR_CMD_QUERY_CALL_CONTACT, 0x01, 0x01, &data, 1)) {
-        DMRFrame frame;
-        if (waitForResponse(frame) && frame.length >= 4) {
-            callInfo.type = (DMRCallType)frame.data[0];
-            callInfo.contactID = bytes3ToUint32(&frame.data[1]);
-            callInfo.active = true;
-            return true;
-        }
+    DMRFrame frame;
+    if (query(DMR_CMD_QUERY_CALL_CONTACT, frame) && frame.length >= 4) {
+        callInfo.type = (DMRCallType)frame.data[0];
+        callInfo.contactID = bytes3ToUint32(&frame.data[1]);
+        callInfo.active = true;
+        return true;
     }
     callInfo.active = false;
     return false;
@@ -88,66 +95,263 @@ bool DMR828S::getCallInContact(DMRCallInfo &callInfo) {
  * 🟣 3. SMS MESSAGING
  ********************************************************/
 
+// Base36 digit used in the segment header
+static char smsHeaderDigit(uint8_t value) {
+    return value < 10 ? '0' + value : 'A' + (value - 10);
+}
+
+static int smsHeaderValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'Z') return c - 'A' + 10;
+    return -1;
+}
+
+// A header exactly as sendSMSPart() writes it, with 2-16 parts (the part
+// bitmask) and 1 <= part <= total
+static bool parseSMSHeader(const char *header, int &msgId, int &part, int &total) {
+    if (header[0] != DMR_SMS_SEGMENT_MARK || header[DMR_SMS_SEGMENT_HEADER - 1] != DMR_SMS_SEGMENT_SEP) {
+        return false;
+    }
+    msgId = smsHeaderValue(header[1]);
+    part = smsHeaderValue(header[2]);
+    total = smsHeaderValue(header[3]);
+    return msgId >= 0 && total >= 2 && total <= 16 && part >= 1 && part <= total;
+}
+
 bool DMR828S::sendSMS(uint32_t targetID, const char* message, bool isGroup) {
-    uint8_t msgLen = strlen(message);
-    if (msgLen > 72) msgLen = 72; // Max length for UTF-16 (144 bytes / 2)
+    return queueSMS(targetID, message, isGroup) != DMR_SMS_INVALID_HANDLE;
+}
+
+bool DMR828S::sendSMSPart(SMSOutbound &msg) {
+    msg.attempts++;
+    smsQueueStats.partsSent++;
     
-    // DMR828S expects UTF-16 format based on received frame analysis
-    uint8_t data[150];
-    uint8_t dataIndex = 0;
+    uint8_t text[DMR_SMS_MAX_CHARS * 2];
+    size_t length = 0;
     
-    // Add header bytes (based on sent frame pattern)
-    data[dataIndex++] = isGroup ? 0x02 : 0x01; // SMS type: 0x01=Private, 0x02=Group
-    uint32ToBytes3(targetID, &data[dataIndex]); // 3 bytes for target ID
-    dataIndex += 3;
+    // Segment header as UTF-16LE ASCII; short texts go out untouched
+    if (msg.segmented) {
+        const char header[DMR_SMS_SEGMENT_HEADER] = {
+            DMR_SMS_SEGMENT_MARK, smsHeaderDigit(msg.msgId), smsHeaderDigit(msg.sent + 1), smsHeaderDigit(msg.total),
+            DMR_SMS_SEGMENT_SEP
+        };
+        length = dmrUtf8ToUtf16le(header, DMR_SMS_SEGMENT_HEADER, text, sizeof(text));
+        DMR_TRACE_INFO(TRACE_SMS_PART, msg.targetID, msg.msgId, msg.sent + 1, msg.total);
+    }
     
-    // Convert message to UTF-16 format (char + 0x00)
-    for (int i = 0; i < msgLen; i++) {
-        data[dataIndex++] = message[i];
-        data[dataIndex++] = 0x00; // UTF-16 null byte
+    size_t used;
+    size_t remaining = msg.length - msg.offset;
+    if (msg.sent == 0 && msg.firstPartBytes) {
+        remaining = msg.firstPartBytes;
     }
+    length += dmrUtf8ToUtf16le(&msg.text[msg.offset], remaining, &text[length],
+                               sizeof(text) - length, &used);
+    msg.partBytes = used;
     
-    if (utils.debug) {
-        Serial.println("[DEBUG] Sending SMS in UTF-16 format:");
-        Serial.print("  Target ID: 0x"); Serial.println(targetID, HEX);
-        Serial.print("  Type: "); Serial.println(isGroup ? "Group" : "Private");
-        Serial.print("  Message: '"); Serial.print(message); Serial.println("'");
-        Serial.print("  Data bytes: ");
-        for (int i = 0; i < dataIndex; i++) {
-            if (data[i] < 0x10) Serial.print("0");
-            Serial.print(data[i], HEX);
-            Serial.print(" ");
-        }
-        Serial.println();
+    return sendSMSFrame(msg.targetID, text, length, msg.isGroup);
+}
+
+bool DMR828S::sendSMSFrame(uint32_t targetID, const uint8_t *text, uint16_t length, bool isGroup) {
+    // Msg_type, Call_ID, then the text as UTF-16LE (DM828_PROTOCOL.md 2.6.1)
+    uint8_t data[4 + DMR_SMS_MAX_CHARS * 2];
+    if (length > DMR_SMS_MAX_CHARS * 2) {
+        return false;
     }
     
+    data[0] = isGroup ? 0x02 : 0x01; // SMS type: 0x01=Private, 0x02=Group
+    uint32ToBytes3(targetID, &data[1]); // 3 bytes for target ID
+    memcpy(&data[4], text, length);
+    
+    DMR_TRACE_INFO(TRACE_SMS_TX, targetID, isGroup ? 2 : 1, length / 2);
+    
     // Track SMS for status callback - no timeout, wait for actual response
     lastSMSTargetID = targetID;
     lastSMSSendTime = millis();
+    smsAwaitingResult = true;
     
-    if (utils.debug) {
-        Serial.println("[DEBUG] SMS tracking started - listening for response...");
-        Serial.println("[DEBUG] Will wait indefinitely until response received");
+    return sendCommand<DMR_CMD_SMS>(data, 4 + length);
+}
+
+/********************************************************
+ * SMS QUEUE
+ ********************************************************/
+DMRSMSHandle DMR828S::queueSMS(uint32_t targetID, const char *message, bool isGroup,
+                               SMSMessageCallback callback, void *context) {
+    // The limit is in UTF-16 units, as the parts carry them. Past
+    // DMR_SMS_MAX_TEXT bytes it is over the limit whatever the characters.
+    size_t msgLen = strlen(message);
+    size_t used = 0;
+    if (msgLen <= DMR_SMS_MAX_TEXT) {
+        dmrUtf8ToUtf16le(message, msgLen, nullptr, DMR_SMS_MAX_UNITS * 2, &used);
+    }
+    if (used < msgLen || smsQueueCount >= DMR_SMS_QUEUE_DEPTH) {
+        smsQueueStats.rejected++;
+        return DMR_SMS_INVALID_HANDLE;
     }
     
-    return sendCommand(DMR_CMD_SMS, 0x01, 0x01, data, dataIndex);
+    // Plain when the whole text fits one frame. A text that would read as a
+    // segment header goes as two parts, the look-alike header alone in the
+    // first, so the receiver does not misread it.
+    dmrUtf8ToUtf16le(message, msgLen, nullptr, DMR_SMS_MAX_CHARS * 2, &used);
+    int headerId, headerPart, headerTotal;
+    bool lookAlike = used == msgLen && msgLen > DMR_SMS_SEGMENT_HEADER &&
+                     parseSMSHeader(message, headerId, headerPart, headerTotal);
+    bool segmented = used < msgLen || lookAlike;
+    
+    // Split on character boundaries, DMR_SMS_PART_CHARS UTF-16 units per part
+    uint8_t total = 1;
+    if (lookAlike) {
+        total = 2;
+    } else if (segmented) {
+        size_t offset = 0;
+        for (total = 0; offset < msgLen && total < DMR_SMS_MAX_PARTS; total++) {
+            dmrUtf8ToUtf16le(&message[offset], msgLen - offset, nullptr, DMR_SMS_PART_CHARS * 2, &used);
+            offset += used;
+        }
+        if (offset < msgLen) {
+            smsQueueStats.rejected++;
+            return DMR_SMS_INVALID_HANDLE;
+        }
+    }
+    
+    SMSOutbound &msg = smsQueue[(smsQueueHead + smsQueueCount) % DMR_SMS_QUEUE_DEPTH];
+    msg.handle = smsNextHandle++;
+    if (smsNextHandle == DMR_SMS_INVALID_HANDLE) smsNextHandle = 1;
+    msg.targetID = targetID;
+    msg.isGroup = isGroup;
+    msg.segmented = segmented;
+    msg.total = total;
+    msg.msgId = 0;
+    if (segmented) {
+        msg.msgId = smsTxSeq;
+        smsTxSeq = (smsTxSeq + 1) % 36;
+    }
+    msg.offset = 0;
+    msg.partBytes = 0;
+    msg.firstPartBytes = lookAlike ? DMR_SMS_SEGMENT_HEADER : 0;
+    msg.sent = 0;
+    msg.attempts = 0;
+    msg.retryAt = millis();
+    msg.callback = callback;
+    msg.context = context;
+    msg.length = msgLen;
+    memcpy(msg.text, message, msgLen);
+    smsQueueCount++;
+    smsQueueStats.queued++;
+    
+    pumpSMS();
+    return msg.handle;
 }
 
-bool DMR828S::getLastSMS(DMRSMSMessage &sms) {
-    uint8_t data = 0x01;
-    if (sendCommand(DMR_CMD_QUERY_SMS, 0x01, 0x01, &data, 1)) {
-        DMRFrame frame;
-        if (waitForResponse(frame) && frame.length >= 5) {
-            sms.sourceID = bytes3ToUint32(&frame.data[0]);
-            sms.type = frame.data[3];
-            sms.length = frame.data[4];
-            if (sms.length > 144) sms.length = 144;
-            memcpy(sms.message, &frame.data[5], sms.length);
-            sms.message[sms.length] = '\0';
-            sms.valid = true;
+bool DMR828S::cancelSMS(DMRSMSHandle handle) {
+    for (uint8_t i = 0; i < smsQueueCount; i++) {
+        uint8_t slot = (smsQueueHead + i) % DMR_SMS_QUEUE_DEPTH;
+        if (smsQueue[slot].handle != handle) {
+            continue;
+        }
+        // The head may already have parts on air
+        if (i == 0 && (isSMSSending() || smsQueue[slot].sent > 0)) {
+            return false;
+        }
+        for (uint8_t j = i; j + 1 < smsQueueCount; j++) {
+            smsQueue[(smsQueueHead + j) % DMR_SMS_QUEUE_DEPTH] = smsQueue[(smsQueueHead + j + 1) % DMR_SMS_QUEUE_DEPTH];
+        }
+        smsQueueCount--;
+        return true;
+    }
+    return false;
+}
+
+bool DMR828S::isSMSQueued(DMRSMSHandle handle) const {
+    for (uint8_t i = 0; i < smsQueueCount; i++) {
+        if (smsQueue[(smsQueueHead + i) % DMR_SMS_QUEUE_DEPTH].handle == handle) {
             return true;
         }
     }
+    return false;
+}
+
+void DMR828S::setSMSRetry(uint8_t maxRetries, uint32_t backoffMs) {
+    smsMaxRetries = maxRetries;
+    smsBackoffMs = backoffMs;
+}
+
+// Put the head's next part on air once its backoff has passed
+void DMR828S::pumpSMS() {
+    if (smsQueueCount == 0 || isSMSSending()) {
+        return;
+    }
+    SMSOutbound &msg = smsQueue[smsQueueHead];
+    if ((long)(millis() - msg.retryAt) < 0) {
+        return;
+    }
+    if (!sendSMSPart(msg)) {
+        smsAwaitingResult = false;
+        retrySMSPart(msg);
+    }
+}
+
+// The current part was refused (busy, 0x7E or a UART error): back off and
+// resend it, or fail the message once the retries are used up
+void DMR828S::retrySMSPart(SMSOutbound &msg) {
+    if (msg.attempts > smsMaxRetries) {
+        finishSMS(SMS_SEND_FAILED);
+        return;
+    }
+    smsQueueStats.retries++;
+    msg.retryAt = millis() + (smsBackoffMs << (msg.attempts - 1));
+}
+
+// Report the outcome of the head message, once per whole message
+void DMR828S::finishSMS(SMSSendStatus status) {
+    smsAwaitingResult = false;
+    if (smsQueueCount == 0) {
+        return;
+    }
+    
+    // Pop first so callbacks can queue the next message
+    SMSOutbound &msg = smsQueue[smsQueueHead];
+    DMRSMSHandle handle = msg.handle;
+    uint32_t targetID = msg.targetID;
+    SMSMessageCallback callback = msg.callback;
+    void *context = msg.context;
+    smsQueueHead = (smsQueueHead + 1) % DMR_SMS_QUEUE_DEPTH;
+    smsQueueCount--;
+    
+    if (status == SMS_SEND_SUCCESS) {
+        smsQueueStats.delivered++;
+    } else {
+        smsQueueStats.failed++;
+    }
+    
+    if (callback) {
+        callback(handle, targetID, status, context);
+    }
+    if (smsStatusCallback) {
+        smsStatusCallback(targetID, status);
+    }
+    if (hasEventListener(DMR_EVENT_SMS_SENT)) {
+        DMREvent event;
+        event.type = DMR_EVENT_SMS_SENT;
+        event.targetID = targetID;
+        event.handle = handle;
+        event.smsStatus = status;
+        notifyEvent(event);
+    }
+}
+
+bool DMR828S::getLastSMS(DMRSMSMessage &sms) {
+    DMRFrame frame;
+    // Call_ID + UTF-16LE text, like the 0x07 upload (DM828_PROTOCOL.md 2.6.5)
+    if (query(DMR_CMD_QUERY_SMS, frame) && frame.length >= 3) {
+        sms.sourceID = bytes3ToUint32(&frame.data[0]);
+        sms.targetID = 0;
+        sms.type = 0;
+        sms.length = dmrUtf16leToUtf8(&frame.data[3], frame.length - 3, sms.message, sizeof(sms.message));
+        sms.parts = 1;
+        sms.valid = true;
+        return true;
+    }
     sms.valid = false;
     return false;
 }
@@ -159,7 +363,7 @@ bool DMR828S::getLastSMS(DMRSMSMessage &sms) {
 bool DMR828S::sendEmergencyAlarm(uint32_t targetID) {
     uint8_t data[3];
     uint32ToBytes3(targetID, data);
-    return sendCommand(DMR_CMD_EMERGENCY, 0x01, 0x01, data, 3);
+    return sendCommand<DMR_CMD_EMERGENCY>(data, 3);
 }
 
 /********************************************************
@@ -168,17 +372,17 @@ bool DMR828S::sendEmergencyAlarm(uint32_t targetID) {
 
 bool DMR828S::setMicGain(uint8_t gain) {
     if (gain > 15) return false; // Typical range 0-15
-    return sendCommand(DMR_CMD_MIC_GAIN, 0x01, 0x01, &gain, 1);
+    return sendSetting<DMR_CMD_MIC_GAIN>(&gain, 1);
 }
 
 bool DMR828S::setDutyMode(bool enable) {
     uint8_t data = enable ? 0x01 : 0x00;
-    return sendCommand(DMR_CMD_DUTY_MODE, 0x01, 0x01, &data, 1);
+    return sendSetting<DMR_CMD_DUTY_MODE>(&data, 1);
 }
 
 bool DMR828S::setRepeaterMode(bool enable) {
     uint8_t data = enable ? 0x01 : 0x00;
-    return sendCommand(DMR_CMD_REPEATER_MODE, 0x01, 0x01, &data, 1);
+    return sendSetting<DMR_CMD_REPEATER_MODE>(&data, 1);
 }
 
 /********************************************************
@@ -189,32 +393,32 @@ bool DMR828S::setFrequency(uint32_t txFreq, uint32_t rxFreq) {
     uint8_t data[8];
     uint32ToBytes4(txFreq, &data[0]);
     uint32ToBytes4(rxFreq, &data[4]);
-    return sendCommand(DMR_CMD_SET_FREQUENCY, 0x01, 0x01, data, 8);
+    return sendSetting<DMR_CMD_SET_FREQUENCY>(data, 8);
 }
 
 bool DMR828S::setSQLLevel(uint8_t level) {
     if (level > 9) return false;
-    return sendCommand(DMR_CMD_SQL_SETTING, 0x01, 0x01, &level, 1);
+    return sendSetting<DMR_CMD_SQL_SETTING>(&level, 1);
 }
 
 bool DMR828S::setCTCSSType(uint8_t type) {
-    return sendCommand(DMR_CMD_CTCSS_TYPE, 0x01, 0x01, &type, 1);
+    return sendSetting<DMR_CMD_CTCSS_TYPE>(&type, 1);
 }
 
 bool DMR828S::setCTCSSCode(uint8_t code) {
-    return sendCommand(DMR_CMD_CTCSS_CODE, 0x01, 0x01, &code, 1);
+    return sendSetting<DMR_CMD_CTCSS_CODE>(&code, 1);
 }
 
 bool DMR828S::setTXPower(uint8_t power) {
     if (power > 3) return false; // Typical range 0-3
-    return sendCommand(DMR_CMD_TX_POWER, 0x01, 0x01, &power, 1);
+    return sendSetting<DMR_CMD_TX_POWER>(&power, 1);
 }
 
 bool DMR828S::setContact(uint32_t contactID, DMRCallType type) {
     uint8_t data[4];
     uint32ToBytes3(contactID, data);
     data[3] = (uint8_t)type;
-    return sendCommand(DMR_CMD_SET_CONTACT, 0x01, 0x01, data, 4);
+    return sendSetting<DMR_CMD_SET_CONTACT>(data, 4);
 }
 
 bool DMR828S::setEncryption(bool enable, const uint8_t* encryptionKey) {
@@ -232,25 +436,17 @@ bool DMR828S::setEncryption(bool enable, const uint8_t* encryptionKey) {
             data[5] = 0x05; data[6] = 0x06; data[7] = 0x07; data[8] = 0x08;
         }
         
-        if (utils.debug) {
-            Serial.print("[DEBUG] Setting encryption ON with key: ");
-            for (int i = 1; i < 9; i++) {
-                if (data[i] < 0x10) Serial.print("0");
-                Serial.print(data[i], HEX);
-            }
-            Serial.println();
-        }
+        // Never trace the key itself
+        DMR_TRACE_INFO(TRACE_ENCRYPTION, 1);
         
-        return sendCommand(DMR_CMD_ENCRYPTION, 0x01, 0x01, data, 9);
+        return sendSetting<DMR_CMD_ENCRYPTION>(data, 9);
     } else {
         // Encryption OFF: Format = SWITCH (0xFF)
         uint8_t data = 0xFF; // SWITCH: Encryption off
         
-        if (utils.debug) {
-            Serial.println("[DEBUG] Setting encryption OFF");
-        }
+        DMR_TRACE_INFO(TRACE_ENCRYPTION, 0);
         
-        return sendCommand(DMR_CMD_ENCRYPTION, 0x01, 0x01, &data, 1);
+        return sendSetting<DMR_CMD_ENCRYPTION>(&data, 1);
     }
 }
 
@@ -261,39 +457,53 @@ bool DMR828S::setEncryption(bool enable, const uint8_t* encryptionKey) {
 bool DMR828S::setRadioID(uint32_t radioID) {
     uint8_t data[3];
     uint32ToBytes3(radioID, data);
-    return sendCommand(DMR_CMD_SET_RADIO_ID, 0x01, 0x01, data, 3);
+    return sendSetting<DMR_CMD_SET_RADIO_ID>(data, 3);
 }
 
-uint32_t DMR828S::getRadioID() {
-    uint8_t data = 0x01;
-    if (sendCommand(DMR_CMD_CHECK_RADIO_ID, 0x01, 0x01, &data, 1)) {
-        DMRFrame frame;
-        if (waitForResponse(frame) && frame.length >= 3) {
-            return bytes3ToUint32(frame.data);
-        }
+uint32_t DMR828S::getRadioID(bool refresh) {
+    uint32_t radioID;
+    if (!refresh && getCached(SHADOW_RADIO_ID, radioID)) {
+        return radioID;
+    }
+    DMRFrame frame;
+    if (query(DMR_CMD_CHECK_RADIO_ID, frame) && frame.length >= 3) {
+        return bytes3ToUint32(frame.data);
     }
     return 0;
 }
 
-uint32_t DMR828S::getContactID() {
-    uint8_t data = 0x01;
-    if (sendCommand(DMR_CMD_CHECK_CONTACT_ID, 0x01, 0x01, &data, 1)) {
-        DMRFrame frame;
-        if (waitForResponse(frame) && frame.length >= 3) {
-            return bytes3ToUint32(frame.data);
-        }
+uint32_t DMR828S::getContactID(bool refresh) {
+    uint32_t contactID;
+    if (!refresh && getCached(SHADOW_CONTACT_ID, contactID)) {
+        return contactID;
+    }
+    DMRFrame frame;
+    if (query(DMR_CMD_CHECK_CONTACT_ID, frame) && frame.length >= 3) {
+        return bytes3ToUint32(frame.data);
     }
     return 0;
 }
 
 bool DMR828S::setColorCode(uint8_t colorCode) {
     if (colorCode > 15) return false;
-    return sendCommand(DMR_CMD_COLOR_CODE, 0x01, 0x01, &colorCode, 1);
+    return sendSetting<DMR_CMD_COLOR_CODE>(&colorCode, 1);
 }
 
 bool DMR828S::setTimeSlot(uint8_t timeSlot) {
     if (timeSlot < 1 || timeSlot > 2) return false;
-    return sendCommand(DMR_CMD_TIME_SLOT, 0x01, 0x01, &timeSlot, 1);
+    return sendSetting<DMR_CMD_TIME_SLOT>(&timeSlot, 1);
+}
+
+uint8_t DMR828S::getColorCode(bool refresh) {
+    return channelShadow(SHADOW_COLOR_CODE, refresh);
+}
+
+uint8_t DMR828S::getTimeSlot(bool refresh) {
+    return channelShadow(SHADOW_TIME_SLOT, refresh);
+}
+
+uint8_t DMR828S::getTXPower(bool refresh) {
+    return channelShadow(SHADOW_TX_POWER, refresh);
 }
 
 /********************************************************
@@ -305,12 +515,12 @@ bool DMR828S::addContactToRXGroup(uint8_t groupIndex, uint32_t contactID) {
     uint8_t data[4];
     data[0] = groupIndex;
     uint32ToBytes3(contactID, &data[1]);
-    return sendCommand(DMR_CMD_ADD_RX_GROUP, 0x01, 0x01, data, 4);
+    return sendSetting<DMR_CMD_ADD_RX_GROUP>(data, 4);
 }
 
 bool DMR828S::clearRXGroup(uint8_t groupIndex) {
     if (groupIndex < 1 || groupIndex > 32) return false;
-    return sendCommand(DMR_CMD_CLEAR_RX_GROUP, 0x01, 0x01, &groupIndex, 1);
+    return sendSetting<DMR_CMD_CLEAR_RX_GROUP>(&groupIndex, 1);
 }
 
 /********************************************************
@@ -318,61 +528,61 @@ bool DMR828S::clearRXGroup(uint8_t groupIndex) {
  ********************************************************/
 
 String DMR828S::getFirmwareVersion() {
-    uint8_t data = 0x01;
-    if (sendCommand(DMR_CMD_FIRMWARE_VERSION, 0x01, 0x01, &data, 1)) {
-        DMRFrame frame;
-        if (waitForResponse(frame) && frame.length > 0) {
-            String version = "";
-            for (int i = 0; i < frame.length; i++) {
-                if (frame.data[i] >= 32 && frame.data[i] <= 126) {
-                    version += (char)frame.data[i];
-                }
+    DMRFrame frame;
+    if (query(DMR_CMD_FIRMWARE_VERSION, frame) && frame.length > 0) {
+        String version = "";
+        for (int i = 0; i < frame.length; i++) {
+            if (frame.data[i] >= 32 && frame.data[i] <= 126) {
+                version += (char)frame.data[i];
             }
-            return version;
         }
+        return version;
     }
     return "Unknown";
 }
 
-bool DMR828S::getEncryptionStatus() {
-    uint8_t data = 0x01;
-    if (sendCommand(DMR_CMD_ENCRYPTION_STATUS, 0x01, 0x01, &data, 1)) {
-        DMRFrame frame;
-        if (waitForResponse(frame) && frame.length >= 1) {
-            return frame.data[0] != 0;
-        }
+bool DMR828S::getEncryptionStatus(bool refresh) {
+    uint32_t encryptionOn;
+    if (!refresh && getCached(SHADOW_ENCRYPTION, encryptionOn)) {
+        return encryptionOn != 0;
+    }
+    DMRFrame frame;
+    if (query(DMR_CMD_ENCRYPTION_STATUS, frame) && frame.length >= 1) {
+        return frame.data[0] != 0;
     }
     return false;
 }
 
-bool DMR828S::getCurrentChannelParams(DMRChannelParams &params) {
-    uint8_t data = 0x01;
-    if (sendCommand(DMR_CMD_CHANNEL_PARAMS, 0x01, 0x01, &data, 1)) {
-        DMRFrame frame;
-        if (waitForResponse(frame) && frame.length >= 20) {
-            // Parse channel parameters from response
-            params.channel = frame.data[0];
-            params.txFreq = bytes4ToUint32(&frame.data[1]);
-            params.rxFreq = bytes4ToUint32(&frame.data[5]);
-            params.power = frame.data[9];
-            params.bandwidth = frame.data[10];
-            params.colorCode = frame.data[11];
-            params.timeSlot = frame.data[12];
-            params.contactID = bytes3ToUint32(&frame.data[13]);
-            params.encryptionOn = frame.data[16] != 0;
-            return true;
-        }
+bool DMR828S::getCurrentChannelParams(DMRChannelParams &params, bool refresh) {
+    uint32_t v[DMR_SHADOW_COUNT];
+    bool cached = !refresh;
+    for (uint8_t f = SHADOW_CHANNEL; cached && f <= SHADOW_RX_FREQ; f++) {
+        cached = f == SHADOW_VOLUME || f == SHADOW_RADIO_ID || getCached((DMRShadowField)f, v[f]);
+    }
+    if (cached) {
+        params.channel = v[SHADOW_CHANNEL];
+        params.txFreq = v[SHADOW_TX_FREQ];
+        params.rxFreq = v[SHADOW_RX_FREQ];
+        params.power = v[SHADOW_TX_POWER];
+        params.bandwidth = v[SHADOW_BANDWIDTH];
+        params.colorCode = v[SHADOW_COLOR_CODE];
+        params.timeSlot = v[SHADOW_TIME_SLOT];
+        params.contactID = v[SHADOW_CONTACT_ID];
+        params.encryptionOn = v[SHADOW_ENCRYPTION] != 0;
+        return true;
+    }
+    
+    DMRFrame frame;
+    if (query(DMR_CMD_CHANNEL_PARAMS, frame)) {
+        return parseChannelParams(frame.data, frame.length, params);
     }
     return false;
 }
 
 bool DMR828S::getInitializationStatus() {
-    uint8_t data = 0x01;
-    if (sendCommand(DMR_CMD_INIT_STATUS, 0x01, 0x01, &data, 1)) {
-        DMRFrame frame;
-        if (waitForResponse(frame) && frame.length >= 1) {
-            return frame.data[0] == 0x00; // 0x00 = initialized
-        }
+    DMRFrame frame;
+    if (query(DMR_CMD_INIT_STATUS, frame) && frame.length >= 1) {
+        return frame.data[0] == 0x00; // 0x00 = initialized
     }
     return false;
 }
@@ -382,13 +592,15 @@ bool DMR828S::getInitializationStatus() {
  ********************************************************/
 
 bool DMR828S::resetToDefaults() {
+    invalidateCache();
     uint8_t data = 0x01;
-    return sendCommand(DMR_CMD_RESET_DEFAULTS, 0x01, 0x01, &data, 1);
+    return sendCommand<DMR_CMD_RESET_DEFAULTS>(&data, 1);
 }
 
 bool DMR828S::softwareReset() {
+    invalidateCache();
     uint8_t data = 0x01;
-    return sendCommand(DMR_CMD_SOFTWARE_RESET, 0x01, 0x01, &data, 1);
+    return sendCommand<DMR_CMD_SOFTWARE_RESET>(&data, 1);
 }
 
 /********************************************************
@@ -397,345 +609,958 @@ bool DMR828S::softwareReset() {
 
 bool DMR828S::setBandwidth(uint8_t bandwidth) {
     if (bandwidth > 1) return false; // 0=12.5K, 1=25K
-    return sendCommand(DMR_CMD_BANDWIDTH, 0x01, 0x01, &bandwidth, 1);
+    return sendSetting<DMR_CMD_BANDWIDTH>(&bandwidth, 1);
 }
 
 bool DMR828S::setToneOnOff(bool enable) {
     uint8_t data = enable ? 0x01 : 0x00;
-    return sendCommand(DMR_CMD_TONE_ONOFF, 0x01, 0x01, &data, 1);
+    return sendSetting<DMR_CMD_TONE_ONOFF>(&data, 1);
 }
 
 /********************************************************
- * EVENT HANDLING
+ * ASYNC QUERIES
  ********************************************************/
 
-void DMR828S::update() {
-    DMRFrame frame;
-    while (utils.readFrame(frame)) {
-        if (utils.debug) {
-            Serial.println("[DEBUG] Frame received in update()");
-            Serial.print("  CMD: 0x"); Serial.println(frame.cmd, HEX);
-            Serial.print("  R/W: 0x"); Serial.println(frame.rw, HEX);
-            Serial.print("  SR: 0x"); Serial.println(frame.sr, HEX);
-            Serial.print("  LEN: "); Serial.println(frame.length);
-            Serial.print("  VALID: "); Serial.println(frame.valid ? "YES" : "NO");
-            if (frame.length > 0) {
-                Serial.print("  DATA: ");
-                for (int i = 0; i < frame.length; i++) {
-                    if (frame.data[i] < 0x10) Serial.print("0");
-                    Serial.print(frame.data[i], HEX);
-                    Serial.print(" ");
-                }
-                Serial.println();
+bool DMR828S::sendRequest(uint8_t cmd, const uint8_t *data, uint16_t len,
+                          ResponseCallback callback, void *context, uint32_t timeout_ms) {
+    if (!addPending(cmd, callback, context, timeout_ms)) {
+        return false;
+    }
+    // No flush: the response timeout already covers the time on the wire,
+    // and back-to-back requests (config pipelining) should not stall here
+    if (!sendCommand(cmd, 0x01, 0x01, data, len, false)) {
+        cancelRequest(cmd);
+        return false;
+    }
+    return true;
+}
+
+bool DMR828S::requestModuleStatus(ResponseCallback callback, void *context) {
+    uint8_t data = 0x01;
+    return sendRequest(DMR_CMD_CHECK_STATUS, &data, 1, callback, context);
+}
+
+bool DMR828S::requestRSSI(ResponseCallback callback, void *context) {
+    uint8_t data = 0x01;
+    return sendRequest(DMR_CMD_RSSI, &data, 1, callback, context);
+}
+
+bool DMR828S::requestRadioID(ResponseCallback callback, void *context) {
+    uint8_t data = 0x01;
+    return sendRequest(DMR_CMD_CHECK_RADIO_ID, &data, 1, callback, context);
+}
+
+bool DMR828S::requestChannelParams(ResponseCallback callback, void *context) {
+    uint8_t data = 0x01;
+    return sendRequest(DMR_CMD_CHANNEL_PARAMS, &data, 1, callback, context);
+}
+
+bool DMR828S::isRequestPending(uint8_t cmd) const {
+    return findPending(cmd) >= 0;
+}
+
+void DMR828S::cancelRequest(uint8_t cmd) {
+    int slot = findPending(cmd);
+    if (slot >= 0) {
+        pending[slot].active = false;
+    }
+}
+
+bool DMR828S::parseChannelParams(const uint8_t *data, uint16_t length, DMRChannelParams &params) {
+    if (length < 20) return false;
+    params.channel = data[0];
+    params.txFreq = bytes4ToUint32(&data[1]);
+    params.rxFreq = bytes4ToUint32(&data[5]);
+    params.power = data[9];
+    params.bandwidth = data[10];
+    params.colorCode = data[11];
+    params.timeSlot = data[12];
+    params.contactID = bytes3ToUint32(&data[13]);
+    params.encryptionOn = data[16] != 0;
+    return true;
+}
+
+/********************************************************
+ * SHADOW REGISTERS
+ ********************************************************/
+
+// Fields that differ per channel and go stale when the channel changes
+static const uint16_t SHADOW_PER_CHANNEL = (1U << SHADOW_CONTACT_ID) | (1U << SHADOW_COLOR_CODE) |
+                                           (1U << SHADOW_TIME_SLOT) | (1U << SHADOW_TX_POWER) |
+                                           (1U << SHADOW_BANDWIDTH) | (1U << SHADOW_ENCRYPTION) |
+                                           (1U << SHADOW_TX_FREQ) | (1U << SHADOW_RX_FREQ);
+
+bool DMR828S::getCached(DMRShadowField field, uint32_t &value) const {
+    if (field >= DMR_SHADOW_COUNT || !(shadowValid & (1U << field))) {
+        return false;
+    }
+    if (shadowMaxAge && millis() - shadowAt[field] > shadowMaxAge) {
+        return false;
+    }
+    value = shadow[field];
+    return true;
+}
+
+uint32_t DMR828S::getCacheAge(DMRShadowField field) const {
+    if (field >= DMR_SHADOW_COUNT || !(shadowValid & (1U << field))) {
+        return DMR_SHADOW_NEVER;
+    }
+    return millis() - shadowAt[field];
+}
+
+void DMR828S::invalidateCache() {
+    shadowValid = 0;
+    shadowStagedMask = 0;
+}
+
+void DMR828S::invalidateCache(DMRShadowField field) {
+    if (field < DMR_SHADOW_COUNT) {
+        shadowValid &= ~(1U << field);
+    }
+}
+
+void DMR828S::setShadow(DMRShadowField field, uint32_t value) {
+    shadow[field] = value;
+    shadowAt[field] = millis();
+    shadowValid |= 1U << field;
+}
+
+// Fields a write command sets
+uint16_t DMR828S::shadowFields(uint8_t cmd) {
+    switch (cmd) {
+        case DMR_CMD_SET_CHANNEL:   return 1U << SHADOW_CHANNEL;
+        case DMR_CMD_SET_VOLUME:    return 1U << SHADOW_VOLUME;
+        case DMR_CMD_SET_RADIO_ID:  return 1U << SHADOW_RADIO_ID;
+        case DMR_CMD_SET_CONTACT:   return 1U << SHADOW_CONTACT_ID;
+        case DMR_CMD_COLOR_CODE:    return 1U << SHADOW_COLOR_CODE;
+        case DMR_CMD_TIME_SLOT:     return 1U << SHADOW_TIME_SLOT;
+        case DMR_CMD_TX_POWER:      return 1U << SHADOW_TX_POWER;
+        case DMR_CMD_BANDWIDTH:     return 1U << SHADOW_BANDWIDTH;
+        case DMR_CMD_ENCRYPTION:    return 1U << SHADOW_ENCRYPTION;
+        case DMR_CMD_SET_FREQUENCY: return (1U << SHADOW_TX_FREQ) | (1U << SHADOW_RX_FREQ);
+        default:                    return 0;
+    }
+}
+
+// Remember what a write sets; it only reaches the cache once acked. A write
+// shorter than the register is not staged, so its ack leaves the cache alone.
+void DMR828S::stageShadow(uint8_t cmd, const uint8_t *data, uint16_t len) {
+    uint16_t width = 1;
+    if (cmd == DMR_CMD_SET_FREQUENCY) {
+        width = 8;
+    } else if (cmd == DMR_CMD_SET_RADIO_ID || cmd == DMR_CMD_SET_CONTACT) {
+        width = 3;
+    }
+    if (len < width) {
+        return;
+    }
+    switch (cmd) {
+        case DMR_CMD_SET_CHANNEL:   shadowStaged[SHADOW_CHANNEL] = data[0]; break;
+        case DMR_CMD_SET_VOLUME:    shadowStaged[SHADOW_VOLUME] = data[0]; break;
+        case DMR_CMD_SET_RADIO_ID:  shadowStaged[SHADOW_RADIO_ID] = bytes3ToUint32(data); break;
+        case DMR_CMD_SET_CONTACT:   shadowStaged[SHADOW_CONTACT_ID] = bytes3ToUint32(data); break;
+        case DMR_CMD_COLOR_CODE:    shadowStaged[SHADOW_COLOR_CODE] = data[0]; break;
+        case DMR_CMD_TIME_SLOT:     shadowStaged[SHADOW_TIME_SLOT] = data[0]; break;
+        case DMR_CMD_TX_POWER:      shadowStaged[SHADOW_TX_POWER] = data[0]; break;
+        case DMR_CMD_BANDWIDTH:     shadowStaged[SHADOW_BANDWIDTH] = data[0]; break;
+        case DMR_CMD_ENCRYPTION:    shadowStaged[SHADOW_ENCRYPTION] = data[0] == 0x01; break;
+        case DMR_CMD_SET_FREQUENCY:
+            shadowStaged[SHADOW_TX_FREQ] = bytes4ToUint32(&data[0]);
+            shadowStaged[SHADOW_RX_FREQ] = bytes4ToUint32(&data[4]);
+            break;
+        default:
+            return;
+    }
+    shadowStagedMask |= shadowFields(cmd);
+}
+
+// Every response and upload passes through here: acks commit staged writes,
+// query responses refresh what they report, uploads drop what they touch
+void DMR828S::updateShadow(const DMRFrameView &frame) {
+    // The module restarted (a reset acked, or an unprompted init status after
+    // power-up): nothing cached or staged survives
+    if (frame.cmd == DMR_CMD_RESET_DEFAULTS || frame.cmd == DMR_CMD_SOFTWARE_RESET ||
+        (frame.cmd == DMR_CMD_INIT_STATUS && frame.rw == 0x02)) {
+        invalidateCache();
+        return;
+    }
+    if (frame.rw == 0x02) {
+        // Changed on the module itself (front panel, over the air); the next
+        // read asks again rather than trusting the upload's layout
+        uint16_t changed = shadowFields(frame.cmd);
+        if (frame.cmd == DMR_CMD_SET_CHANNEL || frame.cmd == DMR_CMD_CHANNEL_PARAMS) {
+            changed |= (1U << SHADOW_CHANNEL) | SHADOW_PER_CHANNEL;
+        }
+        shadowValid &= ~changed;
+        return;
+    }
+    
+    uint16_t fields = shadowFields(frame.cmd) & shadowStagedMask;
+    if (fields) {
+        shadowStagedMask &= ~fields;
+        if (frame.sr != RESPONSE_OK) {
+            // Refused or garbled: what the module holds now is unknown
+            shadowValid &= ~fields;
+            return;
+        }
+        if (frame.cmd == DMR_CMD_SET_CHANNEL) {
+            shadowValid &= ~SHADOW_PER_CHANNEL;
+        }
+        for (uint8_t f = 0; f < DMR_SHADOW_COUNT; f++) {
+            if (fields & (1U << f)) {
+                setShadow((DMRShadowField)f, shadowStaged[f]);
             }
         }
+        return;
+    }
+    
+    switch (frame.cmd) {
+        case DMR_CMD_CHANNEL_PARAMS: {
+            DMRChannelParams params;
+            if (parseChannelParams(frame.data, frame.length, params)) {
+                setShadow(SHADOW_CHANNEL, params.channel);
+                setShadow(SHADOW_TX_FREQ, params.txFreq);
+                setShadow(SHADOW_RX_FREQ, params.rxFreq);
+                setShadow(SHADOW_TX_POWER, params.power);
+                setShadow(SHADOW_BANDWIDTH, params.bandwidth);
+                setShadow(SHADOW_COLOR_CODE, params.colorCode);
+                setShadow(SHADOW_TIME_SLOT, params.timeSlot);
+                setShadow(SHADOW_CONTACT_ID, params.contactID);
+                setShadow(SHADOW_ENCRYPTION, params.encryptionOn);
+            }
+            break;
+        }
+        case DMR_CMD_CHECK_RADIO_ID:
+            if (frame.length >= 3) setShadow(SHADOW_RADIO_ID, bytes3ToUint32(frame.data));
+            break;
+        case DMR_CMD_CHECK_CONTACT_ID:
+            if (frame.length >= 3) setShadow(SHADOW_CONTACT_ID, bytes3ToUint32(frame.data));
+            break;
+        case DMR_CMD_ENCRYPTION_STATUS:
+            if (frame.length >= 1) setShadow(SHADOW_ENCRYPTION, frame.data[0] != 0);
+            break;
+        default:
+            break;
+    }
+}
+
+// Channel-parameter fields come from one 0x1D query
+uint32_t DMR828S::channelShadow(DMRShadowField field, bool refresh) {
+    uint32_t value;
+    if (!refresh && getCached(field, value)) {
+        return value;
+    }
+    DMRChannelParams params;
+    if (getCurrentChannelParams(params, true) && getCached(field, value)) {
+        return value;
+    }
+    return 0;
+}
+
+/********************************************************
+ * CONFIG TRANSACTIONS
+ ********************************************************/
+
+void DMR828S::beginConfig() {
+    configCount = 0;
+    configState = CONFIG_RECORDING;
+}
+
+void DMR828S::abortConfig() {
+    if (configState == CONFIG_RUNNING) {
+        for (uint8_t i = 0; i < configCount; i++) {
+            if (configWrites[i].state == CONFIG_WRITE_IN_FLIGHT) {
+                cancelRequest(configWrites[i].cmd);
+            }
+        }
+    }
+    configCount = 0;
+    configState = CONFIG_IDLE;
+}
+
+void DMR828S::setConfigWindow(uint8_t window) {
+    configWindow = window < 1 ? 1 : window;
+}
+
+bool DMR828S::queueConfigWrite(uint8_t cmd, const uint8_t *data, uint16_t len) {
+    if (configCount >= DMR_CONFIG_MAX_WRITES || len > DMR_CONFIG_MAX_DATA) {
+        return false;
+    }
+    ConfigWrite &w = configWrites[configCount++];
+    w.cmd = cmd;
+    w.length = len;
+    memcpy(w.data, data, len);
+    w.state = CONFIG_WRITE_QUEUED;
+    w.attempts = 0;
+    w.lastStatus = RESPONSE_OK;
+    w.retryAt = 0;
+    return true;
+}
+
+bool DMR828S::commitConfigAsync(ConfigDoneCallback callback, void *context) {
+    if (configState != CONFIG_RECORDING) {
+        return false;
+    }
+    configCallback = callback;
+    configContext = context;
+    configResult = DMRConfigResult();
+    configResult.total = configCount;
+    configStartTime = millis();
+    configState = CONFIG_RUNNING;
+    pumpConfig();
+    return true;
+}
+
+bool DMR828S::commitConfig(DMRConfigResult &result) {
+    BlockingConfig wait;
+    wait.result = &result;
+    // Like query(), this cannot wait from inside update()
+    if (updating || !commitConfigAsync(onBlockingConfig, &wait)) {
+        return false;
+    }
+    while (!wait.done) {
+        update();
+        if (!wait.done) {
+            utils.waitForRx(1);
+        }
+    }
+    return result.success;
+}
+
+void DMR828S::onBlockingConfig(const DMRConfigResult &result, void *context) {
+    BlockingConfig *wait = (BlockingConfig *)context;
+    *wait->result = result;
+    wait->done = true;
+}
+
+void DMR828S::onConfigAck(bool ok, const DMRFrameView &response, void *context) {
+    ((DMR828S *)context)->handleConfigAck(ok, response);
+}
+
+void DMR828S::handleConfigAck(bool ok, const DMRFrameView &response) {
+    for (uint8_t i = 0; i < configCount; i++) {
+        ConfigWrite &w = configWrites[i];
+        if (w.state != CONFIG_WRITE_IN_FLIGHT || w.cmd != response.cmd) {
+            continue;
+        }
         
-        if (frame.valid) {
-            processIncomingFrame(frame);
-        } else if (utils.debug) {
-            Serial.println("[DEBUG] Skipping invalid frame");
+        w.lastStatus = ok ? (DMRResponseStatus)response.sr : RESPONSE_BUSY_FAIL;
+        if (ok && response.sr == RESPONSE_OK) {
+            w.state = CONFIG_WRITE_ACKED;
+            configResult.acked++;
+        } else if (w.attempts <= DMR_CONFIG_MAX_RETRIES && w.lastStatus != RESPONSE_CHANNEL_ERROR) {
+            // Timeout, busy or checksum error - back off and resend
+            w.state = CONFIG_WRITE_QUEUED;
+            w.retryAt = millis() + DMR_CONFIG_RETRY_BACKOFF_MS * w.attempts;
+            configResult.retries++;
+        } else {
+            // Channel errors are permanent for this channel type, don't retry
+            w.state = CONFIG_WRITE_FAILED;
+            configResult.failedCmds[configResult.failed++] = w.cmd;
         }
+        break;
+    }
+    pumpConfig();
+}
+
+void DMR828S::pumpConfig() {
+    if (configState != CONFIG_RUNNING) {
+        return;
     }
     
-    // Optional: Safety timeout only for extreme cases (60 seconds)
-    // This prevents infinite waiting if module completely fails
-    if (smsStatusCallback && lastSMSSendTime > 0 && (millis() - lastSMSSendTime) > 60000) {
-        if (utils.debug) {
-            Serial.println("[DEBUG] SMS extreme timeout (60s) - module may have failed");
-            Serial.println("[DEBUG] Triggering safety fallback");
+    uint8_t inFlight = 0;
+    bool outstanding = false;
+    for (uint8_t i = 0; i < configCount; i++) {
+        if (configWrites[i].state == CONFIG_WRITE_IN_FLIGHT) inFlight++;
+        if (configWrites[i].state <= CONFIG_WRITE_IN_FLIGHT) outstanding = true;
+    }
+    
+    if (!outstanding) {
+        configState = CONFIG_IDLE;
+        configResult.elapsedMs = millis() - configStartTime;
+        configResult.success = (configResult.failed == 0);
+        DMR_TRACE_INFO(TRACE_CONFIG_DONE, configResult.acked, configResult.total,
+                       configResult.retries, configResult.elapsedMs);
+        if (configCallback) {
+            configCallback(configResult, configContext);
         }
-        smsStatusCallback(lastSMSTargetID, SMS_SEND_TIMEOUT);
-        lastSMSSendTime = 0; // Reset to avoid multiple timeout calls
+        return;
+    }
+    
+    // Keep up to configWindow writes on the wire, in queue order
+    unsigned long now = millis();
+    for (uint8_t i = 0; i < configCount && inFlight < configWindow; i++) {
+        ConfigWrite &w = configWrites[i];
+        if (w.state != CONFIG_WRITE_QUEUED || (long)(now - w.retryAt) < 0) {
+            continue;
+        }
+        // A second write to the same command waits for the first ack
+        if (isRequestPending(w.cmd)) {
+            continue;
+        }
+        if (!sendRequest(w.cmd, w.data, w.length, onConfigAck, this, DMR_CONFIG_ACK_TIMEOUT_MS)) {
+            // Never reached the module (pending table full, UART write failed):
+            // not an attempt, but wait a backoff instead of retrying every update()
+            w.retryAt = now + DMR_CONFIG_RETRY_BACKOFF_MS;
+            break;
+        }
+        w.attempts++;
+        w.state = CONFIG_WRITE_IN_FLIGHT;
+        inFlight++;
     }
 }
 
-void DMR828S::processIncomingFrame(const DMRFrame &frame) {
-    if (utils.debug) {
-        Serial.println("[DEBUG] Processing incoming frame");
-        Serial.print("  CMD: 0x"); Serial.print(frame.cmd, HEX);
-        Serial.print(" R/W: 0x"); Serial.print(frame.rw, HEX);
-        Serial.print(" SR: 0x"); Serial.println(frame.sr, HEX);
+/********************************************************
+ * SUBSCRIPTIONS
+ ********************************************************/
+
+// Subscription IDs are pool index + 1 so that 0 stays invalid
+DMRSubscription DMR828S::addListener(uint8_t &head, FrameListener frameListener,
+                                     EventListener eventListener, void *context) {
+    for (uint8_t i = 0; i < DMR_MAX_LISTENERS; i++) {
+        Listener &l = listeners[i];
+        if (l.active) {
+            continue;
+        }
+        l.active = true;
+        l.frameListener = frameListener;
+        l.eventListener = eventListener;
+        l.context = context;
+        l.head = &head;
+        l.next = NO_LISTENER;
+        
+        // Append so listeners run in subscription order
+        uint8_t *link = &head;
+        while (*link != NO_LISTENER) {
+            link = &listeners[*link].next;
+        }
+        *link = i;
+        return i + 1;
+    }
+    return DMR_INVALID_SUBSCRIPTION;
+}
+
+DMRSubscription DMR828S::subscribeFrame(uint8_t cmd, FrameListener listener, void *context) {
+    if (!listener) {
+        return DMR_INVALID_SUBSCRIPTION;
     }
+    return addListener(frameHead[cmd], listener, nullptr, context);
+}
+
+DMRSubscription DMR828S::subscribeAllFrames(FrameListener listener, void *context) {
+    if (!listener) {
+        return DMR_INVALID_SUBSCRIPTION;
+    }
+    return addListener(anyFrameHead, listener, nullptr, context);
+}
+
+DMRSubscription DMR828S::subscribeEvent(DMREventType type, EventListener listener, void *context) {
+    if (!listener || type >= DMR_EVENT_COUNT) {
+        return DMR_INVALID_SUBSCRIPTION;
+    }
+    return addListener(eventHead[type], nullptr, listener, context);
+}
+
+bool DMR828S::unsubscribe(DMRSubscription subscription) {
+    if (subscription == DMR_INVALID_SUBSCRIPTION || subscription > DMR_MAX_LISTENERS ||
+        !listeners[subscription - 1].active) {
+        return false;
+    }
+    uint8_t index = subscription - 1;
     
+    uint8_t *link = listeners[index].head;
+    while (*link != NO_LISTENER && *link != index) {
+        link = &listeners[*link].next;
+    }
+    if (*link == index) {
+        // Keep 'next' intact so a dispatch walking this node can continue
+        *link = listeners[index].next;
+    }
+    listeners[index].active = false;
+    return true;
+}
+
+void DMR828S::notifyFrame(uint8_t head, const DMRFrameView &frame) {
+    for (uint8_t i = head; i != NO_LISTENER; i = listeners[i].next) {
+        if (listeners[i].active) {
+            listeners[i].frameListener(frame, listeners[i].context);
+        }
+    }
+}
+
+void DMR828S::notifyEvent(const DMREvent &event) {
+    for (uint8_t i = eventHead[event.type]; i != NO_LISTENER; i = listeners[i].next) {
+        if (listeners[i].active) {
+            listeners[i].eventListener(event, listeners[i].context);
+        }
+    }
+}
+
+/********************************************************
+ * EVENT HANDLING
+ ********************************************************/
+
+void DMR828S::update() {
+    // Re-entered from a listener: reading on would reuse the receive buffer
+    // that the frame being dispatched points into
+    if (updating) {
+        return;
+    }
+    updating = true;
+    
+    DMRFrameView frame;
+    while (utils.readFrame(frame)) {
+        handleFrame(frame);
+    }
+    
+    expirePending();
+    pumpConfig();
+    
+    // Optional: Safety timeout only for extreme cases (60 seconds per part)
+    // This prevents infinite waiting if module completely fails
+    if (smsAwaitingResult && (millis() - lastSMSSendTime) > DMR_SMS_RESULT_TIMEOUT_MS) {
+        DMR_TRACE_ERROR(TRACE_SMS_TIMEOUT, lastSMSTargetID, millis() - lastSMSSendTime);
+        finishSMS(SMS_SEND_TIMEOUT);
+    }
+    
+    // Next queued message or part whose backoff has passed
+    pumpSMS();
+    expireReassembly();
+    updating = false;
+}
+
+void DMR828S::handleFrame(const DMRFrameView &frame) {
+    if (!frame.valid) {
+        DMR_TRACE_ERROR(TRACE_FRAME_INVALID, frame.cmd, frame.rw, frame.sr, frame.checksum);
+        return;
+    }
+    DMR_TRACE_DEBUG(TRACE_FRAME_RX, frame.cmd, frame.rw, frame.sr, frame.length);
+    
+    if (frame.rw == 0x00 || frame.rw == 0x02) {
+        updateShadow(frame);
+    }
+    
+    // Raw subscribers see every frame, including responses to requests
+    notifyFrame(anyFrameHead, frame);
+    notifyFrame(frameHead[frame.cmd], frame);
+    
+    // Responses complete a pending request; everything else is an event
+    if (frame.rw == 0x00 && completePending(frame)) {
+        return;
+    }
+    processIncomingFrame(frame);
+}
+
+void DMR828S::processIncomingFrame(const DMRFrameView &frame) {
     switch (frame.cmd) {
         case DMR_CMD_SMS:
-            if (utils.debug) {
-                Serial.println("[DEBUG] SMS command detected!");
-            }
-            
             if (frame.rw == 0x02) { // Initiative sending (incoming SMS)
-                if (utils.debug) {
-                    Serial.println("[DEBUG] Processing incoming SMS (RW=0x02)");
-                }
                 processSMSEvent(frame);
             } 
             else if (frame.rw == 0x00) { // Response frame (SMS send result)
-                if (utils.debug) {
-                    Serial.println("[DEBUG] Processing SMS response (RW=0x00)");
-                    Serial.print("  Response code: 0x"); Serial.println(frame.sr, HEX);
-                    
-                    if (frame.sr == 0x71) {
-                        Serial.println("  ✅ SMS sent successfully!");
-                    } else if (frame.sr == 0x7E) {
-                        Serial.println("  ❌ SMS send failed!");
-                    } else {
-                        Serial.println("  ❓ Unknown SMS response code");
-                    }
-                }
-                
-                // Process SMS send status
                 processSMSStatusEvent(frame);
             } 
-            else if (utils.debug) {
-                Serial.print("[DEBUG] Ignoring SMS frame - unhandled R/W: 0x");
-                Serial.println(frame.rw, HEX);
+            else {
+                DMR_TRACE_DEBUG(TRACE_FRAME_UNHANDLED, frame.cmd, frame.rw, frame.sr, frame.length);
             }
             break;
             
         case DMR_CMD_CALL:
-            if (utils.debug) {
-                Serial.println("[DEBUG] Call command detected!");
-            }
             if (frame.rw == 0x02) { // Initiative sending (call events)
                 processCallEvent(frame);
-            } else if (frame.rw == 0x00) { // Call response
-                if (utils.debug) {
-                    Serial.println("[DEBUG] Call response received");
-                }
             }
             break;
             
         case DMR_CMD_EMERGENCY:
-            if (utils.debug) {
-                Serial.println("[DEBUG] Emergency command detected!");
-            }
             if (frame.rw == 0x02) { // Initiative sending (emergency)
                 processEmergencyEvent(frame);
             }
             break;
             
         default:
-            if (utils.debug) {
-                Serial.print("[DEBUG] Unknown/unhandled command: 0x");
-                Serial.println(frame.cmd, HEX);
+            if (frameHead[frame.cmd] == NO_LISTENER && anyFrameHead == NO_LISTENER) {
+                DMR_TRACE_DEBUG(TRACE_FRAME_UNHANDLED, frame.cmd, frame.rw, frame.sr, frame.length);
             }
             break;
     }
 }
 
-void DMR828S::processSMSEvent(const DMRFrame &frame) {
-    if (utils.debug) {
-        Serial.println("\n[DEBUG] ===== SMS EVENT PROCESSING =====");
-        Serial.print("  Frame length: "); Serial.println(frame.length);
-        Serial.print("  SMS callback set: "); Serial.println(smsCallback ? "YES" : "NO");
-        
-        Serial.println("  Raw frame data analysis:");
-        for (int i = 0; i < frame.length && i < 20; i++) {
-            Serial.print("    [" + String(i) + "]: 0x");
-            if (frame.data[i] < 0x10) Serial.print("0");
-            Serial.print(frame.data[i], HEX);
-            Serial.print(" (" + String(frame.data[i]) + ")");
-            if (frame.data[i] >= 32 && frame.data[i] <= 126) {
-                Serial.print(" '" + String((char)frame.data[i]) + "'");
-            }
-            Serial.println();
-        }
+void DMR828S::processSMSEvent(const DMRFrameView &frame) {
+    if ((!smsCallback && !hasEventListener(DMR_EVENT_SMS_RECEIVED)) || frame.length < 3) {
+        return;
     }
     
-    if (!smsCallback) {
-        if (utils.debug) {
-            Serial.println("[DEBUG] SMS callback not set - ignoring SMS");
-        }
+    // Upload layout (DM828_PROTOCOL.md 2.6.3): Call_ID(3) + UTF-16LE text.
+    // The module does not say whether it was a private or a group message.
+    DMRSMSMessage &sms = smsIn;
+    sms.sourceID = bytes3ToUint32(&frame.data[0]);
+    sms.targetID = 0;
+    sms.type = 0;
+    sms.parts = 1;
+    sms.valid = true;
+    
+    // Parts of a segmented message are held until the set is complete
+    if (!reassembleSMS(sms, &frame.data[3], frame.length - 3)) {
         return;
     }
     
-    // DMR828S SMS format analysis based on received data:
-    // Data: 00 00 02 31 00 32 00 33 00
-    // This appears to be: [Header bytes] + UTF-16 message data
+    DMR_TRACE_INFO(TRACE_SMS_RX, sms.sourceID, sms.length);
     
-    DMRSMSMessage sms;
+    if (smsCallback) {
+        smsCallback(sms);
+    }
+    if (hasEventListener(DMR_EVENT_SMS_RECEIVED)) {
+        DMREvent event;
+        event.type = DMR_EVENT_SMS_RECEIVED;
+        event.frame = &frame;
+        event.sms = &sms;
+        event.sourceID = sms.sourceID;
+        notifyEvent(event);
+    }
+}
+
+// Decodes text into sms.message and returns true when it is ready for
+// delivery: a plain SMS, or the last missing part of a segmented one (sms
+// then holds the joined text)
+bool DMR828S::reassembleSMS(DMRSMSMessage &sms, const uint8_t *text, uint16_t length) {
+    // The header is plain ASCII, one UTF-16LE unit per character, and a part
+    // always carries text after it
+    char header[DMR_SMS_SEGMENT_HEADER];
+    bool segmented = length > DMR_SMS_SEGMENT_HEADER * 2;
+    for (uint8_t i = 0; segmented && i < DMR_SMS_SEGMENT_HEADER; i++) {
+        header[i] = text[2 * i];
+        segmented = text[2 * i + 1] == 0x00 && text[2 * i] < 0x80;
+    }
+    int msgId, part, total;
+    uint16_t chunk = length - DMR_SMS_SEGMENT_HEADER * 2;
+    if (!segmented || !parseSMSHeader(header, msgId, part, total) || chunk > DMR_SMS_PART_CHARS * 2) {
+        // Not our header, deliver as written
+        sms.length = dmrUtf16leToUtf8(text, length, sms.message, sizeof(sms.message));
+        return true;
+    }
+    if (total > DMR_SMS_MAX_PARTS) {
+        DMR_TRACE_ERROR(TRACE_SMS_EXPIRED, sms.sourceID, msgId, 0, total);
+        return false;   // Would not fit the reassembly buffer
+    }
     
-    // Determine source ID and message format
-    // Based on the pattern, it looks like:
-    // - First few bytes might be header/control info
-    // - Message is in UTF-16 format (alternating character + 0x00)
+    DMR_TRACE_INFO(TRACE_SMS_PART, sms.sourceID, msgId, part, total);
     
-    if (frame.length >= 3) {
-        // Extract source ID - using the 3rd byte as it seems to contain ID info
-        sms.sourceID = frame.data[2]; // Simple ID from 3rd byte
-        if (utils.debug) {
-            Serial.print("[DEBUG] Extracted Source ID: 0x"); Serial.println(sms.sourceID, HEX);
+    // Find the message this part belongs to, else a free (or the oldest) slot
+    unsigned long now = millis();
+    SMSReassembly *match = nullptr;
+    SMSReassembly *slot = nullptr;
+    SMSReassembly *oldest = &smsRx[0];
+    for (uint8_t i = 0; i < DMR_SMS_REASSEMBLY_SLOTS; i++) {
+        SMSReassembly &r = smsRx[i];
+        if (r.active && r.sourceID == sms.sourceID && r.msgId == msgId && r.total == total) {
+            match = &r;
+            break;
+        }
+        if (!r.active && !slot) {
+            slot = &r;
+        }
+        if (now - r.lastPartAt > now - oldest->lastPartAt) {
+            oldest = &r;
         }
-    } else {
-        sms.sourceID = 0;
     }
-    
-    // Assume Group SMS for now (based on your output showing "Type: Group")
-    sms.type = 2; // Group SMS
-    
-    if (utils.debug) {
-        Serial.print("[DEBUG] SMS Type: "); Serial.println(sms.type == 1 ? "Private" : "Group");
+    if (match) {
+        slot = match;
+    } else if (!slot) {
+        slot = oldest;
+        DMR_TRACE_ERROR(TRACE_SMS_EXPIRED, slot->sourceID, slot->msgId, slot->received, slot->total);
     }
-    
-    // Extract UTF-16 message - look for pattern of char + 0x00
-    sms.length = 0;
-    memset(sms.message, 0, sizeof(sms.message));
-    
-    if (utils.debug) {
-        Serial.println("[DEBUG] Attempting UTF-16 message extraction:");
-    }
-    
-    // Start looking for UTF-16 data (character followed by 0x00)
-    for (int i = 3; i < frame.length - 1 && sms.length < 144; i += 2) {
-        if (frame.data[i] != 0x00 && frame.data[i+1] == 0x00) {
-            // This looks like UTF-16: character + null byte
-            sms.message[sms.length] = frame.data[i];
-            if (utils.debug) {
-                Serial.print("  Found UTF-16 char at [" + String(i) + "]: 0x");
-                if (frame.data[i] < 0x10) Serial.print("0");
-                Serial.print(frame.data[i], HEX);
-                Serial.println(" '" + String((char)frame.data[i]) + "'");
-            }
-            sms.length++;
-        } else if (frame.data[i] != 0x00) {
-            // Non-UTF-16 character, add it anyway
-            sms.message[sms.length] = frame.data[i];
-            if (utils.debug) {
-                Serial.print("  Found regular char at [" + String(i) + "]: 0x");
-                if (frame.data[i] < 0x10) Serial.print("0");
-                Serial.print(frame.data[i], HEX);
-                Serial.println(" '" + String((char)frame.data[i]) + "'");
-            }
-            sms.length++;
-        }
+    if (slot != match) {
+        slot->active = true;
+        slot->sourceID = sms.sourceID;
+        slot->type = sms.type;
+        slot->msgId = msgId;
+        slot->total = total;
+        slot->received = 0;
     }
     
-    sms.message[sms.length] = '\0';
-    sms.valid = true;
-    
-    if (utils.debug) {
-        Serial.print("[DEBUG] Extracted message length: "); Serial.println(sms.length);
-        Serial.print("[DEBUG] Final message: '"); Serial.print(sms.message); Serial.println("'");
-        Serial.println("[DEBUG] Calling SMS callback...");
+    uint16_t bit = 1U << (part - 1);
+    if (!(slot->received & bit)) {
+        memcpy(&slot->text[(part - 1) * DMR_SMS_PART_CHARS * 2], &text[DMR_SMS_SEGMENT_HEADER * 2], chunk);
+        slot->partLength[part - 1] = chunk;
+        slot->received |= bit;
     }
+    slot->lastPartAt = now;
     
-    smsCallback(sms);
+    if (slot->received != (uint16_t)((1UL << total) - 1)) {
+        return false;
+    }
     
-    if (utils.debug) {
-        Serial.println("[DEBUG] SMS callback completed");
-        Serial.println("[DEBUG] ===== SMS PROCESSING DONE =====\n");
+    // Join the parts; senders split on character boundaries, so each decodes alone
+    sms.length = 0;
+    for (uint8_t i = 0; i < total; i++) {
+        sms.length += dmrUtf16leToUtf8(&slot->text[i * DMR_SMS_PART_CHARS * 2], slot->partLength[i],
+                                       &sms.message[sms.length], sizeof(sms.message) - sms.length);
     }
+    sms.type = slot->type;
+    sms.parts = total;
+    slot->active = false;
+    return true;
 }
 
-void DMR828S::processSMSStatusEvent(const DMRFrame &frame) {
-    if (utils.debug) {
-        Serial.println("[DEBUG] ===== SMS STATUS EVENT PROCESSING =====");
-        Serial.print("  Status code: 0x"); Serial.println(frame.sr, HEX);
-        Serial.print("  Target ID: 0x"); Serial.println(lastSMSTargetID, HEX);
-        Serial.print("  SMS status callback set: "); Serial.println(smsStatusCallback ? "YES" : "NO");
-        Serial.print("  Timeout tracking active: "); Serial.println(lastSMSSendTime > 0 ? "YES" : "NO");
-    }
-    
-    if (!smsStatusCallback) {
-        if (utils.debug) {
-            Serial.println("[DEBUG] SMS status callback not set - ignoring status");
+// Drop messages whose missing parts never arrived
+void DMR828S::expireReassembly() {
+    unsigned long now = millis();
+    for (uint8_t i = 0; i < DMR_SMS_REASSEMBLY_SLOTS; i++) {
+        SMSReassembly &r = smsRx[i];
+        if (r.active && now - r.lastPartAt > DMR_SMS_REASSEMBLY_TIMEOUT_MS) {
+            DMR_TRACE_ERROR(TRACE_SMS_EXPIRED, r.sourceID, r.msgId, r.received, r.total);
+            r.active = false;
         }
-        return;
     }
+}
+
+void DMR828S::processSMSStatusEvent(const DMRFrameView &frame) {
+    DMR_TRACE_INFO(TRACE_SMS_STATUS, frame.sr, lastSMSTargetID);
     
-    // Check if timeout already occurred (lastSMSSendTime would be 0)
-    if (lastSMSSendTime == 0) {
-        if (utils.debug) {
-            Serial.println("[DEBUG] SMS timeout already occurred - ignoring late response");
-        }
+    // Check if timeout already occurred (nothing awaiting a result)
+    if (!smsAwaitingResult || smsQueueCount == 0) {
         return;
     }
+    smsAwaitingResult = false;
+    SMSOutbound &msg = smsQueue[smsQueueHead];
     
-    SMSSendStatus status;
     switch (frame.sr) {
         case 0x71:
-            status = SMS_SEND_SUCCESS;
-            if (utils.debug) {
-                Serial.println("[DEBUG] SMS send status: SUCCESS");
+            // Part delivered; a segmented message moves on to its next part
+            msg.sent++;
+            msg.offset += msg.partBytes;
+            msg.attempts = 0;
+            if (msg.sent < msg.total) {
+                msg.retryAt = millis();
+                pumpSMS();
+            } else {
+                finishSMS(SMS_SEND_SUCCESS);
             }
             break;
             
-        case 0x7E:
-            status = SMS_SEND_FAILED;
-            if (utils.debug) {
-                Serial.println("[DEBUG] SMS send status: FAILED");
-            }
+        case RESPONSE_BUSY_FAIL:
+            // Module still busy with something else: hold the queue
+            smsQueueStats.busy++;
+            retrySMSPart(msg);
             break;
             
+        case 0x7E:
         default:
-            if (utils.debug) {
-                Serial.println("[DEBUG] Unknown SMS status code - treating as failed");
-            }
-            status = SMS_SEND_FAILED;
+            // Unknown status codes are treated as failures
+            retrySMSPart(msg);
             break;
     }
-    
-    if (utils.debug) {
-        Serial.println("[DEBUG] Calling SMS status callback...");
+}
+
+// Call state uploads (DM828_PROTOCOL.md 2.6.2). Starts carry type(1) + ID(3);
+// every code also implies a module status, pushed as DMR_EVENT_STATUS.
+void DMR828S::processCallEvent(const DMRFrameView &frame) {
+    DMREvent event;
+    event.frame = &frame;
+    switch (frame.sr) {
+        case 0x60: // Being called starts
+            event.type = DMR_EVENT_CALL_IN_START;
+            event.status = STATUS_RECEIVING;
+            break;
+        case 0x61: // Call-out starts
+            event.type = DMR_EVENT_CALL_OUT_START;
+            event.status = STATUS_TRANSMITTING;
+            break;
+        case 0x62: // Call-out ends
+            event.type = DMR_EVENT_CALL_OUT_END;
+            event.status = STATUS_STANDBY;
+            break;
+        case 0x6D: // Call-out fails
+            event.type = DMR_EVENT_CALL_OUT_FAILED;
+            event.status = STATUS_STANDBY;
+            break;
+        case 0x6F: // Being called ends
+            event.type = DMR_EVENT_CALL_IN_END;
+            event.status = STATUS_STANDBY;
+            break;
+        default:
+            DMR_TRACE_DEBUG(TRACE_FRAME_UNHANDLED, frame.cmd, frame.rw, frame.sr, frame.length);
+            return;
     }
     
-    smsStatusCallback(lastSMSTargetID, status);
+    bool start = event.type == DMR_EVENT_CALL_IN_START || event.type == DMR_EVENT_CALL_OUT_START;
+    if (start && frame.length >= 4) {
+        event.call.type = (DMRCallType)frame.data[0];
+        event.call.contactID = bytes3ToUint32(&frame.data[1]);
+        event.call.active = true;
+        if (event.type == DMR_EVENT_CALL_IN_START) {
+            event.sourceID = event.call.contactID;
+        } else {
+            event.targetID = event.call.contactID;
+        }
+        DMR_TRACE_INFO(TRACE_CALL_EVENT, frame.sr, event.call.type, event.call.contactID);
+    } else {
+        DMR_TRACE_INFO(TRACE_CALL_EVENT, frame.sr);
+    }
     
-    // Reset timeout tracking to prevent duplicate timeout callbacks
-    lastSMSSendTime = 0;
+    // Legacy single callbacks first
+    if (event.type == DMR_EVENT_CALL_IN_START && event.call.active && callCallback) {
+        callCallback(event.call);
+    } else if (event.type == DMR_EVENT_CALL_IN_END && callEndCallback) {
+        callEndCallback();
+    }
     
-    if (utils.debug) {
-        Serial.println("[DEBUG] SMS status callback completed");
-        Serial.println("[DEBUG] Timeout tracking reset to prevent duplicates");
-        Serial.println("[DEBUG] ===== SMS STATUS PROCESSING DONE =====\n");
+    if (!start || event.call.active) {
+        notifyEvent(event);
     }
+    DMREvent status;
+    status.type = DMR_EVENT_STATUS;
+    status.frame = &frame;
+    status.status = event.status;
+    notifyEvent(status);
 }
 
-void DMR828S::processCallEvent(const DMRFrame &frame) {
-    if (frame.sr == 0x60) { // Being called starts
-        if (callCallback && frame.length >= 4) {
-            DMRCallInfo callInfo;
-            callInfo.type = (DMRCallType)frame.data[0];
-            callInfo.contactID = bytes3ToUint32(&frame.data[1]);
-            callInfo.active = true;
-            callCallback(callInfo);
-        }
-    } else if (frame.sr == 0x6F) { // Being called ends
-        if (callEndCallback) {
-            callEndCallback();
-        }
+void DMR828S::processEmergencyEvent(const DMRFrameView &frame) {
+    if (frame.length < 3) {
+        return;
     }
-}
-
-void DMR828S::processEmergencyEvent(const DMRFrame &frame) {
-    if (emergencyCallback && frame.length >= 3) {
-        uint32_t sourceID = bytes3ToUint32(frame.data);
+    uint32_t sourceID = bytes3ToUint32(frame.data);
+    DMR_TRACE_INFO(TRACE_EMERGENCY, sourceID);
+    if (emergencyCallback) {
         emergencyCallback(sourceID);
     }
+    if (hasEventListener(DMR_EVENT_EMERGENCY)) {
+        DMREvent event;
+        event.type = DMR_EVENT_EMERGENCY;
+        event.frame = &frame;
+        event.sourceID = sourceID;
+        notifyEvent(event);
+    }
 }
 
 /********************************************************
  * INTERNAL HELPER FUNCTIONS
  ********************************************************/
 
-bool DMR828S::sendCommand(uint8_t cmd, uint8_t rw, uint8_t sr, const uint8_t *data, uint16_t len) {
-    return utils.sendFrame(cmd, rw, sr, data, len);
+bool DMR828S::sendCommand(uint8_t cmd, uint8_t rw, uint8_t sr, const uint8_t *data, uint16_t len,
+                          bool flush) {
+    return utils.sendFrame(cmd, rw, sr, data, len, flush);
 }
 
-bool DMR828S::waitForResponse(DMRFrame &frame, uint32_t timeout_ms) {
-    uint32_t startTime = millis();
+// Blocking query (0x01 read) on top of the pending-request table. update()
+// keeps running while we wait, so unsolicited frames still reach the event
+// callbacks. An async request already outstanding for the same command
+// (the link sampler's 0x04/0x05) is let finish first, then ours goes out.
+// The request is registered before it is sent, so a fast response cannot
+// arrive unclaimed.
+bool DMR828S::query(uint8_t cmd, DMRFrame &frame, uint32_t timeout_ms) {
+    // From inside update() (a listener or callback) nothing can be read
+    // without overwriting the frame the caller is still looking at
+    if (updating) {
+        DMR_TRACE_ERROR(TRACE_QUERY_REJECTED, cmd, QUERY_IN_UPDATE);
+        return false;
+    }
     
-    while (millis() - startTime < timeout_ms) {
-        if (utils.readFrame(frame)) {
-            if (frame.valid && frame.rw == 0x00) { // Response frame
-                return true;
-            }
+    unsigned long start = millis();
+    while (findPending(cmd) >= 0) {
+        if (millis() - start >= timeout_ms) {
+            DMR_TRACE_ERROR(TRACE_QUERY_REJECTED, cmd, QUERY_STILL_PENDING);
+            return false;
+        }
+        update();
+        if (findPending(cmd) >= 0) {
+            utils.waitForRx(1);
+        }
+    }
+    
+    BlockingResponse result;
+    result.frame = &frame;
+    uint8_t data = 0x01;
+    if (!sendRequest(cmd, &data, 1, onBlockingResponse, &result, timeout_ms)) {
+        DMR_TRACE_ERROR(TRACE_QUERY_REJECTED, cmd, QUERY_NOT_SENT);
+        return false;
+    }
+    
+    while (!result.done) {
+        update();
+        if (!result.done) {
+            utils.waitForRx(1);
+        }
+    }
+    return result.ok;
+}
+
+void DMR828S::onBlockingResponse(bool ok, const DMRFrameView &response, void *context) {
+    BlockingResponse *result = (BlockingResponse *)context;
+    result->done = true;
+    result->ok = ok;
+    if (ok) {
+        result->frame->cmd = response.cmd;
+        result->frame->rw = response.rw;
+        result->frame->sr = response.sr;
+        result->frame->checksum = response.checksum;
+        result->frame->length = response.length;
+        result->frame->valid = response.valid;
+        memcpy(result->frame->data, response.data, response.length);
+    }
+}
+
+int DMR828S::findPending(uint8_t cmd) const {
+    for (int i = 0; i < DMR_MAX_PENDING_REQUESTS; i++) {
+        if (pending[i].active && pending[i].cmd == cmd) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool DMR828S::addPending(uint8_t cmd, ResponseCallback callback, void *context, uint32_t timeout_ms) {
+    // One outstanding request per command byte, otherwise responses are ambiguous
+    if (findPending(cmd) >= 0) {
+        return false;
+    }
+    for (int i = 0; i < DMR_MAX_PENDING_REQUESTS; i++) {
+        if (!pending[i].active) {
+            pending[i].cmd = cmd;
+            pending[i].active = true;
+            pending[i].sentAt = millis();
+            pending[i].timeout = timeout_ms;
+            pending[i].callback = callback;
+            pending[i].context = context;
+            return true;
         }
-        delay(1);
     }
     return false;
 }
 
+bool DMR828S::completePending(const DMRFrameView &frame) {
+    int slot = findPending(frame.cmd);
+    if (slot < 0) {
+        return false;
+    }
+    
+    // Free the slot first so the callback may issue a follow-up request
+    DMRPendingRequest req = pending[slot];
+    pending[slot].active = false;
+    if (req.callback) {
+        req.callback(true, frame, req.context);
+    }
+    return true;
+}
+
+void DMR828S::expirePending() {
+    unsigned long now = millis();
+    for (int i = 0; i < DMR_MAX_PENDING_REQUESTS; i++) {
+        if (pending[i].active && now - pending[i].sentAt >= pending[i].timeout) {
+            DMRPendingRequest req = pending[i];
+            pending[i].active = false;
+            
+            DMR_TRACE_ERROR(TRACE_REQUEST_TIMEOUT, req.cmd, req.timeout);
+            
+            DMRFrameView timedOut;
+            timedOut.cmd = req.cmd;
+            if (req.callback) {
+                req.callback(false, timedOut, req.context);
+            }
+        }
+    }
+}
+
 bool DMR828S::sendSimpleCommand(uint8_t cmd) {
     uint8_t data = 0x01;
     return sendCommand(cmd, 0x01, 0x01, &data, 1);
@@ -746,20 +1571,7 @@ bool DMR828S::sendSimpleCommand(uint8_t cmd) {
  ********************************************************/
 
 uint32_t DMR828S::bytes3ToUint32(const uint8_t *bytes) {
-    uint32_t result = ((uint32_t)bytes[0] << 16) | ((uint32_t)bytes[1] << 8) | (uint32_t)bytes[2];
-    
-    if (utils.debug) {
-        Serial.println("[DEBUG] bytes3ToUint32 conversion:");
-        Serial.print("  Input bytes: 0x");
-        if (bytes[0] < 0x10) Serial.print("0"); Serial.print(bytes[0], HEX);
-        Serial.print(" 0x");
-        if (bytes[1] < 0x10) Serial.print("0"); Serial.print(bytes[1], HEX);
-        Serial.print(" 0x");
-        if (bytes[2] < 0x10) Serial.print("0"); Serial.println(bytes[2], HEX);
-        Serial.print("  Result: 0x"); Serial.println(result, HEX);
-    }
-    
-    return result;
+    return ((uint32_t)bytes[0] << 16) | ((uint32_t)bytes[1] << 8) | (uint32_t)bytes[2];
 }
 
 void DMR828S::uint32ToBytes3(uint32_t value, uint8_t *bytes) {
@@ -786,21 +1598,10 @@ bool DMR828S::sendRawCommand(const uint8_t *rawData, uint16_t length) {
     }
     
     // Send raw bytes directly to the serial port
-    for (uint16_t i = 0; i < length; i++) {
-        utils.getSerial()->write(rawData[i]);
-    }
+    utils.getSerial()->write(rawData, length);
     
-    if (utils.debug) {
-        Serial.print("🔧 Raw command sent (");
-        Serial.print(length);
-        Serial.print(" bytes): ");
-        for (uint16_t i = 0; i < length; i++) {
-            if (rawData[i] < 0x10) Serial.print("0");
-            Serial.print(rawData[i], HEX);
-            Serial.print(" ");
-        }
-        Serial.println();
-    }
+    DMR_TRACE_INFO(TRACE_RAW_TX, length);
+    utils.printHexPacket("RAW →", rawData, length);
     
     return true;
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include "DMR828S_utils.h"
+#include "DMR828S_text.h"
 
 // DMR828S Command Definitions
 #define DMR_CMD_SET_CHANNEL         0x01
@@ -67,13 +68,66 @@ enum SMSSendStatus {
     SMS_SEND_TIMEOUT = 0xFF
 };
 
+// SMS segmentation
+// One module SMS carries 72 UTF-16 units (144 bytes). Longer texts go out as
+// numbered parts, each starting with a 5-character header:
+//   '~' <message id> <part> <total> '|'     (upper-case base36, part is 1-based)
+// leaving DMR_SMS_PART_CHARS units of text per part. Only an exact header with
+// 2-16 parts, part <= total and text after it is read as one; anything else
+// is delivered as written, and a short text that would pass goes out as two
+// parts so it cannot be misread. Parts split on
+// character boundaries. DMR_SMS_MAX_UNITS is the longest text in UTF-16
+// units; DMR_SMS_MAX_TEXT is its worst case in UTF-8 bytes (a unit takes up
+// to three, a surrogate pair four).
+#define DMR_SMS_MAX_CHARS           72
+#define DMR_SMS_SEGMENT_MARK        '~'
+#define DMR_SMS_SEGMENT_SEP         '|'
+#define DMR_SMS_SEGMENT_HEADER      5
+#define DMR_SMS_PART_CHARS          (DMR_SMS_MAX_CHARS - DMR_SMS_SEGMENT_HEADER)
+#ifndef DMR_SMS_MAX_PARTS
+#define DMR_SMS_MAX_PARTS           8
+#endif
+#define DMR_SMS_MAX_UNITS           (DMR_SMS_MAX_PARTS * DMR_SMS_PART_CHARS)
+#define DMR_SMS_MAX_TEXT            (DMR_SMS_MAX_UNITS * 3)
+static_assert(DMR_SMS_MAX_PARTS >= 1 && DMR_SMS_MAX_PARTS <= 16, "part bitmask is 16 bits");
+
+// Outbound SMS queue
+#ifndef DMR_SMS_QUEUE_DEPTH
+#define DMR_SMS_QUEUE_DEPTH         4
+#endif
+#define DMR_SMS_DEFAULT_RETRIES     2       // Resends of a part after busy/0x7E
+#define DMR_SMS_DEFAULT_BACKOFF_MS  1000    // Doubles with every retry of the same part
+#define DMR_SMS_RESULT_TIMEOUT_MS   60000   // No 0x71/0x7E for a part
+
+typedef uint16_t DMRSMSHandle;              // 0 = not queued
+#define DMR_SMS_INVALID_HANDLE      0
+
+// Outbound SMS counters since boot
+struct DMRSMSQueueStats {
+    uint32_t queued = 0;
+    uint32_t delivered = 0;     // Messages with every part acked 0x71
+    uint32_t failed = 0;        // Out of retries or timed out
+    uint32_t rejected = 0;      // Queue full or text too long
+    uint32_t partsSent = 0;     // Module SMS frames written, retries included
+    uint32_t retries = 0;
+    uint32_t busy = 0;          // Parts answered RESPONSE_BUSY_FAIL
+};
+// Messages being reassembled at once, and how long one may sit incomplete
+#ifndef DMR_SMS_REASSEMBLY_SLOTS
+#define DMR_SMS_REASSEMBLY_SLOTS    2
+#endif
+#ifndef DMR_SMS_REASSEMBLY_TIMEOUT_MS
+#define DMR_SMS_REASSEMBLY_TIMEOUT_MS 90000
+#endif
+
 // SMS Structure
 struct DMRSMSMessage {
-    uint8_t type;           // Private/Group SMS
+    uint8_t type;           // Private/Group SMS (0 = not reported by the module)
     uint32_t sourceID;      // 3-byte source ID
     uint32_t targetID;      // 3-byte target ID  
-    uint8_t length;         // Message length
-    char message[144];      // SMS content (max 144 chars)
+    uint16_t length;        // Message length in UTF-8 bytes
+    uint8_t parts;          // Segments it arrived in (1 = plain SMS)
+    char message[DMR_SMS_MAX_TEXT + 1]; // SMS content, UTF-8, reassembled
     bool valid;
 };
 
@@ -97,10 +151,97 @@ struct DMRChannelParams {
     bool encryptionOn;      // Encryption status
 };
 
+// Maximum number of queries awaiting a response at once
+#ifndef DMR_MAX_PENDING_REQUESTS
+#define DMR_MAX_PENDING_REQUESTS    8
+#endif
+
+// Config transaction limits
+#ifndef DMR_CONFIG_MAX_WRITES
+#define DMR_CONFIG_MAX_WRITES       16
+#endif
+#define DMR_CONFIG_MAX_DATA         9       // Largest setting payload (encryption on + key)
+#define DMR_CONFIG_DEFAULT_WINDOW   4
+#define DMR_CONFIG_MAX_RETRIES      2
+#define DMR_CONFIG_ACK_TIMEOUT_MS   500
+#define DMR_CONFIG_RETRY_BACKOFF_MS 50
+
+// Aggregate result of a config transaction
+struct DMRConfigResult {
+    uint8_t total = 0;          // Writes in the transaction
+    uint8_t acked = 0;          // Writes acknowledged with RESPONSE_OK
+    uint8_t failed = 0;         // Writes that ran out of retries or hit a channel error
+    uint8_t retries = 0;        // Resends across all writes
+    uint8_t failedCmds[DMR_CONFIG_MAX_WRITES];
+    uint32_t elapsedMs = 0;     // commit to last ack
+    bool success = false;
+};
+
+// Event subscriptions
+#ifndef DMR_MAX_LISTENERS
+#define DMR_MAX_LISTENERS           16
+#endif
+typedef uint8_t DMRSubscription;            // 0 = not subscribed
+#define DMR_INVALID_SUBSCRIPTION    0
+
+// Typed events decoded once from module frames
+enum DMREventType : uint8_t {
+    DMR_EVENT_SMS_RECEIVED = 0,     // sms: complete (reassembled) message
+    DMR_EVENT_SMS_SENT,             // handle, targetID, smsStatus (once per message)
+    DMR_EVENT_CALL_IN_START,        // 0x60, call
+    DMR_EVENT_CALL_OUT_START,       // 0x61, call
+    DMR_EVENT_CALL_OUT_END,         // 0x62
+    DMR_EVENT_CALL_OUT_FAILED,      // 0x6D
+    DMR_EVENT_CALL_IN_END,          // 0x6F
+    DMR_EVENT_EMERGENCY,            // 0x91, sourceID
+    DMR_EVENT_STATUS,               // status, pushed with every call state upload
+    DMR_EVENT_COUNT
+};
+
+struct DMREvent {
+    DMREventType type;
+    const DMRFrameView *frame = nullptr;    // Frame it came from (null for timeouts)
+    const DMRSMSMessage *sms = nullptr;
+    DMRCallInfo call = {CALL_ANALOG, 0, false};
+    uint32_t sourceID = 0;
+    uint32_t targetID = 0;
+    DMRSMSHandle handle = DMR_SMS_INVALID_HANDLE;
+    SMSSendStatus smsStatus = SMS_SEND_SUCCESS;
+    DMRModuleStatus status = STATUS_STANDBY;
+};
+
+// Shadow registers: module settings as last acked or read back. Getters
+// answer from here unless asked to refresh, so they do not block on the UART.
+enum DMRShadowField : uint8_t {
+    SHADOW_CHANNEL = 0,
+    SHADOW_VOLUME,
+    SHADOW_RADIO_ID,
+    SHADOW_CONTACT_ID,
+    SHADOW_COLOR_CODE,
+    SHADOW_TIME_SLOT,
+    SHADOW_TX_POWER,
+    SHADOW_BANDWIDTH,
+    SHADOW_ENCRYPTION,
+    SHADOW_TX_FREQ,
+    SHADOW_RX_FREQ,
+    DMR_SHADOW_COUNT
+};
+static_assert(DMR_SHADOW_COUNT <= 16, "shadow masks are 16 bits");
+#define DMR_SHADOW_NEVER            0xFFFFFFFFUL    // Age of a field that is not cached
+
+// Why a blocking getter gave up without asking the module, traced as
+// TRACE_QUERY_REJECTED (a query that was sent and timed out is TRACE_REQUEST_TIMEOUT)
+enum DMRQueryReject : uint8_t {
+    QUERY_IN_UPDATE = 0,                // Called from a listener or callback
+    QUERY_STILL_PENDING,                // An async request for the command outlived the timeout
+    QUERY_NOT_SENT                      // Pending table full or UART write failed
+};
+
 // High-level DMR828S Walkie-Talkie API
 class DMR828S {
 public:
     DMR828S(HardwareSerial &port);
+    DMR828S(Stream &port);
     
     // Basic Setup
     void begin(uint32_t baud = 57600);
@@ -113,6 +254,8 @@ public:
     // 🔵 1. CORE RADIO OPERATION
     bool setChannel(uint8_t channel);                    // 0x01
     bool setVolume(uint8_t volume);                      // 0x02 (1-9)
+    uint8_t getChannel(bool refresh = false);            // Cached, else 0x1D
+    uint8_t getVolume();                                 // Cached only (no query), 0 if unknown
     DMRModuleStatus getModuleStatus();                   // 0x04
     uint8_t getRSSI();                                   // 0x05
     
@@ -122,6 +265,10 @@ public:
     bool getCallInContact(DMRCallInfo &callInfo);        // 0x10
     
     // 🟣 3. SMS MESSAGING
+    // UTF-8 text. Over 72 UTF-16 units it is split into parts (up to
+    // DMR_SMS_MAX_UNITS units);
+    // the status callback fires once for the whole message. Goes through the
+    // outbound queue below; false if it is full
     bool sendSMS(uint32_t targetID, const char* message, bool isGroup = false); // 0x07
     bool getLastSMS(DMRSMSMessage &sms);                 // 0x11
     
@@ -144,10 +291,13 @@ public:
     
     // 🟤 7. IDs & COLOR CODE SETUP
     bool setRadioID(uint32_t radioID);                   // 0x1B
-    uint32_t getRadioID();                               // 0x24
-    uint32_t getContactID();                             // 0x22
+    uint32_t getRadioID(bool refresh = false);           // 0x24
+    uint32_t getContactID(bool refresh = false);         // 0x22
     bool setColorCode(uint8_t colorCode);                // 0x31
     bool setTimeSlot(uint8_t timeSlot);                  // 0x33
+    uint8_t getColorCode(bool refresh = false);          // Cached, else 0x1D
+    uint8_t getTimeSlot(bool refresh = false);           // Cached, else 0x1D
+    uint8_t getTXPower(bool refresh = false);            // Cached, else 0x1D
     
     // 🟣 8. RX GROUP LISTS
     bool addContactToRXGroup(uint8_t groupIndex, uint32_t contactID); // 0x29
@@ -155,8 +305,8 @@ public:
     
     // ⚪ 9. DIAGNOSTICS
     String getFirmwareVersion();                         // 0x25
-    bool getEncryptionStatus();                          // 0x28
-    bool getCurrentChannelParams(DMRChannelParams &params); // 0x1D
+    bool getEncryptionStatus(bool refresh = false);      // 0x28
+    bool getCurrentChannelParams(DMRChannelParams &params, bool refresh = false); // 0x1D
     bool getInitializationStatus();                      // 0x1A
     
     // 🟤 10. SYSTEM
@@ -167,6 +317,48 @@ public:
     bool setBandwidth(uint8_t bandwidth);                // 0x32
     bool setToneOnOff(bool enable);                      // 0x1C
     
+    // ASYNC QUERIES - responses are matched by command byte inside update()
+    // ok=false means no response arrived within the timeout (response.length is 0)
+    typedef void (*ResponseCallback)(bool ok, const DMRFrameView &response, void *context);
+    
+    bool sendRequest(uint8_t cmd, const uint8_t *data, uint16_t len,
+                     ResponseCallback callback, void *context = nullptr,
+                     uint32_t timeout_ms = 1000);
+    bool requestModuleStatus(ResponseCallback callback, void *context = nullptr);  // 0x04
+    bool requestRSSI(ResponseCallback callback, void *context = nullptr);          // 0x05
+    bool requestRadioID(ResponseCallback callback, void *context = nullptr);       // 0x24
+    bool requestChannelParams(ResponseCallback callback, void *context = nullptr); // 0x1D
+    bool isRequestPending(uint8_t cmd) const;
+    void cancelRequest(uint8_t cmd);
+    bool parseChannelParams(const uint8_t *data, uint16_t length, DMRChannelParams &params);
+    
+    // CONFIG TRANSACTIONS - setters called between beginConfig() and commit
+    // are queued, then streamed with a bounded in-flight window. Each write is
+    // matched to its ack and retried on timeout/busy.
+    typedef void (*ConfigDoneCallback)(const DMRConfigResult &result, void *context);
+    
+    void beginConfig();
+    bool commitConfig(DMRConfigResult &result);                       // Blocking, keeps update() running
+    bool commitConfigAsync(ConfigDoneCallback callback, void *context = nullptr);
+    void abortConfig();
+    void setConfigWindow(uint8_t window);
+    bool isConfigRunning() const { return configState == CONFIG_RUNNING; }
+    
+    // SMS QUEUE - messages go out FIFO, one on air at a time (the module's
+    // 0x71/0x7E result carries no ID). A part answered busy or 0x7E is resent
+    // after a doubling backoff that holds the whole queue.
+    typedef void (*SMSMessageCallback)(DMRSMSHandle handle, uint32_t targetID, SMSSendStatus status,
+                                       void *context);
+    
+    DMRSMSHandle queueSMS(uint32_t targetID, const char *message, bool isGroup = false,
+                          SMSMessageCallback callback = nullptr, void *context = nullptr);
+    bool cancelSMS(DMRSMSHandle handle);                // Not yet on air; no callback
+    bool isSMSQueued(DMRSMSHandle handle) const;
+    uint8_t getSMSQueueLength() const { return smsQueueCount; }
+    bool isSMSSending() const { return smsAwaitingResult; }
+    void setSMSRetry(uint8_t maxRetries, uint32_t backoffMs);
+    const DMRSMSQueueStats& getSMSQueueStats() const { return smsQueueStats; }
+    
     // EVENT HANDLING
     typedef void (*SMSReceivedCallback)(const DMRSMSMessage &sms);
     typedef void (*SMSSendStatusCallback)(uint32_t targetID, SMSSendStatus status);
@@ -180,9 +372,38 @@ public:
     void setCallEndedCallback(CallEndedCallback callback) { callEndCallback = callback; }
     void setEmergencyCallback(EmergencyCallback callback) { emergencyCallback = callback; }
     
-    // Call this in your main loop to handle incoming events
+    // SHADOW REGISTERS - filled by acked writes and by query responses
+    // (blocking or async), dropped on a module reset or restart, a failed
+    // write, a change the module uploads itself or, for the per-channel
+    // fields, a channel change. maxAgeMs > 0 makes older entries count as
+    // missing.
+    bool getCached(DMRShadowField field, uint32_t &value) const;
+    uint32_t getCacheAge(DMRShadowField field) const;   // ms, DMR_SHADOW_NEVER if not cached
+    void invalidateCache();
+    void invalidateCache(DMRShadowField field);
+    void setCacheMaxAge(uint32_t maxAgeMs) { shadowMaxAge = maxAgeMs; }
+    
+    // SUBSCRIPTIONS - any number of listeners per command byte or event type,
+    // each with its own context. Lookup is a table index, so dispatch cost only
+    // grows with the listeners of that frame. Listeners run inside update().
+    typedef void (*FrameListener)(const DMRFrameView &frame, void *context);
+    typedef void (*EventListener)(const DMREvent &event, void *context);
+    
+    DMRSubscription subscribeFrame(uint8_t cmd, FrameListener listener, void *context = nullptr);
+    DMRSubscription subscribeAllFrames(FrameListener listener, void *context = nullptr);
+    DMRSubscription subscribeEvent(DMREventType type, EventListener listener, void *context = nullptr);
+    bool unsubscribe(DMRSubscription subscription);
+    
+    // Call this in your main loop to handle incoming events. A call from a
+    // listener or callback returns at once, and so do the blocking getters
+    // (they return their default and trace TRACE_QUERY_REJECTED): use the
+    // async requests from there.
     void update();
     
+    // Dispatch one already-parsed frame exactly as update() does
+    // (custom transports, replay and benchmarks)
+    void handleFrame(const DMRFrameView &frame);
+    
     // RAW COMMAND SUPPORT - Advanced users only
     bool sendRawCommand(const uint8_t *rawData, uint16_t length);
     
@@ -199,12 +420,159 @@ private:
     // SMS tracking for status callbacks
     uint32_t lastSMSTargetID = 0;
     unsigned long lastSMSSendTime = 0;
+    bool smsAwaitingResult = false;   // A frame is on air, 0x71/0x7E pending
     uint32_t lastSMSTimeout = 10000;  // Dynamic timeout in milliseconds
     
+    // Outbound SMS queue (ring). The head is the message on air; a long one
+    // sends its next part when the module reports 0x71 for the previous one
+    struct SMSOutbound {
+        DMRSMSHandle handle;
+        uint32_t targetID;
+        bool isGroup;
+        bool segmented;
+        uint8_t msgId;
+        uint8_t total;
+        uint8_t sent;                   // Parts acked
+        uint16_t offset;                // Text bytes in acked parts
+        uint16_t partBytes;             // Text bytes in the part on air
+        uint16_t firstPartBytes;        // Text bytes in part 1 when forced, 0 to fill it
+        uint8_t attempts;               // Sends of the current part
+        unsigned long retryAt;
+        SMSMessageCallback callback;
+        void *context;
+        uint16_t length;
+        char text[DMR_SMS_MAX_TEXT];
+    };
+    SMSOutbound smsQueue[DMR_SMS_QUEUE_DEPTH];
+    uint8_t smsQueueHead = 0;
+    uint8_t smsQueueCount = 0;
+    DMRSMSHandle smsNextHandle = 1;
+    uint8_t smsTxSeq = 0;
+    uint8_t smsMaxRetries = DMR_SMS_DEFAULT_RETRIES;
+    uint32_t smsBackoffMs = DMR_SMS_DEFAULT_BACKOFF_MS;
+    DMRSMSQueueStats smsQueueStats;
+    
+    // Multi-part SMS being received, keyed by (source, message id)
+    struct SMSReassembly {
+        bool active = false;
+        uint32_t sourceID = 0;
+        uint8_t type = 0;
+        uint8_t msgId = 0;
+        uint8_t total = 0;
+        uint16_t received = 0;          // Bit per part
+        unsigned long lastPartAt = 0;
+        uint8_t partLength[DMR_SMS_MAX_PARTS];      // UTF-16LE bytes
+        uint8_t text[DMR_SMS_MAX_PARTS * DMR_SMS_PART_CHARS * 2];
+    };
+    SMSReassembly smsRx[DMR_SMS_REASSEMBLY_SLOTS];
+    DMRSMSMessage smsIn;                // Delivered message; too big for the task stack
+    
+    // Shadow registers; writes are staged until the module acks them
+    uint32_t shadow[DMR_SHADOW_COUNT] = {};
+    uint32_t shadowStaged[DMR_SHADOW_COUNT] = {};
+    unsigned long shadowAt[DMR_SHADOW_COUNT] = {};
+    uint16_t shadowValid = 0;
+    uint16_t shadowStagedMask = 0;
+    uint32_t shadowMaxAge = 0;
+    
+    // Subscription pool; per-key singly linked lists of pool indexes
+    static const uint8_t NO_LISTENER = 0xFF;
+    struct Listener {
+        bool active = false;
+        uint8_t next = NO_LISTENER;
+        uint8_t *head = nullptr;            // List it is linked into
+        FrameListener frameListener = nullptr;
+        EventListener eventListener = nullptr;
+        void *context = nullptr;
+    };
+    Listener listeners[DMR_MAX_LISTENERS];
+    uint8_t frameHead[256];
+    uint8_t anyFrameHead = NO_LISTENER;
+    uint8_t eventHead[DMR_EVENT_COUNT];
+    
+    // Pending request table
+    struct DMRPendingRequest {
+        uint8_t cmd = 0;
+        bool active = false;
+        unsigned long sentAt = 0;
+        uint32_t timeout = 0;
+        ResponseCallback callback = nullptr;
+        void *context = nullptr;
+    };
+    DMRPendingRequest pending[DMR_MAX_PENDING_REQUESTS];
+    bool updating = false;                  // Inside update(): frames in hand point into the rx buffer
+    
+    // Config transaction state
+    enum ConfigState { CONFIG_IDLE, CONFIG_RECORDING, CONFIG_RUNNING };
+    enum ConfigWriteState { CONFIG_WRITE_QUEUED, CONFIG_WRITE_IN_FLIGHT, CONFIG_WRITE_ACKED, CONFIG_WRITE_FAILED };
+    struct ConfigWrite {
+        uint8_t cmd;
+        uint8_t data[DMR_CONFIG_MAX_DATA];
+        uint8_t length;
+        uint8_t attempts;
+        ConfigWriteState state;
+        DMRResponseStatus lastStatus;
+        unsigned long retryAt;
+    };
+    struct BlockingConfig {
+        DMRConfigResult *result = nullptr;
+        bool done = false;
+    };
+    ConfigWrite configWrites[DMR_CONFIG_MAX_WRITES];
+    uint8_t configCount = 0;
+    uint8_t configWindow = DMR_CONFIG_DEFAULT_WINDOW;
+    ConfigState configState = CONFIG_IDLE;
+    unsigned long configStartTime = 0;
+    DMRConfigResult configResult;
+    ConfigDoneCallback configCallback = nullptr;
+    void *configContext = nullptr;
+    
+    // Result slot used by the blocking getters
+    struct BlockingResponse {
+        DMRFrame *frame = nullptr;
+        bool done = false;
+        bool ok = false;
+    };
+    
     // Internal helper functions
-    bool sendCommand(uint8_t cmd, uint8_t rw, uint8_t sr, const uint8_t *data = nullptr, uint16_t len = 0);
-    bool waitForResponse(DMRFrame &frame, uint32_t timeout_ms = 1000);
+    bool sendCommand(uint8_t cmd, uint8_t rw, uint8_t sr, const uint8_t *data = nullptr, uint16_t len = 0,
+                     bool flush = true);
+    
+    // Fixed-command send: header and checksum come from a compile-time template
+    template <uint8_t CMD, uint8_t SR = 0x01>
+    bool sendCommand(const uint8_t *data, uint16_t len) {
+        return utils.sendFrame<CMD, 0x01, SR>(data, len);
+    }
+    
+    // Configuration writes go through here so an open transaction can capture
+    // them. Only a write that was sent or queued is staged: nothing else
+    // would ever ack it.
+    template <uint8_t CMD>
+    bool sendSetting(const uint8_t *data, uint16_t len) {
+        bool sent = configState == CONFIG_RECORDING ? queueConfigWrite(CMD, data, len)
+                                                    : sendCommand<CMD>(data, len);
+        if (sent) {
+            stageShadow(CMD, data, len);
+        }
+        return sent;
+    }
+    bool query(uint8_t cmd, DMRFrame &frame, uint32_t timeout_ms = 1000);
+    static void onBlockingResponse(bool ok, const DMRFrameView &response, void *context);
+    int findPending(uint8_t cmd) const;
+    bool addPending(uint8_t cmd, ResponseCallback callback, void *context, uint32_t timeout_ms);
+    bool completePending(const DMRFrameView &frame);
+    void expirePending();
     bool sendSimpleCommand(uint8_t cmd);
+    static uint16_t shadowFields(uint8_t cmd);
+    void stageShadow(uint8_t cmd, const uint8_t *data, uint16_t len);
+    void updateShadow(const DMRFrameView &frame);
+    void setShadow(DMRShadowField field, uint32_t value);
+    uint32_t channelShadow(DMRShadowField field, bool refresh);
+    bool queueConfigWrite(uint8_t cmd, const uint8_t *data, uint16_t len);
+    void pumpConfig();
+    void handleConfigAck(bool ok, const DMRFrameView &response);
+    static void onConfigAck(bool ok, const DMRFrameView &response, void *context);
+    static void onBlockingConfig(const DMRConfigResult &result, void *context);
     
     // Data conversion utilities
     uint32_t bytes3ToUint32(const uint8_t *bytes);
@@ -213,9 +581,21 @@ private:
     void uint32ToBytes4(uint32_t value, uint8_t *bytes);
     
     // Event processing
-    void processIncomingFrame(const DMRFrame &frame);
-    void processSMSEvent(const DMRFrame &frame);
-    void processSMSStatusEvent(const DMRFrame &frame);
-    void processCallEvent(const DMRFrame &frame);
-    void processEmergencyEvent(const DMRFrame &frame);
+    void processIncomingFrame(const DMRFrameView &frame);
+    void processSMSEvent(const DMRFrameView &frame);
+    void processSMSStatusEvent(const DMRFrameView &frame);
+    bool sendSMSFrame(uint32_t targetID, const uint8_t *text, uint16_t length, bool isGroup);
+    bool sendSMSPart(SMSOutbound &msg);
+    void pumpSMS();
+    void retrySMSPart(SMSOutbound &msg);
+    void finishSMS(SMSSendStatus status);
+    bool reassembleSMS(DMRSMSMessage &sms, const uint8_t *text, uint16_t length);
+    void expireReassembly();
+    void processCallEvent(const DMRFrameView &frame);
+    void processEmergencyEvent(const DMRFrameView &frame);
+    DMRSubscription addListener(uint8_t &head, FrameListener frameListener,
+                                EventListener eventListener, void *context);
+    void notifyFrame(uint8_t head, const DMRFrameView &frame);
+    void notifyEvent(const DMREvent &event);
+    bool hasEventListener(DMREventType type) const { return eventHead[type] != NO_LISTENER; }
 };
\ No newline at end of file
@@ -0,0 +1,233 @@
+#include "DMR828S_hop.h"
+
+DMRHopScheduler::DMRHopScheduler(DMR828S &dmr) : dmr(dmr) {
+}
+
+bool DMRHopScheduler::setFrequencies(uint32_t baseHz, uint32_t spacingHz, uint8_t count) {
+    if (count == 0 || count > DMR_HOP_MAX_FREQUENCIES) {
+        return false;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        frequencies[i] = baseHz + (uint32_t)i * spacingHz;
+    }
+    this->count = count;
+    return true;
+}
+
+bool DMRHopScheduler::setFrequencies(const uint32_t *frequencies, uint8_t count) {
+    if (count == 0 || count > DMR_HOP_MAX_FREQUENCIES) {
+        return false;
+    }
+    memcpy(this->frequencies, frequencies, count * sizeof(uint32_t));
+    this->count = count;
+    return true;
+}
+
+/********************************************************
+ * CLOCK
+ ********************************************************/
+
+void DMRHopScheduler::setTime(uint64_t utcMs, unsigned long atMillis) {
+    syncUtcMs = utcMs;
+    syncMillis = atMillis;
+    timeSet = true;
+}
+
+bool DMRHopScheduler::getTime(uint64_t &utcMs) const {
+    if (!timeSet) {
+        return false;
+    }
+    unsigned long elapsed = millis() - syncMillis;
+    if (elapsed > DMR_HOP_HOLDOVER_MS) {
+        return false;
+    }
+    utcMs = syncUtcMs + elapsed;
+    return true;
+}
+
+bool DMRHopScheduler::isSynced() const {
+    uint64_t utcMs;
+    return getTime(utcMs);
+}
+
+/********************************************************
+ * SCHEDULE
+ ********************************************************/
+
+// 32-bit integer finaliser (good avalanche, no state)
+static uint32_t hopMix(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7FEB352DUL;
+    x ^= x >> 15;
+    x *= 0x846CA68BUL;
+    x ^= x >> 16;
+    return x;
+}
+
+uint32_t DMRHopScheduler::frequencyForSlot(uint64_t slot) const {
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t round = slot / count;
+    uint8_t position = slot % count;
+
+    // Fisher-Yates shuffle of the hop set, keyed by (seed, round)
+    uint8_t order[DMR_HOP_MAX_FREQUENCIES];
+    for (uint8_t i = 0; i < count; i++) {
+        order[i] = i;
+    }
+    uint32_t state = hopMix(seed ^ hopMix((uint32_t)round) ^ hopMix((uint32_t)(round >> 32) + 0x9E3779B9UL));
+    for (uint8_t i = count - 1; i > 0; i--) {
+        state = hopMix(state + i);
+        uint8_t j = state % (i + 1);
+        uint8_t t = order[i];
+        order[i] = order[j];
+        order[j] = t;
+    }
+    return frequencies[order[position]];
+}
+
+uint16_t DMRHopScheduler::getLead() const {
+    if (lead != DMR_HOP_AUTO_LEAD) {
+        return lead;
+    }
+    uint32_t ms = stats.meanUs() / 1000;
+    return ms > DMR_HOP_MAX_LEAD_MS ? DMR_HOP_MAX_LEAD_MS : ms;
+}
+
+/********************************************************
+ * HOPPING
+ ********************************************************/
+
+bool DMRHopScheduler::start(uint32_t seed, uint32_t slotMs) {
+    if (count == 0 || slotMs < DMR_HOP_MIN_SLOT_MS) {
+        return false;
+    }
+    if (ackSubscription == DMR_INVALID_SUBSCRIPTION) {
+        ackSubscription = dmr.subscribeFrame(DMR_CMD_SET_FREQUENCY, onFrequencyFrame, this);
+        if (ackSubscription == DMR_INVALID_SUBSCRIPTION) {
+            return false;
+        }
+    }
+    if (!running) {
+        uint32_t tx, rx;
+        bool known = dmr.getCached(SHADOW_TX_FREQ, tx) && dmr.getCached(SHADOW_RX_FREQ, rx);
+        homeTx = known ? tx : 0;
+        homeRx = known ? rx : 0;
+        homePending = !known && dmr.requestChannelParams(onHomeParams, this);
+    }
+    this->seed = seed;
+    this->slotMs = slotMs;
+    running = true;
+    hopped = false;
+    return true;
+}
+
+void DMRHopScheduler::stop() {
+    if (!running) {
+        return;
+    }
+    running = false;
+    awaitingAck = false;
+    if (homePending) {
+        dmr.cancelRequest(DMR_CMD_CHANNEL_PARAMS);
+        homePending = false;
+    }
+    dmr.unsubscribe(ackSubscription);
+    ackSubscription = DMR_INVALID_SUBSCRIPTION;
+    if (hopped && homeTx) {
+        dmr.setFrequency(homeTx, homeRx);
+    }
+    hopped = false;
+    currentFrequency = 0;
+}
+
+void DMRHopScheduler::update() {
+    if (!running) {
+        return;
+    }
+    if (awaitingAck && micros() - sentUs > DMR_HOP_ACK_TIMEOUT_MS * 1000UL) {
+        stats.timeouts++;
+        awaitingAck = false;
+    }
+
+    // Without trusted time every radio would drift onto its own schedule; hold instead.
+    // The first hop also waits to learn the frequency to come back to.
+    uint64_t utcMs;
+    if (homePending || !getTime(utcMs)) {
+        return;
+    }
+    uint64_t slot = (utcMs + getLead()) / slotMs;
+    if (!hopped || slot != currentSlot) {
+        retune(slot);
+    }
+}
+
+uint32_t DMRHopScheduler::msUntilUpdate() const {
+    uint64_t utcMs;
+    if (!running || homePending || !getTime(utcMs)) {
+        return DMR_HOP_IDLE;
+    }
+    if (!hopped) {
+        return 0;
+    }
+    // update() retunes once (utc + lead) crosses into the next slot
+    uint64_t ahead = utcMs + getLead();
+    uint32_t wait = (currentSlot + 1) * slotMs > ahead ? (currentSlot + 1) * slotMs - ahead : 0;
+    if (awaitingAck) {
+        uint32_t sinceSent = (micros() - sentUs) / 1000;
+        uint32_t timeout = sinceSent < DMR_HOP_ACK_TIMEOUT_MS ? DMR_HOP_ACK_TIMEOUT_MS - sinceSent + 1 : 0;
+        if (timeout < wait) {
+            wait = timeout;
+        }
+    }
+    return wait;
+}
+
+void DMRHopScheduler::retune(uint64_t slot) {
+    if (awaitingAck) {
+        // The previous retune never answered before the next boundary
+        stats.timeouts++;
+    }
+    uint32_t frequency = frequencyForSlot(slot);
+    currentSlot = slot;
+    hopped = true;
+    if (frequency == currentFrequency) {
+        awaitingAck = false;
+        return;
+    }
+    currentFrequency = frequency;
+    sentUs = micros();
+    awaitingAck = dmr.setFrequency(frequency, frequency);
+    stats.retunes++;
+}
+
+void DMRHopScheduler::onHomeParams(bool ok, const DMRFrameView &response, void *context) {
+    DMRHopScheduler *self = (DMRHopScheduler *)context;
+    self->homePending = false;
+    DMRChannelParams params;
+    if (!ok || !self->dmr.parseChannelParams(response.data, response.length, params)) {
+        return;
+    }
+    self->homeTx = params.txFreq;
+    self->homeRx = params.rxFreq;
+}
+
+void DMRHopScheduler::onFrequencyFrame(const DMRFrameView &frame, void *context) {
+    DMRHopScheduler *self = (DMRHopScheduler *)context;
+    if (frame.rw != 0x00 || !self->awaitingAck) {
+        return;
+    }
+    self->awaitingAck = false;
+    if (frame.sr != RESPONSE_OK) {
+        self->stats.refused++;
+        return;
+    }
+    uint32_t us = micros() - self->sentUs;
+    DMRHopStats &s = self->stats;
+    if (s.acked == 0 || us < s.minUs) s.minUs = us;
+    if (us > s.maxUs) s.maxUs = us;
+    s.lastUs = us;
+    s.sumUs += us;
+    s.acked++;
+}
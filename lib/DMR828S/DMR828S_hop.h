@@ -0,0 +1,111 @@
+#pragma once
+#include <Arduino.h>
+#include "DMR828S.h"
+
+// Time-synchronised frequency hopping.
+//
+// Every radio sharing a seed and a hop set computes the same frequency for
+// the same time slot, so hopping stays coordinated with no signalling: the
+// only shared input is UTC time, fed in from GPS with setTime(). Slots are
+// numbered from the Unix epoch; each round of N slots visits all N
+// frequencies once, in an order shuffled per round from (seed, round), so
+// any slot can be computed directly by a radio that just joined.
+//
+// Retunes go out through setFrequency() (0x0D, simplex: TX = RX) on the
+// slot boundary, issued `lead` ms early to hide the module's retune time.
+// The command-to-ack latency of every retune is measured; with automatic
+// lead the running mean of that latency is used.
+
+#define DMR_HOP_MAX_FREQUENCIES     32
+#define DMR_HOP_DEFAULT_SLOT_MS     2000
+#define DMR_HOP_MIN_SLOT_MS         250
+#define DMR_HOP_ACK_TIMEOUT_MS      200
+#define DMR_HOP_AUTO_LEAD           0xFFFF
+#define DMR_HOP_MAX_LEAD_MS         100
+#define DMR_HOP_IDLE                0xFFFFFFFFUL
+
+// How long the clock is trusted after the last setTime() (crystal drift is
+// ~20 ppm, so 10 min is ~12 ms); past that hopping holds on the current frequency
+#ifndef DMR_HOP_HOLDOVER_MS
+#define DMR_HOP_HOLDOVER_MS         600000UL
+#endif
+
+struct DMRHopStats {
+    uint32_t retunes = 0;           // setFrequency() commands sent
+    uint32_t acked = 0;
+    uint32_t refused = 0;           // Module answered with a non-zero S/R
+    uint32_t timeouts = 0;          // No answer within DMR_HOP_ACK_TIMEOUT_MS
+    uint32_t lastUs = 0;            // Command-to-ack latency of the last acked retune
+    uint32_t minUs = 0;
+    uint32_t maxUs = 0;
+    uint64_t sumUs = 0;
+    uint32_t meanUs() const { return acked ? sumUs / acked : 0; }
+};
+
+class DMRHopScheduler {
+public:
+    DMRHopScheduler(DMR828S &dmr);
+
+    // Evenly spaced hop set: base, base + spacing, ... (Hz)
+    bool setFrequencies(uint32_t baseHz, uint32_t spacingHz, uint8_t count);
+    bool setFrequencies(const uint32_t *frequencies, uint8_t count);
+    uint8_t getFrequencyCount() const { return count; }
+
+    // UTC at the moment millis() read atMillis; call on every GPS fix
+    void setTime(uint64_t utcMs, unsigned long atMillis);
+    bool isSynced() const;
+    bool getTime(uint64_t &utcMs) const;
+
+    // False without a hop set or a valid slot length. Hopping waits for the first setTime().
+    bool start(uint32_t seed, uint32_t slotMs = DMR_HOP_DEFAULT_SLOT_MS);
+    // Stops hopping; retunes to the frequency pair in use when start() was called
+    // (from the shadow cache, else asked for with 0x1D before the first hop)
+    void stop();
+    void update();                  // Call from loop() after dmr.update()
+    // How long update() has nothing to do: until the next retune (lead included)
+    // or ack timeout. DMR_HOP_IDLE while stopped or waiting for time or the home pair.
+    uint32_t msUntilUpdate() const;
+    bool isRunning() const { return running; }
+
+    void setLead(uint16_t ms) { lead = ms; }                // DMR_HOP_AUTO_LEAD: measured mean
+    uint16_t getLead() const;
+    uint32_t getSlotMs() const { return slotMs; }
+    uint32_t getSeed() const { return seed; }
+
+    // Pure schedule, no module traffic: same seed + set + slot gives the same answer on every radio
+    uint32_t frequencyForSlot(uint64_t slot) const;
+    uint64_t getSlot() const { return currentSlot; }
+    uint32_t getFrequency() const { return currentFrequency; }   // 0 until the first retune
+
+    const DMRHopStats& getStats() const { return stats; }
+    void clearStats() { stats = DMRHopStats(); }
+
+private:
+    DMR828S &dmr;
+    uint32_t frequencies[DMR_HOP_MAX_FREQUENCIES];
+    uint8_t count = 0;
+    uint32_t seed = 0;
+    uint32_t slotMs = DMR_HOP_DEFAULT_SLOT_MS;
+    uint16_t lead = DMR_HOP_AUTO_LEAD;
+    bool running = false;
+
+    uint64_t syncUtcMs = 0;
+    unsigned long syncMillis = 0;
+    bool timeSet = false;
+
+    bool hopped = false;            // A slot has been tuned since start()
+    uint64_t currentSlot = 0;
+    uint32_t currentFrequency = 0;
+    uint32_t homeTx = 0;            // Restored by stop()
+    uint32_t homeRx = 0;
+    bool homePending = false;       // 0x1D asked for the home pair; no hop until it answers
+
+    DMRSubscription ackSubscription = DMR_INVALID_SUBSCRIPTION;
+    bool awaitingAck = false;
+    unsigned long sentUs = 0;
+    DMRHopStats stats;
+
+    void retune(uint64_t slot);
+    static void onHomeParams(bool ok, const DMRFrameView &response, void *context);
+    static void onFrequencyFrame(const DMRFrameView &frame, void *context);
+};
@@ -0,0 +1,168 @@
+#include "DMR828S_link.h"
+
+DMRLinkSampler::DMRLinkSampler(DMR828S &dmr) : dmr(dmr) {
+}
+
+void DMRLinkSampler::begin(uint32_t intervalMs) {
+    setInterval(intervalMs);
+    running = true;
+    lastPoll = millis() - interval;     // First poll on the next update()
+}
+
+void DMRLinkSampler::stop() {
+    running = false;
+    if (polling) {
+        dmr.cancelRequest(DMR_CMD_RSSI);
+        dmr.cancelRequest(DMR_CMD_CHECK_STATUS);
+        polling = false;
+    }
+}
+
+void DMRLinkSampler::setInterval(uint32_t intervalMs) {
+    // A poll still in flight delays the next one rather than overlapping it
+    interval = intervalMs < DMR_LINK_MIN_INTERVAL_MS ? DMR_LINK_MIN_INTERVAL_MS : intervalMs;
+}
+
+void DMRLinkSampler::clear() {
+    head = 0;
+    count = 0;
+}
+
+/********************************************************
+ * SAMPLING
+ ********************************************************/
+
+void DMRLinkSampler::update() {
+    if (!running || polling || millis() - lastPoll < interval) {
+        return;
+    }
+
+    // Someone else may be waiting on 0x05 already; try again next update()
+    uint8_t data = 0x01;
+    if (!dmr.sendRequest(DMR_CMD_RSSI, &data, 1, onRSSI, this, DMR_LINK_REQUEST_TIMEOUT_MS)) {
+        return;
+    }
+    lastPoll = millis();
+    polling = true;
+}
+
+void DMRLinkSampler::onRSSI(bool ok, const DMRFrameView &response, void *context) {
+    DMRLinkSampler *self = (DMRLinkSampler *)context;
+    self->current = DMRLinkSample();
+    self->current.time = millis();
+    self->current.ok = ok && response.length >= 1;
+    self->current.rssi = self->current.ok ? response.data[0] : 0;
+
+    uint8_t data = 0x01;
+    if (!self->dmr.sendRequest(DMR_CMD_CHECK_STATUS, &data, 1, onStatus, self, DMR_LINK_REQUEST_TIMEOUT_MS)) {
+        self->record(self->current);
+        self->polling = false;
+    }
+}
+
+void DMRLinkSampler::onStatus(bool ok, const DMRFrameView &response, void *context) {
+    DMRLinkSampler *self = (DMRLinkSampler *)context;
+    if (ok && response.length >= 1) {
+        self->current.status = response.data[0];
+    }
+    self->record(self->current);
+    self->polling = false;
+}
+
+void DMRLinkSampler::record(const DMRLinkSample &sample) {
+    ring[head] = sample;
+    head = (head + 1) % DMR_LINK_HISTORY;
+    if (count < DMR_LINK_HISTORY) {
+        count++;
+    }
+}
+
+bool DMRLinkSampler::getSample(uint16_t age, DMRLinkSample &sample) const {
+    if (age >= count) {
+        return false;
+    }
+    sample = ring[(head + DMR_LINK_HISTORY - 1 - age) % DMR_LINK_HISTORY];
+    return true;
+}
+
+/********************************************************
+ * STATISTICS
+ ********************************************************/
+
+// Smallest value with at least p percent of the samples at or below it
+static uint8_t histogramPercentile(const uint16_t *histogram, uint16_t samples, uint8_t p) {
+    uint32_t rank = ((uint32_t)samples * p + 99) / 100;
+    if (rank == 0) {
+        rank = 1;
+    }
+    uint32_t seen = 0;
+    for (uint16_t value = 0; value < 256; value++) {
+        seen += histogram[value];
+        if (seen >= rank) {
+            return value;
+        }
+    }
+    return 255;
+}
+
+bool DMRLinkSampler::getStats(DMRLinkStats &stats, uint32_t windowMs) const {
+    stats = DMRLinkStats();
+    if (count == 0) {
+        return false;
+    }
+
+    uint16_t histogram[256];
+    memset(histogram, 0, sizeof(histogram));
+    uint32_t sum = 0;
+    uint32_t newest = ring[(head + DMR_LINK_HISTORY - 1) % DMR_LINK_HISTORY].time;
+    uint32_t oldest = newest;
+
+    // Least squares over (seconds before newest, rssi)
+    float sumT = 0, sumTT = 0, sumTR = 0;
+
+    for (uint16_t age = 0; age < count; age++) {
+        const DMRLinkSample &s = ring[(head + DMR_LINK_HISTORY - 1 - age) % DMR_LINK_HISTORY];
+        if (windowMs && newest - s.time > windowMs) {
+            break;
+        }
+        oldest = s.time;
+        if (!s.ok) {
+            stats.missed++;
+            continue;
+        }
+        if (stats.samples == 0) {
+            stats.last = s.rssi;
+            stats.min = s.rssi;
+            stats.max = s.rssi;
+        }
+        if (s.rssi < stats.min) stats.min = s.rssi;
+        if (s.rssi > stats.max) stats.max = s.rssi;
+        if (s.status == STATUS_RECEIVING) stats.receiving++;
+        if (s.status == STATUS_TRANSMITTING) stats.transmitting++;
+        histogram[s.rssi]++;
+        sum += s.rssi;
+        stats.samples++;
+
+        float t = -(float)(newest - s.time) / 1000.0f;
+        sumT += t;
+        sumTT += t * t;
+        sumTR += t * s.rssi;
+    }
+
+    stats.spanMs = newest - oldest;
+    if (stats.samples == 0) {
+        return false;
+    }
+
+    stats.mean = (float)sum / stats.samples;
+    stats.p10 = histogramPercentile(histogram, stats.samples, 10);
+    stats.p50 = histogramPercentile(histogram, stats.samples, 50);
+    stats.p90 = histogramPercentile(histogram, stats.samples, 90);
+
+    float n = stats.samples;
+    float denominator = n * sumTT - sumT * sumT;
+    if (stats.samples >= 2 && denominator > 1e-6f) {
+        stats.trendPerMin = (n * sumTR - sumT * (float)sum) / denominator * 60.0f;
+    }
+    return true;
+}
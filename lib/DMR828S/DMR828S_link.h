@@ -0,0 +1,80 @@
+#pragma once
+#include <Arduino.h>
+#include "DMR828S.h"
+
+// Background link-quality sampler.
+//
+// Polls RSSI (0x05) and module status (0x04) through the async request table
+// at a fixed cadence, so loop() never waits on the module, and keeps the
+// samples in a fixed ring. Statistics are computed on demand over the whole
+// ring or the last N milliseconds of it: min/max/mean, percentiles from a
+// 256-bin histogram and a least-squares trend in RSSI units per minute.
+
+// Samples kept (at the default 2 s cadence, a little over 4 minutes)
+#ifndef DMR_LINK_HISTORY
+#define DMR_LINK_HISTORY            128
+#endif
+
+#define DMR_LINK_DEFAULT_INTERVAL_MS    2000
+#define DMR_LINK_MIN_INTERVAL_MS        50
+#define DMR_LINK_REQUEST_TIMEOUT_MS     500
+
+struct DMRLinkSample {
+    uint32_t time = 0;              // millis() when the RSSI answer arrived
+    uint8_t rssi = 0;
+    uint8_t status = 0;             // DMRModuleStatus, 0 if that query went unanswered
+    bool ok = false;                // false: the RSSI query timed out (rssi invalid)
+};
+
+struct DMRLinkStats {
+    uint16_t samples = 0;           // Answered samples in the window
+    uint16_t missed = 0;            // Timed-out polls in the window
+    uint8_t last = 0;
+    uint8_t min = 0;
+    uint8_t max = 0;
+    float mean = 0;
+    uint8_t p10 = 0;
+    uint8_t p50 = 0;
+    uint8_t p90 = 0;
+    float trendPerMin = 0;          // RSSI change per minute, least squares
+    uint16_t receiving = 0;         // Samples that found the module in RX
+    uint16_t transmitting = 0;      // ... and in TX
+    uint32_t spanMs = 0;            // Oldest to newest sample in the window
+};
+
+class DMRLinkSampler {
+public:
+    DMRLinkSampler(DMR828S &dmr);
+
+    void begin(uint32_t intervalMs = DMR_LINK_DEFAULT_INTERVAL_MS);
+    void stop();
+    void setInterval(uint32_t intervalMs);
+    uint32_t getInterval() const { return interval; }
+    bool isRunning() const { return running; }
+    void clear();
+
+    // Call from loop() after dmr.update(); only issues a request when due
+    void update();
+
+    uint16_t getCount() const { return count; }
+    bool getSample(uint16_t age, DMRLinkSample &sample) const;     // 0 = newest
+    bool getLatest(DMRLinkSample &sample) const { return getSample(0, sample); }
+
+    // windowMs = 0 covers the whole ring. False when no answered sample is in it.
+    bool getStats(DMRLinkStats &stats, uint32_t windowMs = 0) const;
+
+private:
+    DMR828S &dmr;
+    DMRLinkSample ring[DMR_LINK_HISTORY];
+    uint16_t head = 0;              // Next slot to write
+    uint16_t count = 0;
+    uint32_t interval = DMR_LINK_DEFAULT_INTERVAL_MS;
+    unsigned long lastPoll = 0;
+    bool running = false;
+    bool polling = false;           // RSSI/status pair in flight
+    DMRLinkSample current;
+
+    void record(const DMRLinkSample &sample);
+    static void onRSSI(bool ok, const DMRFrameView &response, void *context);
+    static void onStatus(bool ok, const DMRFrameView &response, void *context);
+};
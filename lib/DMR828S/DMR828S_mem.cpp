@@ -0,0 +1,369 @@
+#include "DMR828S_mem.h"
+
+// The counting path runs inside malloc, which ESP-IDF keeps in IRAM so it
+// works while the flash cache is off
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+
+DMRMemTracker *DMRMemTracker::attached = nullptr;
+
+// Per thread (per FreeRTOS task on the ESP32), so tasks on both cores keep their own site
+static thread_local uint8_t threadSite = 0;
+
+DMRMemTracker::DMRMemTracker(const char *const *names, uint8_t count)
+    : names(names), count(count < DMR_MEM_MAX_SITES ? count : DMR_MEM_MAX_SITES) {
+}
+
+void DMRMemTracker::attach() {
+    if (resetMs == 0) {
+        resetMs = millis();
+    }
+    attached = this;
+}
+
+/********************************************************
+ * SITES
+ ********************************************************/
+
+uint8_t IRAM_ATTR DMRMemTracker::currentSite() {
+#if defined(ESP32)
+    // Static constructors allocate before any task, and so before thread-local storage, exists
+    if (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED) {
+        return 0;
+    }
+#endif
+    return threadSite;
+}
+
+uint8_t DMRMemTracker::enterSite(uint8_t site) {
+    uint8_t previous = currentSite();
+#if defined(ESP32)
+    if (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED) {
+        return previous;
+    }
+#endif
+    threadSite = site;
+    return previous;
+}
+
+/********************************************************
+ * COUNTING
+ ********************************************************/
+
+DMRMemTracker::Counters &IRAM_ATTR DMRMemTracker::current() {
+    uint8_t site = currentSite();
+    return sites[site < count ? site : 0];
+}
+
+void IRAM_ATTR DMRMemTracker::add(Counters &c, size_t bytes, bool ok) {
+    if (!ok) {
+        c.failed.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    c.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    uint32_t largest = c.largest.load(std::memory_order_relaxed);
+    while (bytes > largest &&
+           !c.largest.compare_exchange_weak(largest, bytes, std::memory_order_relaxed)) {
+    }
+}
+
+void IRAM_ATTR DMRMemTracker::noteAlloc(size_t bytes, bool ok) {
+    Counters &c = current();
+    add(c, bytes, ok);
+    if (ok) {
+        c.allocs.fetch_add(1, std::memory_order_relaxed);
+        live.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void IRAM_ATTR DMRMemTracker::noteRealloc(size_t bytes, bool ok) {
+    Counters &c = current();
+    add(c, bytes, ok);
+    if (ok) {
+        c.reallocs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void IRAM_ATTR DMRMemTracker::noteFree() {
+    current().frees.fetch_add(1, std::memory_order_relaxed);
+    live.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool DMRMemTracker::getSite(uint8_t site, DMRMemSiteStats &stats) const {
+    if (site >= count) {
+        return false;
+    }
+    const Counters &c = sites[site];
+    stats.allocs = c.allocs.load(std::memory_order_relaxed);
+    stats.reallocs = c.reallocs.load(std::memory_order_relaxed);
+    stats.frees = c.frees.load(std::memory_order_relaxed);
+    stats.failed = c.failed.load(std::memory_order_relaxed);
+    stats.bytes = c.bytes.load(std::memory_order_relaxed);
+    stats.largest = c.largest.load(std::memory_order_relaxed);
+    return true;
+}
+
+DMRMemSiteStats DMRMemTracker::getTotals() const {
+    DMRMemSiteStats totals;
+    for (uint8_t i = 0; i < count; i++) {
+        DMRMemSiteStats s;
+        getSite(i, s);
+        totals.allocs += s.allocs;
+        totals.reallocs += s.reallocs;
+        totals.frees += s.frees;
+        totals.failed += s.failed;
+        totals.bytes += s.bytes;
+        if (s.largest > totals.largest) {
+            totals.largest = s.largest;
+        }
+    }
+    return totals;
+}
+
+void DMRMemTracker::reset(uint32_t nowMs) {
+    for (uint8_t i = 0; i < count; i++) {
+        Counters &c = sites[i];
+        c.allocs.store(0, std::memory_order_relaxed);
+        c.reallocs.store(0, std::memory_order_relaxed);
+        c.frees.store(0, std::memory_order_relaxed);
+        c.failed.store(0, std::memory_order_relaxed);
+        c.bytes.store(0, std::memory_order_relaxed);
+        c.largest.store(0, std::memory_order_relaxed);
+    }
+    head = 0;
+    samples = 0;
+    resetMs = nowMs;
+}
+
+/********************************************************
+ * HEAP SAMPLES
+ ********************************************************/
+
+bool DMRMemTracker::readHeap(DMRHeapSample &sample) {
+#if defined(ESP32)
+    // Internal RAM only: PSRAM is plentiful, internal fragmentation is what fails
+    sample.freeBytes = ESP.getFreeHeap();
+    sample.minFreeBytes = ESP.getMinFreeHeap();
+    sample.largestFree = ESP.getMaxAllocHeap();
+    return true;
+#else
+    sample.freeBytes = 0;
+    sample.minFreeBytes = 0;
+    sample.largestFree = 0;
+    return false;
+#endif
+}
+
+void DMRMemTracker::sample(uint32_t nowMs) {
+    DMRHeapSample &s = history[head];
+    readHeap(s);
+    s.atMs = nowMs;
+    s.operations = getTotals().operations();
+    s.liveBlocks = getLiveBlocks();
+    head = (head + 1) % DMR_MEM_HISTORY;
+    if (samples < DMR_MEM_HISTORY) {
+        samples++;
+    }
+}
+
+bool DMRMemTracker::getSample(uint8_t age, DMRHeapSample &sample) const {
+    if (age >= samples) {
+        return false;
+    }
+    sample = history[(head + DMR_MEM_HISTORY - 1 - age) % DMR_MEM_HISTORY];
+    return true;
+}
+
+/********************************************************
+ * REPORT
+ ********************************************************/
+
+void DMRMemTracker::printTo(Print &out, uint32_t nowMs) const {
+    char line[120];
+    DMRHeapSample heap;
+    bool heapVisible = readHeap(heap);
+    if (heapVisible) {
+        snprintf(line, sizeof(line), "Heap: %lu B free (low %lu), largest block %lu, fragmentation %u%%",
+                 (unsigned long)heap.freeBytes, (unsigned long)heap.minFreeBytes,
+                 (unsigned long)heap.largestFree, (unsigned)heap.fragmentation());
+        out.println(line);
+    }
+    if (!hooksBuiltIn()) {
+        out.println("Allocation hooks not built in (DMR_MEM_HOOKS 0)");
+    }
+
+    uint32_t elapsed = nowMs - resetMs;
+    snprintf(line, sizeof(line), "Live blocks: %ld. Allocations over %lu.%lu min:", (long)getLiveBlocks(),
+             (unsigned long)(elapsed / 60000), (unsigned long)(elapsed % 60000 / 6000));
+    out.println(line);
+    snprintf(line, sizeof(line), "%-14s %8s %8s %8s %9s %10s %8s %6s", "Site", "Allocs", "Resizes",
+             "Frees", "Per hour", "Bytes", "Largest", "Failed");
+    out.println(line);
+    for (uint8_t i = 0; i < count; i++) {
+        DMRMemSiteStats s;
+        getSite(i, s);
+        if (s.operations() == 0 && s.frees == 0 && s.failed == 0) {
+            continue;
+        }
+        snprintf(line, sizeof(line), "%-14s %8lu %8lu %8lu %9lu %10lu %8lu %6lu", names[i],
+                 (unsigned long)s.allocs, (unsigned long)s.reallocs, (unsigned long)s.frees,
+                 (unsigned long)perHour(s.operations(), elapsed), (unsigned long)s.bytes,
+                 (unsigned long)s.largest, (unsigned long)s.failed);
+        out.println(line);
+    }
+
+    if (samples == 0) {
+        return;
+    }
+    // Rate and live-block change since the sample before; live blocks that
+    // keep climbing are a leak, falling largest-block at steady free memory
+    // is fragmentation
+    if (heapVisible) {
+        snprintf(line, sizeof(line), "%10s %8s %8s %8s %5s %9s %6s", "At (min)", "Free", "Low",
+                 "Largest", "Frag", "Per hour", "Live");
+    } else {
+        snprintf(line, sizeof(line), "%10s %9s %6s", "At (min)", "Per hour", "Live");
+    }
+    out.println(line);
+    for (uint8_t age = samples; age-- > 0;) {
+        DMRHeapSample s, before;
+        getSample(age, s);
+        char rate[12] = "-";
+        char grew[24] = "";
+        if (getSample(age + 1, before)) {
+            snprintf(rate, sizeof(rate), "%lu",
+                     (unsigned long)perHour(s.operations - before.operations, s.atMs - before.atMs));
+            snprintf(grew, sizeof(grew), " (%+ld)", (long)s.liveBlocks - before.liveBlocks);
+        }
+        int n = snprintf(line, sizeof(line), "%8lu.%lu", (unsigned long)(s.atMs / 60000),
+                         (unsigned long)(s.atMs % 60000 / 6000));
+        if (heapVisible) {
+            n += snprintf(line + n, sizeof(line) - n, " %8lu %8lu %8lu %4u%%", (unsigned long)s.freeBytes,
+                          (unsigned long)s.minFreeBytes, (unsigned long)s.largestFree,
+                          (unsigned)s.fragmentation());
+        }
+        snprintf(line + n, sizeof(line) - n, " %9s %6ld%s", rate, (long)s.liveBlocks, grew);
+        out.println(line);
+    }
+}
+
+/********************************************************
+ * ALLOCATOR HOOKS
+ ********************************************************/
+
+#if DMR_MEM_HOOKS && defined(ESP32)
+
+// Linked with -Wl,--wrap=malloc,... every call to malloc lands in __wrap_malloc
+// and __real_malloc is the allocator itself
+extern "C" {
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+
+void *IRAM_ATTR __wrap_malloc(size_t size) {
+    void *ptr = __real_malloc(size);
+    if (DMRMemTracker *tracker = DMRMemTracker::attached) {
+        tracker->noteAlloc(size, ptr != nullptr);
+    }
+    return ptr;
+}
+
+void *IRAM_ATTR __wrap_calloc(size_t n, size_t size) {
+    void *ptr = __real_calloc(n, size);
+    if (DMRMemTracker *tracker = DMRMemTracker::attached) {
+        tracker->noteAlloc(n * size, ptr != nullptr);
+    }
+    return ptr;
+}
+
+void *IRAM_ATTR __wrap_realloc(void *ptr, size_t size) {
+    void *moved = __real_realloc(ptr, size);
+    if (DMRMemTracker *tracker = DMRMemTracker::attached) {
+        if (!ptr) {
+            tracker->noteAlloc(size, moved != nullptr);
+        } else if (size == 0) {
+            tracker->noteFree();
+        } else {
+            tracker->noteRealloc(size, moved != nullptr);
+        }
+    }
+    return moved;
+}
+
+void IRAM_ATTR __wrap_free(void *ptr) {
+    if (ptr) {
+        if (DMRMemTracker *tracker = DMRMemTracker::attached) {
+            tracker->noteFree();
+        }
+    }
+    __real_free(ptr);
+}
+}
+
+#elif DMR_MEM_HOOKS && !defined(ARDUINO)
+
+// Host build: C++ allocations (String, containers) through the replaceable operators
+#include <new>
+
+void *operator new(size_t size) {
+    void *ptr = malloc(size ? size : 1);
+    if (DMRMemTracker *tracker = DMRMemTracker::attached) {
+        tracker->noteAlloc(size, ptr != nullptr);
+    }
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    void *ptr = malloc(size ? size : 1);
+    if (DMRMemTracker *tracker = DMRMemTracker::attached) {
+        tracker->noteAlloc(size, ptr != nullptr);
+    }
+    return ptr;
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void *ptr) noexcept {
+    if (ptr) {
+        if (DMRMemTracker *tracker = DMRMemTracker::attached) {
+            tracker->noteFree();
+        }
+    }
+    free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+    operator delete(ptr);
+}
+
+#if defined(__cpp_sized_deallocation)
+// C++14 and later call these when the size is known
+void operator delete(void *ptr, size_t) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept {
+    operator delete(ptr);
+}
+#endif
+
+#endif
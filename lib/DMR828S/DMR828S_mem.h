@@ -0,0 +1,147 @@
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+
+// Heap allocation accounting.
+//
+// Each allocation is counted against a site: the subsystem or call site the
+// calling thread is in, set with DMR_MEM_SCOPE. Site 0 collects everything
+// outside a scope (other tasks, the Bluetooth stack, boot). Counters are
+// totals since reset(), kept in fixed memory and updated atomically, so any
+// task may allocate while another reads them.
+//
+// sample() snapshots the heap (free bytes, low-water mark, largest free
+// block, hence fragmentation) together with the running totals into a ring.
+// Rates are per hour of the clock the caller passes in, millis() by
+// default: a host run stepping a simulated clock gets allocations per
+// simulated hour.
+//
+// The allocator hooks are only built with DMR_MEM_HOOKS 1. On the ESP32 the
+// link must then also wrap the allocator:
+//   -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free
+// which catches String, new and every C library allocation. A host build
+// replaces the global operator new/delete instead (String there is a
+// std::string). Without hooks, sites and heap samples still work and the
+// counts stay 0.
+
+#ifndef DMR_MEM_HOOKS
+#define DMR_MEM_HOOKS               0
+#endif
+
+#ifndef DMR_MEM_MAX_SITES
+#define DMR_MEM_MAX_SITES           16
+#endif
+
+#ifndef DMR_MEM_HISTORY
+#define DMR_MEM_HISTORY             24      // Heap samples kept
+#endif
+
+struct DMRMemSiteStats {
+    uint32_t allocs = 0;            // malloc, calloc, new, realloc of NULL
+    uint32_t reallocs = 0;          // Resizes of a live block (String growth)
+    uint32_t frees = 0;             // Counted where the block is freed
+    uint32_t failed = 0;            // Requests that returned NULL
+    uint32_t bytes = 0;             // Requested; wraps, so compare differences
+    uint32_t largest = 0;           // Biggest single request
+
+    uint32_t operations() const { return allocs + reallocs; }
+};
+
+struct DMRHeapSample {
+    uint32_t atMs = 0;
+    uint32_t freeBytes = 0;         // Heap figures are 0 where the heap is not visible (host)
+    uint32_t minFreeBytes = 0;      // Low-water mark since boot
+    uint32_t largestFree = 0;       // Biggest block that can still be allocated
+    uint32_t operations = 0;        // Allocations and resizes, all sites, since reset()
+    int32_t liveBlocks = 0;         // Allocated and not yet freed
+
+    // Share of free memory outside the largest block: high means a big
+    // allocation can fail while plenty of memory is free
+    uint8_t fragmentation() const {
+        return freeBytes ? 100 - (uint64_t)largestFree * 100 / freeBytes : 0;
+    }
+};
+
+class DMRMemTracker {
+public:
+    // names[i] labels site i and must outlive the tracker
+    DMRMemTracker(const char *const *names, uint8_t count);
+
+    // The hooks count into this tracker from now on. Blocks allocated before
+    // and freed after show up as negative live blocks.
+    void attach();
+    static bool hooksBuiltIn() { return DMR_MEM_HOOKS; }
+
+    // The calling thread's site; returns the previous one
+    static uint8_t enterSite(uint8_t site);
+    static uint8_t currentSite();
+
+    // Called by the hooks (or by hand, for an allocator they do not see)
+    void noteAlloc(size_t bytes, bool ok);
+    void noteRealloc(size_t bytes, bool ok);
+    void noteFree();
+
+    // Heap now (false where it cannot be read) and the running totals
+    static bool readHeap(DMRHeapSample &sample);
+    void sample(uint32_t nowMs = millis());
+    uint8_t getSampleCount() const { return samples; }
+    // age 0 is the newest
+    bool getSample(uint8_t age, DMRHeapSample &sample) const;
+
+    uint8_t getCount() const { return count; }
+    const char *getName(uint8_t site) const { return site < count ? names[site] : nullptr; }
+    bool getSite(uint8_t site, DMRMemSiteStats &stats) const;
+    DMRMemSiteStats getTotals() const;
+    int32_t getLiveBlocks() const { return live.load(std::memory_order_relaxed); }
+    static uint32_t perHour(uint32_t events, uint32_t ms) {
+        return ms ? (uint64_t)events * 3600000ULL / ms : 0;
+    }
+
+    // Counters and samples; live blocks are kept
+    void reset(uint32_t nowMs = millis());
+    uint32_t getResetMs() const { return resetMs; }
+
+    // Heap now, a table of every site that allocated (with its rate per
+    // hour since reset), then the samples oldest first with the rate and
+    // live-block change over each interval
+    void printTo(Print &out, uint32_t nowMs = millis()) const;
+
+    static DMRMemTracker *attached;
+
+private:
+    struct Counters {
+        std::atomic<uint32_t> allocs{0};
+        std::atomic<uint32_t> reallocs{0};
+        std::atomic<uint32_t> frees{0};
+        std::atomic<uint32_t> failed{0};
+        std::atomic<uint32_t> bytes{0};
+        std::atomic<uint32_t> largest{0};
+    };
+
+    const char *const *names;
+    uint8_t count;
+    Counters sites[DMR_MEM_MAX_SITES];
+    std::atomic<int32_t> live{0};
+    uint32_t resetMs = 0;
+
+    DMRHeapSample history[DMR_MEM_HISTORY];     // Ring, written by sample() only
+    uint8_t head = 0;
+    uint8_t samples = 0;
+
+    Counters &current();
+    static void add(Counters &c, size_t bytes, bool ok);
+};
+
+// Attributes the enclosing scope's allocations to a site, then restores the outer one
+class DMRMemScope {
+public:
+    DMRMemScope(uint8_t site) : previous(DMRMemTracker::enterSite(site)) {}
+    ~DMRMemScope() { DMRMemTracker::enterSite(previous); }
+
+private:
+    uint8_t previous;
+};
+
+#define DMR_MEM_CONCAT_(a, b) a##b
+#define DMR_MEM_CONCAT(a, b) DMR_MEM_CONCAT_(a, b)
+#define DMR_MEM_SCOPE(site) DMRMemScope DMR_MEM_CONCAT(dmrMemScope, __LINE__)(site)
@@ -0,0 +1,118 @@
+#include "DMR828S_perf.h"
+
+DMRPerfProfiler::DMRPerfProfiler(const char *const *names, uint8_t count)
+    : names(names), count(count < DMR_PERF_MAX_STAGES ? count : DMR_PERF_MAX_STAGES) {
+}
+
+uint64_t DMRPerfProfiler::ticksToNs(uint64_t ticks) {
+#if defined(ESP32)
+    return ticks * 1000 / getCpuFrequencyMhz();
+#elif !defined(ARDUINO)
+    return ticks;
+#else
+    return ticks * 1000;
+#endif
+}
+
+uint32_t DMRPerfProfiler::usToTicks(uint32_t us) {
+#if defined(ESP32)
+    uint64_t ticks = (uint64_t)us * getCpuFrequencyMhz();
+#elif !defined(ARDUINO)
+    uint64_t ticks = (uint64_t)us * 1000;
+#else
+    uint64_t ticks = us;
+#endif
+    return ticks > 0xFFFFFFFFULL ? 0xFFFFFFFFUL : (uint32_t)ticks;
+}
+
+void DMRPerfProfiler::setBudget(uint32_t us, DMRPerfOverBudgetCallback callback, void *context) {
+    overBudgetCallback = callback;
+    overBudgetContext = context;
+    budgetUs = us;
+    budgetTicks = usToTicks(us);
+}
+
+void DMRPerfProfiler::reset() {
+    for (uint8_t i = 0; i < count; i++) {
+        stages[i] = DMRPerfStage();
+    }
+}
+
+uint32_t DMRPerfStage::percentileTicks(uint8_t percent) const {
+    if (count == 0) {
+        return 0;
+    }
+    uint32_t target = ((uint64_t)count * percent + 99) / 100;
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < DMR_PERF_BUCKETS; i++) {
+        seen += buckets[i];
+        if (seen >= target) {
+            uint32_t bound = i == DMR_PERF_BUCKETS - 1 ? 0xFFFFFFFFUL : (2UL << i) - 1;
+            return bound < maxTicks ? bound : maxTicks;
+        }
+    }
+    return maxTicks;
+}
+
+/********************************************************
+ * REPORT
+ ********************************************************/
+
+// "850ns", "12.4us", "3.2ms", "1.5s"
+static void formatDuration(char *buf, size_t size, uint64_t ns) {
+    if (ns < 1000ULL) {
+        snprintf(buf, size, "%luns", (unsigned long)ns);
+    } else if (ns < 1000000ULL) {
+        snprintf(buf, size, "%lu.%luus", (unsigned long)(ns / 1000), (unsigned long)(ns % 1000 / 100));
+    } else if (ns < 1000000000ULL) {
+        snprintf(buf, size, "%lu.%lums", (unsigned long)(ns / 1000000), (unsigned long)(ns % 1000000 / 100000));
+    } else {
+        snprintf(buf, size, "%lu.%lus", (unsigned long)(ns / 1000000000ULL),
+                 (unsigned long)(ns % 1000000000ULL / 100000000ULL));
+    }
+}
+
+void DMRPerfProfiler::printTo(Print &out) const {
+    char line[120];
+    char mean[12], p50[12], p90[12], p99[12], worst[12];
+    snprintf(line, sizeof(line), "%-14s %8s %8s %8s %8s %8s %8s %10s %5s", "Stage", "Count", "Mean",
+             "p50", "p90", "p99", "Max", "Max at (s)", "Over");
+    out.println(line);
+    for (uint8_t i = 0; i < count; i++) {
+        const DMRPerfStage &s = stages[i];
+        if (s.count == 0) {
+            continue;
+        }
+        formatDuration(mean, sizeof(mean), ticksToNs(s.meanTicks()));
+        formatDuration(p50, sizeof(p50), ticksToNs(s.percentileTicks(50)));
+        formatDuration(p90, sizeof(p90), ticksToNs(s.percentileTicks(90)));
+        formatDuration(p99, sizeof(p99), ticksToNs(s.percentileTicks(99)));
+        formatDuration(worst, sizeof(worst), ticksToNs(s.maxTicks));
+        snprintf(line, sizeof(line), "%-14s %8lu %8s %8s %8s %8s %8s %8lu.%lu %5lu", names[i],
+                 (unsigned long)s.count, mean, p50, p90, p99, worst,
+                 (unsigned long)(s.maxAtMs / 1000), (unsigned long)(s.maxAtMs % 1000 / 100),
+                 (unsigned long)s.overBudget);
+        out.println(line);
+    }
+
+    // Bucket counts labelled with each bucket's upper bound
+    for (uint8_t i = 0; i < count; i++) {
+        const DMRPerfStage &s = stages[i];
+        if (s.count == 0) {
+            continue;
+        }
+        out.print("  ");
+        out.print(names[i]);
+        out.print(":");
+        for (uint8_t b = 0; b < DMR_PERF_BUCKETS; b++) {
+            if (s.buckets[b] == 0) {
+                continue;
+            }
+            char bound[12];
+            formatDuration(bound, sizeof(bound), ticksToNs(2ULL << b));
+            snprintf(line, sizeof(line), " <%s:%lu", bound, (unsigned long)s.buckets[b]);
+            out.print(line);
+        }
+        out.println();
+    }
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include <Arduino.h>
+
+// Stage latency profiler.
+//
+// Each named stage keeps a histogram of its run times in power-of-two
+// buckets (bucket i: 2^i to 2^(i+1) - 1 ticks, so 32 buckets cover every
+// 32-bit duration), a count, a sum and the worst case together with when it
+// happened. Memory is fixed: no samples are stored. Ticks are CPU cycles on
+// the ESP32, nanoseconds on a host build and micros() elsewhere, so the
+// same instrumentation runs against the simulator.
+//
+// Wrap a stage with DMR_PERF_SCOPE(profiler, stage); with DMR_PERF_ENABLED 0
+// the macro compiles to nothing. Each stage must only be recorded from one
+// task; printing and reset() from another task see a snapshot.
+//
+// With a budget set, a stage that runs longer is counted and reported to a
+// callback, called in the recording task as soon as the stage ends: a
+// software watchdog for handlers that block.
+
+#ifndef DMR_PERF_ENABLED
+#define DMR_PERF_ENABLED            1
+#endif
+
+#ifndef DMR_PERF_MAX_STAGES
+#define DMR_PERF_MAX_STAGES         16
+#endif
+
+#define DMR_PERF_BUCKETS            32
+
+typedef void (*DMRPerfOverBudgetCallback)(uint8_t stage, uint32_t ticks, void *context);
+
+struct DMRPerfStage {
+    uint32_t count = 0;
+    uint64_t sumTicks = 0;
+    uint32_t maxTicks = 0;
+    uint32_t maxAtMs = 0;           // millis() when the worst case ended
+    uint32_t overBudget = 0;        // Runs longer than the budget
+    uint32_t buckets[DMR_PERF_BUCKETS] = {0};
+
+    uint32_t meanTicks() const { return count ? sumTicks / count : 0; }
+    // Upper bound of the bucket holding the given percentile (0-100)
+    uint32_t percentileTicks(uint8_t percent) const;
+};
+
+class DMRPerfProfiler {
+public:
+    // names[i] labels stage i and must outlive the profiler
+    DMRPerfProfiler(const char *const *names, uint8_t count);
+
+    static inline uint32_t ticks();
+    static uint64_t ticksToNs(uint64_t ticks);
+    static uint32_t usToTicks(uint32_t us);
+
+    // 0 turns the check off. The cycle counter wraps after ~17 s at 240 MHz, so
+    // longer stages are mis-measured; keep the budget well below that.
+    void setBudget(uint32_t us, DMRPerfOverBudgetCallback callback = nullptr, void *context = nullptr);
+    uint32_t getBudgetUs() const { return budgetUs; }
+
+    void record(uint8_t stage, uint32_t ticks) {
+        if (stage >= count) {
+            return;
+        }
+        DMRPerfStage &s = stages[stage];
+        s.count++;
+        s.sumTicks += ticks;
+        s.buckets[ticks ? 31 - __builtin_clz(ticks) : 0]++;
+        if (ticks > s.maxTicks) {
+            s.maxTicks = ticks;
+            s.maxAtMs = millis();
+        }
+        if (budgetTicks && ticks > budgetTicks) {
+            s.overBudget++;
+            if (overBudgetCallback) {
+                overBudgetCallback(stage, ticks, overBudgetContext);
+            }
+        }
+    }
+
+    uint8_t getCount() const { return count; }
+    const char *getName(uint8_t stage) const { return stage < count ? names[stage] : nullptr; }
+    const DMRPerfStage *getStage(uint8_t stage) const { return stage < count ? &stages[stage] : nullptr; }
+    void reset();
+
+    // Table of every stage that ran (count, mean, p50/p90/p99, worst and when),
+    // then one histogram line per stage
+    void printTo(Print &out) const;
+
+private:
+    const char *const *names;
+    uint8_t count;
+    DMRPerfStage stages[DMR_PERF_MAX_STAGES];
+    uint32_t budgetUs = 0;
+    uint32_t budgetTicks = 0;
+    DMRPerfOverBudgetCallback overBudgetCallback = nullptr;
+    void *overBudgetContext = nullptr;
+};
+
+// Records the enclosing scope's duration on destruction
+class DMRPerfScope {
+public:
+    DMRPerfScope(DMRPerfProfiler &profiler, uint8_t stage)
+        : profiler(profiler), stage(stage), start(DMRPerfProfiler::ticks()) {}
+    ~DMRPerfScope() { profiler.record(stage, DMRPerfProfiler::ticks() - start); }
+
+private:
+    DMRPerfProfiler &profiler;
+    uint8_t stage;
+    uint32_t start;
+};
+
+#if DMR_PERF_ENABLED
+#define DMR_PERF_CONCAT_(a, b) a##b
+#define DMR_PERF_CONCAT(a, b) DMR_PERF_CONCAT_(a, b)
+#define DMR_PERF_SCOPE(profiler, stage) DMRPerfScope DMR_PERF_CONCAT(dmrPerfScope, __LINE__)(profiler, stage)
+#else
+#define DMR_PERF_SCOPE(profiler, stage) do {} while (0)
+#endif
+
+#if defined(ESP32)
+inline uint32_t DMRPerfProfiler::ticks() { return ESP.getCycleCount(); }
+#elif !defined(ARDUINO)
+#include <chrono>
+inline uint32_t DMRPerfProfiler::ticks() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#else
+inline uint32_t DMRPerfProfiler::ticks() { return micros(); }
+#endif
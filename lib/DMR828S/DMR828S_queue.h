@@ -0,0 +1,145 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+
+// Fixed-capacity lock-free ring queues for handing messages between tasks,
+// or from an ISR to a task, without a kernel call or a critical section.
+//
+// DMRSPSCQueue: one producer, one consumer. push() and pop() are wait-free:
+// each touches only its own index plus a cached copy of the other side's.
+//
+// DMRMPSCQueue: any number of producers (tasks and ISRs), one consumer.
+// Producers claim a slot with a single compare-and-swap on the head, which
+// succeeds first time unless another producer claimed the same slot in the
+// meantime; pop() is wait-free. Each slot carries a sequence number, so a
+// producer preempted between claiming and filling its slot only holds up the
+// consumer, never another producer.
+//
+// Both copy T by value and never allocate; N must be a power of two. Neither
+// blocks: a full push() or an empty pop() returns false at once. Pair with a
+// task notification or semaphore when the consumer should sleep.
+
+template <typename T, uint16_t N>
+class DMRSPSCQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "capacity must be a power of two");
+
+public:
+    // Producer side
+    bool push(const T &item) {
+        uint32_t head = headIndex.load(std::memory_order_relaxed);
+        if (head - tailCache >= N) {
+            tailCache = tailIndex.load(std::memory_order_acquire);
+            if (head - tailCache >= N) {
+                return false;
+            }
+        }
+        slots[head & (N - 1)] = item;
+        headIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool pop(T &item) {
+        uint32_t tail = tailIndex.load(std::memory_order_relaxed);
+        if (tail == headCache) {
+            headCache = headIndex.load(std::memory_order_acquire);
+            if (tail == headCache) {
+                return false;
+            }
+        }
+        item = slots[tail & (N - 1)];
+        tailIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: the next item without removing it, nullptr if empty
+    const T *peek() {
+        uint32_t tail = tailIndex.load(std::memory_order_relaxed);
+        if (tail == headCache) {
+            headCache = headIndex.load(std::memory_order_acquire);
+            if (tail == headCache) {
+                return nullptr;
+            }
+        }
+        return &slots[tail & (N - 1)];
+    }
+
+    // Either side; only a snapshot while the other side is running
+    uint16_t size() const {
+        return headIndex.load(std::memory_order_acquire) - tailIndex.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+    static constexpr uint16_t capacity() { return N; }
+
+private:
+    T slots[N];
+    std::atomic<uint32_t> headIndex{0};     // Written by the producer only
+    std::atomic<uint32_t> tailIndex{0};     // Written by the consumer only
+    uint32_t tailCache = 0;                 // Producer's last view of tailIndex
+    uint32_t headCache = 0;                 // Consumer's last view of headIndex
+};
+
+template <typename T, uint16_t N>
+class DMRMPSCQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "capacity must be a power of two");
+
+public:
+    DMRMPSCQueue() {
+        for (uint16_t i = 0; i < N; i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Any producer, including an ISR
+    bool push(const T &item) {
+        uint32_t head = headIndex.load(std::memory_order_relaxed);
+        Slot *slot;
+        for (;;) {
+            slot = &slots[head & (N - 1)];
+            int32_t lag = (int32_t)(slot->sequence.load(std::memory_order_acquire) - head);
+            if (lag == 0) {
+                // Free slot for this lap; claim it (a failed CAS reloads head)
+                if (headIndex.compare_exchange_weak(head, head + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (lag < 0) {
+                return false;               // Consumer has not freed it yet: full
+            } else {
+                head = headIndex.load(std::memory_order_relaxed);
+            }
+        }
+        slot->value = item;
+        slot->sequence.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only
+    bool pop(T &item) {
+        uint32_t tail = tailIndex.load(std::memory_order_relaxed);
+        Slot &slot = slots[tail & (N - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != tail + 1) {
+            return false;                   // Empty, or the producer is still filling it
+        }
+        item = slot.value;
+        slot.sequence.store(tail + N, std::memory_order_release);
+        tailIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Claimed slots, including ones still being filled; a snapshot
+    uint16_t size() const {
+        return headIndex.load(std::memory_order_acquire) - tailIndex.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+    static constexpr uint16_t capacity() { return N; }
+
+private:
+    struct Slot {
+        std::atomic<uint32_t> sequence;     // Lap position: free at i, filled at i + 1
+        T value;
+    };
+
+    Slot slots[N];
+    std::atomic<uint32_t> headIndex{0};     // Next slot a producer claims
+    std::atomic<uint32_t> tailIndex{0};     // Next slot the consumer reads
+};
@@ -0,0 +1,252 @@
+#include "DMR828S_scan.h"
+
+DMRChannelScanner::DMRChannelScanner(DMR828S &dmr) : dmr(dmr) {
+}
+
+bool DMRChannelScanner::start(uint16_t channelMask, uint32_t dwellMs, ScanDoneCallback callback,
+                              void *context, uint8_t restoreChannel) {
+    if (state != SCAN_IDLE || (channelMask & DMR_SCAN_ALL_CHANNELS) == 0) {
+        return false;
+    }
+    // Switching channels would strand a message or a transaction mid-way
+    if (dmr.getSMSQueueLength() > 0 || dmr.isConfigRunning()) {
+        return false;
+    }
+    ackSubscription = dmr.subscribeFrame(DMR_CMD_SET_CHANNEL, onChannelFrame, this);
+    if (ackSubscription == DMR_INVALID_SUBSCRIPTION) {
+        return false;
+    }
+
+    this->callback = callback;
+    this->context = context;
+    dwell = dwellMs;
+    attempts = 0;
+    restored = false;
+    aborted = false;
+    resultCount = 0;
+    for (uint8_t ch = 1; ch <= DMR_SCAN_MAX_CHANNELS; ch++) {
+        if (channelMask & (1U << (ch - 1))) {
+            results[resultCount] = DMRChannelScanResult();
+            results[resultCount].channel = ch;
+            resultCount++;
+        }
+    }
+    index = 0;
+
+    uint32_t cached;
+    if (restoreChannel) {
+        originalChannel = restoreChannel;
+    } else if (dmr.getCached(SHADOW_CHANNEL, cached)) {
+        originalChannel = cached;
+    } else {
+        originalChannel = 0;
+        enter(SCAN_ORIGINAL);
+        return true;
+    }
+    switchTo(results[0].channel);
+    return true;
+}
+
+void DMRChannelScanner::abort() {
+    if (state == SCAN_IDLE || state == SCAN_RESTORING) {
+        return;
+    }
+    if (state == SCAN_ORIGINAL) {
+        // Nothing switched yet
+        dmr.cancelRequest(DMR_CMD_CHANNEL_PARAMS);
+        querying = false;
+        finish();
+        return;
+    }
+    // Acks carry no channel, so a switch in flight is seen through before restoring
+    aborted = true;
+}
+
+uint8_t DMRChannelScanner::getCurrentChannel() const {
+    if (state == SCAN_SWITCHING || state == SCAN_SETTLING || state == SCAN_DWELL) {
+        return results[index].channel;
+    }
+    return 0;
+}
+
+uint8_t DMRChannelScanner::getBestChannel() const {
+    const DMRChannelScanResult *best = nullptr;
+    for (uint8_t i = 0; i < resultCount; i++) {
+        const DMRChannelScanResult &r = results[i];
+        if (!r.switched || r.samples == 0) {
+            continue;
+        }
+        if (!best || r.occupancy() < best->occupancy() ||
+            (r.occupancy() == best->occupancy() && r.rssiMean() < best->rssiMean())) {
+            best = &r;
+        }
+    }
+    return best ? best->channel : 0;
+}
+
+/********************************************************
+ * STATE MACHINE
+ ********************************************************/
+
+void DMRChannelScanner::enter(ScanState next) {
+    state = next;
+    stateAt = millis();
+}
+
+void DMRChannelScanner::switchTo(uint8_t channel) {
+    // setChannel() goes through the shadow registers, so the cache follows the scan
+    dmr.setChannel(channel);
+    enter(state == SCAN_RESTORING ? SCAN_RESTORING : SCAN_SWITCHING);
+}
+
+void DMRChannelScanner::nextChannel() {
+    if (!aborted && index + 1 < resultCount) {
+        index++;
+        attempts = 0;
+        switchTo(results[index].channel);
+        return;
+    }
+    // All channels done; go back where we started
+    if (originalChannel == 0) {
+        finish();
+        return;
+    }
+    attempts = 0;
+    state = SCAN_RESTORING;
+    switchTo(originalChannel);
+}
+
+void DMRChannelScanner::finish() {
+    dmr.unsubscribe(ackSubscription);
+    ackSubscription = DMR_INVALID_SUBSCRIPTION;
+    enter(SCAN_IDLE);
+    if (callback) {
+        callback(*this, context);
+    }
+}
+
+void DMRChannelScanner::handleAck(bool ok) {
+    if (state == SCAN_SWITCHING) {
+        if (ok) {
+            results[index].switched = true;
+            enter(SCAN_SETTLING);
+        } else if (++attempts < DMR_SCAN_SWITCH_ATTEMPTS) {
+            switchTo(results[index].channel);
+        } else {
+            nextChannel();
+        }
+    } else if (state == SCAN_RESTORING) {
+        if (ok) {
+            restored = true;
+            finish();
+        } else if (++attempts < DMR_SCAN_SWITCH_ATTEMPTS) {
+            switchTo(originalChannel);
+        } else {
+            finish();
+        }
+    }
+}
+
+void DMRChannelScanner::update() {
+    unsigned long now = millis();
+    switch (state) {
+        case SCAN_SWITCHING:
+        case SCAN_RESTORING:
+            if (now - stateAt > DMR_SCAN_ACK_TIMEOUT_MS) {
+                handleAck(false);
+            }
+            break;
+
+        case SCAN_SETTLING:
+            if (aborted) {
+                nextChannel();
+            } else if (now - stateAt >= DMR_SCAN_SETTLE_MS) {
+                enter(SCAN_DWELL);
+            }
+            break;
+
+        case SCAN_DWELL:
+            if (querying) {
+                break;
+            }
+            if (aborted || now - stateAt >= dwell) {
+                nextChannel();
+                break;
+            }
+            {
+                // Back-to-back RSSI + status pairs; a busy 0x05 slot is retried next time
+                uint8_t data = 0x01;
+                if (dmr.sendRequest(DMR_CMD_RSSI, &data, 1, onRSSI, this, DMR_SCAN_QUERY_TIMEOUT_MS)) {
+                    querying = true;
+                }
+            }
+            break;
+
+        case SCAN_ORIGINAL:
+            if (!querying) {
+                if (dmr.requestChannelParams(onOriginal, this)) {
+                    querying = true;
+                }
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/********************************************************
+ * RESPONSES
+ ********************************************************/
+
+void DMRChannelScanner::onChannelFrame(const DMRFrameView &frame, void *context) {
+    if (frame.rw == 0x00) {
+        ((DMRChannelScanner *)context)->handleAck(frame.sr == RESPONSE_OK);
+    }
+}
+
+void DMRChannelScanner::onOriginal(bool ok, const DMRFrameView &response, void *context) {
+    DMRChannelScanner *self = (DMRChannelScanner *)context;
+    self->querying = false;
+    if (self->state != SCAN_ORIGINAL) {
+        return;
+    }
+    // Without knowing where to return, scanning would leave the radio elsewhere
+    DMRChannelParams params;
+    if (!ok || !self->dmr.parseChannelParams(response.data, response.length, params)) {
+        self->finish();
+        return;
+    }
+    self->originalChannel = params.channel;
+    self->switchTo(self->results[0].channel);
+}
+
+void DMRChannelScanner::onRSSI(bool ok, const DMRFrameView &response, void *context) {
+    DMRChannelScanner *self = (DMRChannelScanner *)context;
+    if (!ok || response.length < 1) {
+        self->querying = false;
+        return;
+    }
+    self->sampleRSSI = response.data[0];
+    uint8_t data = 0x01;
+    if (!self->dmr.sendRequest(DMR_CMD_CHECK_STATUS, &data, 1, onStatus, self, DMR_SCAN_QUERY_TIMEOUT_MS)) {
+        self->querying = false;
+    }
+}
+
+void DMRChannelScanner::onStatus(bool ok, const DMRFrameView &response, void *context) {
+    DMRChannelScanner *self = (DMRChannelScanner *)context;
+    self->querying = false;
+    if (!ok || response.length < 1 || self->state != SCAN_DWELL) {
+        return;
+    }
+    DMRChannelScanResult &r = self->results[self->index];
+    uint8_t rssi = self->sampleRSSI;
+    if (r.samples == 0 || rssi < r.rssiMin) r.rssiMin = rssi;
+    if (r.samples == 0 || rssi > r.rssiMax) r.rssiMax = rssi;
+    r.rssiSum += rssi;
+    r.samples++;
+    if (response.data[0] == STATUS_RECEIVING) {
+        r.busy++;
+    }
+}
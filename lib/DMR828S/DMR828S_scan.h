@@ -0,0 +1,96 @@
+#pragma once
+#include <Arduino.h>
+#include "DMR828S.h"
+
+// Channel occupancy scanner.
+//
+// Steps the module through a set of channels, dwelling on each while it
+// samples RSSI (0x05) and module status (0x04) back to back, then switches
+// back to the channel it started on. Everything runs from update() on the
+// async request table and a 0x01 frame subscription, so events keep being
+// dispatched while a scan is in progress. A channel counts as occupied for
+// the samples that find the module receiving.
+
+#define DMR_SCAN_MAX_CHANNELS       16
+#define DMR_SCAN_ALL_CHANNELS       0xFFFF      // Bit n-1 selects channel n
+#define DMR_SCAN_DEFAULT_DWELL_MS   300
+#define DMR_SCAN_SETTLE_MS          30          // After the switch ack, before sampling
+#define DMR_SCAN_ACK_TIMEOUT_MS     500
+#define DMR_SCAN_QUERY_TIMEOUT_MS   300
+#define DMR_SCAN_SWITCH_ATTEMPTS    2
+
+struct DMRChannelScanResult {
+    uint8_t channel = 0;
+    bool switched = false;          // The module acked the switch; otherwise nothing was sampled
+    uint16_t samples = 0;
+    uint16_t busy = 0;              // Samples with the module receiving
+    uint8_t rssiMin = 0;
+    uint8_t rssiMax = 0;
+    uint32_t rssiSum = 0;
+
+    uint8_t occupancy() const { return samples ? (uint32_t)busy * 100 / samples : 0; }
+    uint8_t rssiMean() const { return samples ? rssiSum / samples : 0; }
+};
+
+class DMRChannelScanner {
+public:
+    typedef void (*ScanDoneCallback)(const DMRChannelScanner &scanner, void *context);
+
+    DMRChannelScanner(DMR828S &dmr);
+
+    // restoreChannel 0 = the module's current channel (cached, else queried).
+    // False if a scan is running, the mask is empty, or an SMS or config
+    // transaction would be disturbed by switching channels.
+    bool start(uint16_t channelMask = DMR_SCAN_ALL_CHANNELS, uint32_t dwellMs = DMR_SCAN_DEFAULT_DWELL_MS,
+               ScanDoneCallback callback = nullptr, void *context = nullptr, uint8_t restoreChannel = 0);
+    void abort();                   // Skips the remaining channels; still restores the original
+    void update();                  // Call from loop() after dmr.update()
+
+    bool isRunning() const { return state != SCAN_IDLE; }
+    uint8_t getCurrentChannel() const;              // Channel being scanned, 0 if none
+    uint8_t getOriginalChannel() const { return originalChannel; }
+    bool wasRestored() const { return restored; }
+
+    uint8_t getResultCount() const { return resultCount; }
+    const DMRChannelScanResult& getResult(uint8_t index) const { return results[index]; }
+    // Least occupied scanned channel, quietest RSSI on a tie; 0 if none was scanned
+    uint8_t getBestChannel() const;
+
+private:
+    enum ScanState : uint8_t {
+        SCAN_IDLE = 0,
+        SCAN_ORIGINAL,              // Asking which channel to come back to
+        SCAN_SWITCHING,
+        SCAN_SETTLING,
+        SCAN_DWELL,
+        SCAN_RESTORING
+    };
+
+    DMR828S &dmr;
+    ScanState state = SCAN_IDLE;
+    DMRSubscription ackSubscription = DMR_INVALID_SUBSCRIPTION;
+    ScanDoneCallback callback = nullptr;
+    void *context = nullptr;
+    uint32_t dwell = DMR_SCAN_DEFAULT_DWELL_MS;
+    uint8_t originalChannel = 0;
+    bool restored = false;
+    bool aborted = false;
+
+    DMRChannelScanResult results[DMR_SCAN_MAX_CHANNELS];
+    uint8_t resultCount = 0;
+    uint8_t index = 0;              // Result being filled
+    uint8_t attempts = 0;
+    unsigned long stateAt = 0;      // When the current state started
+    bool querying = false;          // Original-channel query or a sample in flight
+    uint8_t sampleRSSI = 0;
+
+    void enter(ScanState next);
+    void switchTo(uint8_t channel);
+    void nextChannel();
+    void finish();
+    void handleAck(bool ok);
+    static void onChannelFrame(const DMRFrameView &frame, void *context);
+    static void onOriginal(bool ok, const DMRFrameView &response, void *context);
+    static void onRSSI(bool ok, const DMRFrameView &response, void *context);
+    static void onStatus(bool ok, const DMRFrameView &response, void *context);
+};
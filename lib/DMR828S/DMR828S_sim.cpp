@@ -0,0 +1,486 @@
+#include "DMR828S_sim.h"
+
+DMR828S_Simulator::DMR828S_Simulator() : wire(*this) {
+    // Checksums are verified here against the full-frame rule in the protocol
+    wire.checksumEnabled = false;
+    wire.debug = false;
+}
+
+void DMR828S_Simulator::reset() {
+    resetSettings();
+
+    lastCaller = 0;
+    lastCallType = 0;
+    lastSmsSource = 0;
+    lastSmsLength = 0;
+    lastSent = DMRSimSMS();
+    stats = DMRSimStats();
+
+    pendingCount = 0;
+    outHead = 0;
+    outCount = 0;
+    wire.resetParser();
+}
+
+// What the module holds after power-up
+void DMR828S_Simulator::resetSettings() {
+    channel = 1;
+    volume = 5;
+    status = 0x03;
+    rssi = 0x20;
+    radioID = 0x000001;
+    contactID = 0x000001;
+    encryptionOn = false;
+    txFreq = 0;
+    rxFreq = 0;
+}
+
+
+
+/********************************************************
+ * STREAM INTERFACE
+ ********************************************************/
+int DMR828S_Simulator::available() {
+    release();
+    return outCount;
+}
+
+int DMR828S_Simulator::read() {
+    release();
+    if (outCount == 0)
+        return -1;
+
+    uint16_t tail = (outHead - outCount) & (DMR_SIM_OUT_RING_SIZE - 1);
+    outCount--;
+    return outRing[tail];
+}
+
+int DMR828S_Simulator::peek() {
+    release();
+    if (outCount == 0)
+        return -1;
+
+    return outRing[(outHead - outCount) & (DMR_SIM_OUT_RING_SIZE - 1)];
+}
+
+size_t DMR828S_Simulator::write(uint8_t b) {
+    return write(&b, 1);
+}
+
+size_t DMR828S_Simulator::write(const uint8_t *buf, size_t len) {
+    size_t done = 0;
+
+    // Parse as we go so a burst larger than the parser ring still gets through
+    while (done < len) {
+        size_t accepted = wire.feed(&buf[done], len - done);
+        processInput();
+        if (accepted == 0)
+            break;
+        done += accepted;
+    }
+
+    return done;
+}
+
+
+
+/********************************************************
+ * RESPONSE SCHEDULING
+ ********************************************************/
+uint32_t DMR828S_Simulator::nextRandom() {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+void DMR828S_Simulator::schedule(uint8_t cmd, uint8_t rw, uint8_t sr,
+                                 const uint8_t *data, uint16_t len, uint32_t delayUs) {
+    if (len > DMR_MAX_PAYLOAD)
+        len = DMR_MAX_PAYLOAD;
+
+    if (config.dropPercent && nextRandom() % 100 < config.dropPercent) {
+        stats.dropped++;
+        return;
+    }
+    if (pendingCount >= DMR_SIM_MAX_PENDING) {
+        stats.dropped++;
+        return;
+    }
+
+    PendingFrame &f = pending[pendingCount];
+    uint16_t pos = 0;
+    f.bytes[pos++] = DMR_FRAME_HEAD;
+    f.bytes[pos++] = cmd;
+    f.bytes[pos++] = rw;
+    f.bytes[pos++] = sr;
+    f.bytes[pos++] = 0x00;
+    f.bytes[pos++] = 0x00;
+    f.bytes[pos++] = len >> 8;
+    f.bytes[pos++] = len & 0xFF;
+    if (len > 0)
+        memcpy(&f.bytes[pos], data, len);
+    pos += len;
+    f.bytes[pos++] = DMR_FRAME_TAIL;
+
+    uint16_t chk = frameChecksum(f.bytes, pos);
+    f.bytes[4] = chk >> 8;
+    f.bytes[5] = chk & 0xFF;
+
+    if (config.corruptPercent && nextRandom() % 100 < config.corruptPercent) {
+        f.bytes[nextRandom() % pos] ^= 1 + nextRandom() % 255;
+        stats.corrupted++;
+    }
+
+    if (config.jitterUs)
+        delayUs += nextRandom() % (config.jitterUs + 1);
+
+    f.length = pos;
+    f.dueUs = micros() + delayUs;
+    pendingCount++;
+    stats.responses++;
+}
+
+void DMR828S_Simulator::respond(uint8_t cmd, uint8_t sr, const uint8_t *data, uint16_t len) {
+    schedule(cmd, 0x00, sr, data, len, config.latencyUs);
+}
+
+// Move responses whose time has come onto the wire, oldest first
+void DMR828S_Simulator::release() {
+    uint32_t now = micros();
+    uint8_t i = 0;
+
+    while (i < pendingCount) {
+        PendingFrame &f = pending[i];
+        if ((int32_t)(now - f.dueUs) < 0 || DMR_SIM_OUT_RING_SIZE - outCount < f.length) {
+            i++;
+            continue;
+        }
+
+        for (uint16_t b = 0; b < f.length; b++) {
+            outRing[outHead] = f.bytes[b];
+            outHead = (outHead + 1) & (DMR_SIM_OUT_RING_SIZE - 1);
+        }
+        outCount += f.length;
+
+        pendingCount--;
+        for (uint8_t j = i; j < pendingCount; j++)
+            pending[j] = pending[j + 1];
+    }
+}
+
+
+
+/********************************************************
+ * COMMAND HANDLING
+ ********************************************************/
+void DMR828S_Simulator::processInput() {
+    DMRFrameView view;
+    while (wire.parseFrame(view)) {
+        handleCommand(view);
+    }
+}
+
+void DMR828S_Simulator::handleCommand(const DMRFrameView &f) {
+    stats.commands++;
+
+    // The module only acts on writes; anything else from the host is ignored
+    if (f.rw != 0x01)
+        return;
+
+    // A zero checksum means "not calculated" and is accepted (protocol 1.3)
+    if (config.verifyChecksum && f.checksum != 0x0000) {
+        uint8_t frame[DMR_FRAME_OVERHEAD + DMR_MAX_PAYLOAD];
+        frame[0] = DMR_FRAME_HEAD;
+        frame[1] = f.cmd;
+        frame[2] = f.rw;
+        frame[3] = f.sr;
+        frame[4] = 0x00;
+        frame[5] = 0x00;
+        frame[6] = f.length >> 8;
+        frame[7] = f.length & 0xFF;
+        memcpy(&frame[DMR_FRAME_HEADER_LEN], f.data, f.length);
+        frame[DMR_FRAME_HEADER_LEN + f.length] = DMR_FRAME_TAIL;
+
+        if (frameChecksum(frame, DMR_FRAME_OVERHEAD + f.length) != f.checksum) {
+            stats.checksumErrors++;
+            respond(f.cmd, 0x09);
+            return;
+        }
+    }
+
+    const uint8_t *d = f.data;
+    uint8_t out[20];
+
+    switch (f.cmd) {
+        case 0x01:  // Channel
+            if (f.length >= 1 && d[0] >= 1 && d[0] <= 16) {
+                channel = d[0];
+                txFreq = 0;         // The new channel brings its own frequencies
+                rxFreq = 0;
+                respond(f.cmd, 0x00);
+            } else {
+                respond(f.cmd, 0x01);
+            }
+            break;
+
+        case 0x02:  // Volume
+            if (f.length >= 1 && d[0] >= 1 && d[0] <= 9) {
+                volume = d[0];
+                respond(f.cmd, 0x00);
+            } else {
+                respond(f.cmd, 0x01);
+            }
+            break;
+
+        case 0x04:  // Module status
+            respond(f.cmd, 0x00, &status, 1);
+            break;
+
+        case 0x05:  // RSSI
+            respond(f.cmd, 0x00, &rssi, 1);
+            break;
+
+        case 0x06:  // Call out start/stop
+            if (f.sr == 0x01) {
+                bool typeOk = f.length >= 4 && (d[0] == 0x00 || d[0] == 0x01 || d[0] == 0x02 || d[0] == 0x04);
+                if (!typeOk || status == 0x01) {
+                    respond(f.cmd, 0x01);
+                    break;
+                }
+                status = 0x02;
+                schedule(f.cmd, 0x02, 0x61, d, 4, config.latencyUs);
+            } else if (f.sr == 0xFF) {
+                if (status == 0x02) {
+                    status = 0x03;
+                    schedule(f.cmd, 0x02, 0x62, nullptr, 0, config.latencyUs);
+                }
+            }
+            break;
+
+        case 0x07:  // SMS TX
+            if (f.length < 4) {
+                respond(f.cmd, 0x7E);
+                break;
+            }
+            if (config.smsBusyPercent && nextRandom() % 100 < config.smsBusyPercent) {
+                stats.smsBusy++;
+                respond(f.cmd, 0x01);   // Busy, nothing sent
+                break;
+            }
+            lastSent.type = d[0];
+            lastSent.targetID = getID(&d[1]);
+            lastSent.length = f.length - 4;
+            memcpy(lastSent.data, &d[4], lastSent.length);
+            stats.smsSent++;
+            {
+                bool fail = config.smsFailPercent && nextRandom() % 100 < config.smsFailPercent;
+                schedule(f.cmd, 0x00, fail ? 0x7E : 0x71, nullptr, 0, config.smsLatencyUs);
+            }
+            break;
+
+        case 0x09:  // Emergency alarm
+            respond(f.cmd, 0x00);
+            break;
+
+        case 0x10:  // Calling-in contact
+            out[0] = lastCallType;
+            putID(&out[1], lastCaller);
+            respond(f.cmd, 0x01, out, 4);
+            break;
+
+        case 0x11:  // Last SMS content
+            {
+                uint8_t sms[DMR_MAX_PAYLOAD];
+                uint16_t n = lastSmsLength > DMR_MAX_PAYLOAD - 3 ? DMR_MAX_PAYLOAD - 3 : lastSmsLength;
+                putID(sms, lastSmsSource);
+                memcpy(&sms[3], lastSmsData, n);
+                respond(f.cmd, 0x01, sms, lastSmsLength ? n + 3 : 0);
+            }
+            break;
+
+        case 0x18:  // Contact
+            if (f.length >= 4) contactID = getID(&d[1]);
+            respond(f.cmd, 0x00);
+            break;
+
+        case 0x19:  // Encryption on/off
+            if (f.length >= 1) encryptionOn = (d[0] == 0x01);
+            respond(f.cmd, 0x00);
+            break;
+
+        case 0x1A:  // Initialization status
+            out[0] = 0x00;
+            respond(f.cmd, 0x00, out, 1);
+            break;
+
+        case 0x1B:  // Radio ID
+            if (f.length >= 3) radioID = getID(d);
+            respond(f.cmd, 0x00);
+            break;
+
+        case 0x0D:  // TX/RX frequency
+            if (f.length >= 8) {
+                txFreq = ((uint32_t)d[0] << 24) | ((uint32_t)d[1] << 16) | ((uint32_t)d[2] << 8) | d[3];
+                rxFreq = ((uint32_t)d[4] << 24) | ((uint32_t)d[5] << 16) | ((uint32_t)d[6] << 8) | d[7];
+                respond(f.cmd, 0x00);
+            } else {
+                respond(f.cmd, 0x01);
+            }
+            break;
+
+        case 0x1D:  // Current channel parameters, in the layout parseChannelParams() reads
+            {
+                uint32_t freq = 418125000UL + ((channel - 1) % 8) * 1000000UL;
+                uint32_t tx = txFreq ? txFreq : freq;
+                uint32_t rx = rxFreq ? rxFreq : freq;
+                memset(out, 0, sizeof(out));
+                out[0] = channel;
+                out[1] = tx >> 24; out[2] = tx >> 16; out[3] = tx >> 8; out[4] = tx;
+                out[5] = rx >> 24; out[6] = rx >> 16; out[7] = rx >> 8; out[8] = rx;
+                out[9] = 0x01;          // High power
+                out[10] = 0x00;         // 12.5 kHz
+                out[11] = 0x01;         // Color code
+                out[12] = 0x01;         // Time slot
+                putID(&out[13], contactID);
+                out[16] = encryptionOn ? 1 : 0;
+                respond(f.cmd, 0x00, out, 20);
+            }
+            break;
+
+        case 0x22:  // Contact ID
+            putID(out, contactID);
+            respond(f.cmd, 0x00, out, 3);
+            break;
+
+        case 0x24:  // Radio ID
+            putID(out, radioID);
+            respond(f.cmd, 0x00, out, 3);
+            break;
+
+        case 0x25:  // Firmware version
+            respond(f.cmd, 0x00, (const uint8_t *)"SIM-1.0", 7);
+            break;
+
+        case 0x28:  // Encryption status
+            out[0] = encryptionOn ? 1 : 0;
+            respond(f.cmd, 0x00, out, 1);
+            break;
+
+        case 0xF0:  // Reset to defaults
+            channel = 1;
+            volume = 5;
+            encryptionOn = false;
+            respond(f.cmd, 0x00);
+            break;
+
+        default:
+            // Remaining settings are acknowledged without being modelled
+            stats.unknownCommands++;
+            respond(f.cmd, 0x00);
+            break;
+    }
+}
+
+
+
+/********************************************************
+ * UNSOLICITED UPLOADS
+ ********************************************************/
+void DMR828S_Simulator::injectSMS(uint32_t sourceID, const char *text) {
+    uint8_t data[DMR_MAX_PAYLOAD];
+    uint16_t len = 3;
+
+    putID(data, sourceID);
+
+    // UTF-8 in, UTF-16LE on the wire like the real module
+    len += dmrUtf8ToUtf16le(text, strlen(text), &data[len], DMR_MAX_PAYLOAD - len);
+
+    lastSmsSource = sourceID;
+    lastSmsLength = len - 3;
+    memcpy(lastSmsData, &data[3], lastSmsLength);
+
+    schedule(0x07, 0x02, 0x70, data, len, config.latencyUs);
+}
+
+void DMR828S_Simulator::injectCallStart(uint8_t callType, uint32_t callerID) {
+    uint8_t data[4];
+    data[0] = callType;
+    putID(&data[1], callerID);
+
+    lastCallType = callType;
+    lastCaller = callerID;
+    status = 0x01;
+
+    schedule(0x06, 0x02, 0x60, data, 4, config.latencyUs);
+}
+
+void DMR828S_Simulator::injectCallEnd() {
+    status = 0x03;
+    schedule(0x06, 0x02, 0x6F, nullptr, 0, config.latencyUs);
+}
+
+void DMR828S_Simulator::injectCallOut(uint8_t callType, uint32_t targetID) {
+    uint8_t data[4];
+    data[0] = callType;
+    putID(&data[1], targetID);
+
+    status = 0x02;
+    schedule(0x06, 0x02, 0x61, data, 4, config.latencyUs);
+}
+
+void DMR828S_Simulator::injectCallOutEnd(bool failed) {
+    status = 0x03;
+    schedule(0x06, 0x02, failed ? 0x6D : 0x62, nullptr, 0, config.latencyUs);
+}
+
+void DMR828S_Simulator::injectEmergency(uint32_t sourceID) {
+    uint8_t data[3];
+    putID(data, sourceID);
+    schedule(0x09, 0x02, 0x91, data, 3, config.latencyUs);
+}
+
+void DMR828S_Simulator::injectChannelChange(uint8_t newChannel) {
+    channel = newChannel;
+    txFreq = 0;
+    rxFreq = 0;
+    schedule(0x01, 0x02, 0x00, &channel, 1, config.latencyUs);
+}
+
+void DMR828S_Simulator::injectRestart() {
+    resetSettings();
+    uint8_t initialized = 0x00;
+    schedule(0x1A, 0x02, 0x00, &initialized, 1, config.latencyUs);
+}
+
+
+
+/********************************************************
+ * HELPERS
+ ********************************************************/
+
+// Protocol 1.3: 16-bit one's-complement sum over the whole frame with the
+// checksum field zeroed, e.g. 68 01 01 01 95 EC 00 01 01 10
+uint16_t DMR828S_Simulator::frameChecksum(const uint8_t *frame, uint16_t len) {
+    uint32_t sum = 0;
+
+    for (uint16_t i = 0; i + 1 < len; i += 2)
+        sum += (frame[i] << 8) | frame[i + 1];
+    if (len & 1)
+        sum += frame[len - 1] << 8;
+
+    while (sum >> 16)
+        sum = (sum & 0xFFFF) + (sum >> 16);
+
+    return (uint16_t)(sum ^ 0xFFFF);
+}
+
+void DMR828S_Simulator::putID(uint8_t *out, uint32_t id) {
+    out[0] = (id >> 16) & 0xFF;
+    out[1] = (id >> 8) & 0xFF;
+    out[2] = id & 0xFF;
+}
+
+uint32_t DMR828S_Simulator::getID(const uint8_t *in) {
+    return ((uint32_t)in[0] << 16) | ((uint32_t)in[1] << 8) | in[2];
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include <Arduino.h>
+#include "DMR828S_utils.h"
+#include "DMR828S_text.h"
+
+// Host-side model of a DMR828S module behind a Stream.
+//
+// Hand it to DMR828S / DMR828S_Utils instead of Serial2: frames the library
+// writes are parsed and answered like the module would (see DM828_PROTOCOL.md),
+// and responses come back through available()/read() after a configurable
+// latency, optionally dropped or corrupted. Only Stream, micros() and
+// millis() are used, so it builds anywhere the library does, including a
+// host Arduino shim.
+
+// Responses waiting for their delivery time
+#ifndef DMR_SIM_MAX_PENDING
+#define DMR_SIM_MAX_PENDING     8
+#endif
+
+// Bytes released to the reader but not yet read
+#ifndef DMR_SIM_OUT_RING_SIZE
+#define DMR_SIM_OUT_RING_SIZE   1024
+#endif
+
+struct DMRSimConfig {
+    uint32_t latencyUs = 2000;          // Command -> response delay
+    uint32_t jitterUs = 0;              // Random extra delay, 0..jitterUs
+    uint32_t smsLatencyUs = 300000;     // SMS TX -> 0x71/0x7E result
+    uint8_t dropPercent = 0;            // Chance a response frame is lost
+    uint8_t corruptPercent = 0;         // Chance one byte of a response is flipped
+    uint8_t smsFailPercent = 0;         // Chance an SMS TX reports 0x7E
+    uint8_t smsBusyPercent = 0;         // Chance an SMS TX is refused busy (S/R 0x01)
+    bool verifyChecksum = true;         // Reject non-zero checksums that do not match (S/R 0x09)
+};
+
+struct DMRSimStats {
+    uint32_t commands = 0;              // Frames received from the host
+    uint32_t checksumErrors = 0;        // Commands answered with S/R 0x09
+    uint32_t unknownCommands = 0;       // Acked without modelling
+    uint32_t responses = 0;             // Frames scheduled for the host
+    uint32_t dropped = 0;               // Lost to dropPercent or a full pending table
+    uint32_t corrupted = 0;
+    uint32_t smsSent = 0;
+    uint32_t smsBusy = 0;
+};
+
+// Last SMS the host transmitted (raw payload after the 4-byte header)
+struct DMRSimSMS {
+    uint8_t type = 0;
+    uint32_t targetID = 0;
+    uint8_t data[DMR_MAX_PAYLOAD];
+    uint16_t length = 0;
+};
+
+class DMR828S_Simulator : public Stream {
+public:
+    DMR828S_Simulator();
+
+    DMRSimConfig config;
+
+    // Module state (readable and writable by tests)
+    uint8_t channel = 1;
+    uint8_t volume = 5;
+    uint8_t status = 0x03;              // 0x01 receiving, 0x02 transmitting, 0x03 standby
+    uint8_t rssi = 0x20;
+    uint32_t radioID = 0x000001;
+    uint32_t contactID = 0x000001;
+    bool encryptionOn = false;
+    uint32_t txFreq = 0;                // Set by 0x0D; 0 = the channel's own frequency
+    uint32_t rxFreq = 0;
+
+    void setSeed(uint32_t seed) { rng = seed ? seed : 1; }
+    void reset();                       // Module state, queues and stats
+    const DMRSimStats& getStats() const { return stats; }
+    const DMRSimSMS& getLastSentSMS() const { return lastSent; }
+
+    // Unsolicited uploads (R/W = 0x02), delivered after config.latencyUs
+    void injectSMS(uint32_t sourceID, const char *text);           // UTF-8
+    void injectCallStart(uint8_t callType, uint32_t callerID);     // S/R 0x60
+    void injectCallEnd();                                           // S/R 0x6F
+    void injectCallOut(uint8_t callType, uint32_t targetID);       // S/R 0x61 (PTT pressed)
+    void injectCallOutEnd(bool failed = false);                     // S/R 0x62, or 0x6D
+    void injectEmergency(uint32_t sourceID);                        // 0x09 S/R 0x91
+    void injectChannelChange(uint8_t newChannel);                   // 0x01 (front-panel knob)
+    void injectRestart();               // Settings back to defaults, then 0x1A (power dip, watchdog)
+
+    // Responses still waiting for their delivery time
+    uint8_t pendingResponses() const { return pendingCount; }
+
+    // Stream interface (library side)
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t b) override;
+    size_t write(const uint8_t *buf, size_t len) override;
+    using Print::write;
+    void flush() override {}
+
+private:
+    struct PendingFrame {
+        uint32_t dueUs;
+        uint16_t length;
+        uint8_t bytes[DMR_FRAME_OVERHEAD + DMR_MAX_PAYLOAD];
+    };
+
+    DMR828S_Utils wire;                 // Parses host -> module bytes
+    DMRSimStats stats;
+    DMRSimSMS lastSent;
+    uint32_t lastCaller = 0;
+    uint8_t lastCallType = 0;
+    uint32_t lastSmsSource = 0;
+    uint8_t lastSmsData[DMR_MAX_PAYLOAD];
+    uint16_t lastSmsLength = 0;
+    uint32_t rng = 0x2545F491;
+
+    PendingFrame pending[DMR_SIM_MAX_PENDING];
+    uint8_t pendingCount = 0;
+    uint8_t outRing[DMR_SIM_OUT_RING_SIZE];
+    uint16_t outHead = 0;
+    uint16_t outCount = 0;
+
+    uint32_t nextRandom();
+    void resetSettings();
+    void processInput();
+    void handleCommand(const DMRFrameView &cmd);
+    void respond(uint8_t cmd, uint8_t sr, const uint8_t *data = nullptr, uint16_t len = 0);
+    void schedule(uint8_t cmd, uint8_t rw, uint8_t sr, const uint8_t *data, uint16_t len,
+                  uint32_t delayUs);
+    void release();
+
+    static uint16_t frameChecksum(const uint8_t *frame, uint16_t len);
+    static void putID(uint8_t *out, uint32_t id);
+    static uint32_t getID(const uint8_t *in);
+};
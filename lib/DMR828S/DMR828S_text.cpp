@@ -0,0 +1,136 @@
+#include "DMR828S_text.h"
+
+/********************************************************
+ * UTF-8 -> UTF-16LE
+ ********************************************************/
+size_t dmrUtf8ToUtf16le(const char *in, size_t inLen, uint8_t *out, size_t outCap,
+                        size_t *consumed)
+{
+    const uint8_t *s = (const uint8_t *)in;
+    size_t i = 0;
+    size_t n = 0;
+
+    while (i < inLen) {
+        uint8_t c = s[i];
+        uint32_t cp;
+        uint8_t len;
+
+        if (c < 0x80) {
+            cp = c;
+            len = 1;
+        } else {
+            if ((c & 0xE0) == 0xC0)      { cp = c & 0x1F; len = 2; }
+            else if ((c & 0xF0) == 0xE0) { cp = c & 0x0F; len = 3; }
+            else if ((c & 0xF8) == 0xF0) { cp = c & 0x07; len = 4; }
+            else                         { cp = 0; len = 0; }
+
+            bool ok = len > 0 && i + len <= inLen;
+            for (uint8_t k = 1; ok && k < len; k++) {
+                if ((s[i + k] & 0xC0) != 0x80) ok = false;
+                cp = (cp << 6) | (s[i + k] & 0x3F);
+            }
+            // Overlong forms, surrogates and values past U+10FFFF are not characters
+            if (ok && ((len == 2 && cp < 0x80) || (len == 3 && cp < 0x800) ||
+                       (len == 4 && (cp < 0x10000 || cp > 0x10FFFF)) ||
+                       (cp >= 0xD800 && cp <= 0xDFFF))) {
+                ok = false;
+            }
+            if (!ok) {
+                cp = DMR_UTF_REPLACEMENT;
+                len = 1;
+            }
+        }
+
+        size_t need = cp >= 0x10000 ? 4 : 2;
+        if (n + need > outCap) {
+            break;
+        }
+        if (out) {
+            if (need == 4) {
+                uint32_t v = cp - 0x10000;
+                uint16_t hi = 0xD800 | (v >> 10);
+                uint16_t lo = 0xDC00 | (v & 0x3FF);
+                out[n] = hi & 0xFF;
+                out[n + 1] = hi >> 8;
+                out[n + 2] = lo & 0xFF;
+                out[n + 3] = lo >> 8;
+            } else {
+                out[n] = cp & 0xFF;
+                out[n + 1] = cp >> 8;
+            }
+        }
+        n += need;
+        i += len;
+    }
+
+    if (consumed) {
+        *consumed = i;
+    }
+    return n;
+}
+
+/********************************************************
+ * UTF-16LE -> UTF-8
+ ********************************************************/
+size_t dmrUtf16leToUtf8(const uint8_t *in, size_t inLen, char *out, size_t outCap)
+{
+    if (outCap == 0) {
+        return 0;
+    }
+
+    size_t units = inLen / 2;
+    while (units > 0 && in[2 * units - 2] == 0 && in[2 * units - 1] == 0) {
+        units--;
+    }
+
+    size_t cap = outCap - 1;
+    size_t n = 0;
+    for (size_t u = 0; u < units; u++) {
+        uint32_t cp = in[2 * u] | ((uint16_t)in[2 * u + 1] << 8);
+        size_t used = 1;
+
+        if (cp >= 0xD800 && cp <= 0xDBFF) {
+            uint16_t lo = u + 1 < units ? (in[2 * u + 2] | ((uint16_t)in[2 * u + 3] << 8)) : 0;
+            if (lo >= 0xDC00 && lo <= 0xDFFF) {
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                used = 2;
+            } else {
+                cp = DMR_UTF_REPLACEMENT;
+            }
+        } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+            cp = DMR_UTF_REPLACEMENT;
+        } else if (cp == 0) {
+            continue;   // Embedded NULs would cut the C string short
+        }
+
+        size_t need = cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+        if (n + need > cap) {
+            break;
+        }
+        switch (need) {
+            case 1:
+                out[n] = cp;
+                break;
+            case 2:
+                out[n] = 0xC0 | (cp >> 6);
+                out[n + 1] = 0x80 | (cp & 0x3F);
+                break;
+            case 3:
+                out[n] = 0xE0 | (cp >> 12);
+                out[n + 1] = 0x80 | ((cp >> 6) & 0x3F);
+                out[n + 2] = 0x80 | (cp & 0x3F);
+                break;
+            default:
+                out[n] = 0xF0 | (cp >> 18);
+                out[n + 1] = 0x80 | ((cp >> 12) & 0x3F);
+                out[n + 2] = 0x80 | ((cp >> 6) & 0x3F);
+                out[n + 3] = 0x80 | (cp & 0x3F);
+                break;
+        }
+        n += need;
+        u += used - 1;
+    }
+
+    out[n] = '\0';
+    return n;
+}
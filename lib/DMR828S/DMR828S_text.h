@@ -0,0 +1,21 @@
+#pragma once
+#include <Arduino.h>
+
+// SMS text transcoding: the module carries UTF-16LE on the wire, the
+// library and its callers use UTF-8. Both directions are single pass, write
+// only into the caller's buffer and never allocate. Malformed input becomes
+// U+FFFD; output stops before a code point that does not fit, so a
+// character (or a surrogate pair) is never split.
+
+#define DMR_UTF_REPLACEMENT     0xFFFD
+
+// UTF-8 -> UTF-16LE. Returns bytes written (always even). out may be null to
+// only measure. consumed, if given, receives the input bytes used, which is
+// less than inLen when the output ran out of room.
+size_t dmrUtf8ToUtf16le(const char *in, size_t inLen, uint8_t *out, size_t outCap,
+                        size_t *consumed = nullptr);
+
+// UTF-16LE -> UTF-8, always NUL-terminated when outCap > 0. Returns bytes
+// written excluding the NUL. A trailing odd byte and trailing 0x0000 units
+// (the module pads odd lengths) are ignored.
+size_t dmrUtf16leToUtf8(const uint8_t *in, size_t inLen, char *out, size_t outCap);
@@ -0,0 +1,215 @@
+#include "DMR828S_timer.h"
+
+DMRTimerService::DMRTimerService() {
+    clockMicros = micros();
+}
+
+uint64_t DMRTimerService::now() {
+    // Called at least once per micros() wrap (71 min) by any service that has a timer
+    uint32_t us = micros();
+    clockUs += (uint32_t)(us - clockMicros);
+    clockMicros = us;
+    return clockUs;
+}
+
+/********************************************************
+ * START / CANCEL
+ ********************************************************/
+
+DMRTimerId DMRTimerService::startOnce(uint32_t delayMs, DMRTimerCallback callback, void *context,
+                                      const char *name) {
+    return start(delayMs, 0, callback, context, name);
+}
+
+DMRTimerId DMRTimerService::startPeriodic(uint32_t periodMs, DMRTimerCallback callback, void *context,
+                                          const char *name) {
+    if (periodMs == 0) {
+        return DMR_INVALID_TIMER;
+    }
+    return start(periodMs, periodMs, callback, context, name);
+}
+
+DMRTimerId DMRTimerService::start(uint32_t delayMs, uint32_t periodMs, DMRTimerCallback callback,
+                                  void *context, const char *name) {
+    if (!callback || count >= DMR_TIMER_MAX) {
+        return DMR_INVALID_TIMER;
+    }
+    uint8_t index = 0;
+    while (timers[index].heapIndex != 0xFF) {
+        index++;
+    }
+    Timer &timer = timers[index];
+    timer.deadlineUs = now() + (uint64_t)delayMs * 1000;
+    timer.periodMs = periodMs;
+    timer.callback = callback;
+    timer.context = context;
+    timer.name = name;
+    timer.stats = DMRTimerStats();
+
+    place(count, index);
+    count++;
+    siftUp(count - 1);
+    return ((DMRTimerId)timer.generation << 8) | index;
+}
+
+int16_t DMRTimerService::find(DMRTimerId id) const {
+    uint8_t index = id & 0xFF;
+    if (id == DMR_INVALID_TIMER || index >= DMR_TIMER_MAX) {
+        return -1;
+    }
+    const Timer &timer = timers[index];
+    if (timer.heapIndex == 0xFF || timer.generation != (id >> 8)) {
+        return -1;
+    }
+    return index;
+}
+
+bool DMRTimerService::isActive(DMRTimerId id) const {
+    return find(id) >= 0;
+}
+
+bool DMRTimerService::cancel(DMRTimerId id) {
+    int16_t index = find(id);
+    if (index < 0) {
+        return false;
+    }
+    release(index);
+    return true;
+}
+
+// Takes the timer out of the heap and retires its id
+void DMRTimerService::release(uint8_t index) {
+    Timer &timer = timers[index];
+    uint8_t pos = timer.heapIndex;
+    count--;
+    if (pos != count) {
+        // Move the last entry into the hole; it may belong above or below it
+        uint8_t moved = heap[count];
+        place(pos, moved);
+        siftUp(pos);
+        if (timers[moved].heapIndex == pos) {
+            siftDown(pos);
+        }
+    }
+    timer.heapIndex = 0xFF;
+    timer.generation = timer.generation == 0xFF ? 1 : timer.generation + 1;
+}
+
+/********************************************************
+ * HEAP
+ ********************************************************/
+
+void DMRTimerService::place(uint8_t pos, uint8_t index) {
+    heap[pos] = index;
+    timers[index].heapIndex = pos;
+}
+
+void DMRTimerService::siftUp(uint8_t pos) {
+    uint8_t index = heap[pos];
+    uint64_t deadline = timers[index].deadlineUs;
+    while (pos > 0) {
+        uint8_t parent = (pos - 1) / 2;
+        if (timers[heap[parent]].deadlineUs <= deadline) {
+            break;
+        }
+        place(pos, heap[parent]);
+        pos = parent;
+    }
+    place(pos, index);
+}
+
+void DMRTimerService::siftDown(uint8_t pos) {
+    uint8_t index = heap[pos];
+    uint64_t deadline = timers[index].deadlineUs;
+    for (;;) {
+        uint8_t child = pos * 2 + 1;
+        if (child >= count) {
+            break;
+        }
+        if (child + 1 < count && timers[heap[child + 1]].deadlineUs < timers[heap[child]].deadlineUs) {
+            child++;
+        }
+        if (deadline <= timers[heap[child]].deadlineUs) {
+            break;
+        }
+        place(pos, heap[child]);
+        pos = child;
+    }
+    place(pos, index);
+}
+
+/********************************************************
+ * RUN
+ ********************************************************/
+
+uint32_t DMRTimerService::run() {
+    runs++;
+    // Only what was due on entry: a callback longer than its period cannot keep this loop going
+    uint64_t due = now();
+    while (count > 0 && timers[heap[0]].deadlineUs <= due) {
+        uint8_t index = heap[0];
+        Timer &timer = timers[index];
+        uint64_t firedAt = now();
+        uint32_t late = firedAt - timer.deadlineUs;
+        timer.stats.fired++;
+        timer.stats.lastLateUs = late;
+        timer.stats.sumLateUs += late;
+        if (late > timer.stats.maxLateUs) {
+            timer.stats.maxLateUs = late;
+        }
+
+        DMRTimerCallback callback = timer.callback;
+        void *context = timer.context;
+        if (timer.periodMs) {
+            uint64_t periodUs = (uint64_t)timer.periodMs * 1000;
+            timer.deadlineUs += periodUs;
+            if (timer.deadlineUs <= firedAt) {
+                uint32_t skipped = (firedAt - timer.deadlineUs) / periodUs + 1;
+                timer.stats.missed += skipped;
+                timer.deadlineUs += skipped * periodUs;
+            }
+            siftDown(0);
+        } else {
+            release(index);
+        }
+        callback(context);
+    }
+    return msUntilNext();
+}
+
+uint32_t DMRTimerService::msUntilNext() const {
+    if (count == 0) {
+        return DMR_TIMER_NEVER;
+    }
+    uint64_t nowUs = clockUs + (uint32_t)(micros() - clockMicros);
+    uint64_t deadline = timers[heap[0]].deadlineUs;
+    if (deadline <= nowUs) {
+        return 0;
+    }
+    uint64_t ms = (deadline - nowUs + 999) / 1000;
+    return ms >= DMR_TIMER_NEVER ? DMR_TIMER_NEVER - 1 : (uint32_t)ms;
+}
+
+/********************************************************
+ * REPORT
+ ********************************************************/
+
+bool DMRTimerService::getTimer(uint8_t index, DMRTimerId &id, const char *&name, uint32_t &periodMs,
+                               DMRTimerStats &stats) const {
+    if (index >= count) {
+        return false;
+    }
+    const Timer &timer = timers[heap[index]];
+    id = ((DMRTimerId)timer.generation << 8) | heap[index];
+    name = timer.name;
+    periodMs = timer.periodMs;
+    stats = timer.stats;
+    return true;
+}
+
+void DMRTimerService::clearStats() {
+    runs = 0;
+    for (uint8_t i = 0; i < DMR_TIMER_MAX; i++) {
+        timers[i].stats = DMRTimerStats();
+    }
+}
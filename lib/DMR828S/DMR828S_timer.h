@@ -0,0 +1,95 @@
+#pragma once
+#include <Arduino.h>
+
+// Deadline-driven timers.
+//
+// Armed timers sit in a binary min-heap keyed on their deadline, so the
+// earliest one is always at the top: run() fires everything that is due and
+// msUntilNext() tells the caller how long it may sleep. Nothing is polled
+// between deadlines. Deadlines are 64-bit microseconds extended from
+// micros(), so they never wrap.
+//
+// Periodic timers stay on their original grid (deadline += period): a late
+// firing does not push the next one back. Periods missed entirely, because
+// run() was not called for longer than a period, are skipped and counted
+// rather than fired in a burst. Every firing records how late it ran.
+//
+// Fixed capacity, no allocation. Not thread-safe: give each task its own
+// service and only touch it from that task, callbacks included.
+
+#ifndef DMR_TIMER_MAX
+#define DMR_TIMER_MAX               16      // Armed at once, per service (at most 255)
+#endif
+
+#define DMR_INVALID_TIMER           0
+#define DMR_TIMER_NEVER             0xFFFFFFFFUL    // msUntilNext() with nothing armed
+
+typedef uint16_t DMRTimerId;
+typedef void (*DMRTimerCallback)(void *context);
+
+struct DMRTimerStats {
+    uint32_t fired = 0;
+    uint32_t missed = 0;            // Periods skipped because run() came too late
+    uint32_t lastLateUs = 0;        // Deadline to callback, last firing
+    uint32_t maxLateUs = 0;
+    uint64_t sumLateUs = 0;
+    uint32_t meanLateUs() const { return fired ? sumLateUs / fired : 0; }
+};
+
+class DMRTimerService {
+public:
+    DMRTimerService();
+
+    // DMR_INVALID_TIMER when the service is full or periodMs is 0. The name is
+    // kept as a pointer (reports only) and must outlive the timer.
+    DMRTimerId startOnce(uint32_t delayMs, DMRTimerCallback callback, void *context = nullptr,
+                         const char *name = nullptr);
+    DMRTimerId startPeriodic(uint32_t periodMs, DMRTimerCallback callback, void *context = nullptr,
+                             const char *name = nullptr);
+    // False if the timer already fired (one-shot) or was cancelled; safe from a callback
+    bool cancel(DMRTimerId id);
+    bool isActive(DMRTimerId id) const;
+
+    // Fires every due timer, earliest first, then returns msUntilNext(). A
+    // periodic timer is re-armed, and a one-shot one released, before its
+    // callback runs, so callbacks may start and cancel timers freely.
+    uint32_t run();
+    // Rounded up, 0 if overdue, DMR_TIMER_NEVER with nothing armed
+    uint32_t msUntilNext() const;
+
+    uint8_t getCount() const { return count; }
+    uint32_t getRuns() const { return runs; }               // run() calls: wakeups
+    // Armed timers by position 0..getCount()-1 (heap order, not deadline order)
+    bool getTimer(uint8_t index, DMRTimerId &id, const char *&name, uint32_t &periodMs,
+                  DMRTimerStats &stats) const;
+    void clearStats();
+
+private:
+    struct Timer {
+        uint64_t deadlineUs = 0;
+        uint32_t periodMs = 0;      // 0: one-shot
+        DMRTimerCallback callback = nullptr;
+        void *context = nullptr;
+        const char *name = nullptr;
+        uint8_t generation = 1;     // Bumped on release, so stale ids never match
+        uint8_t heapIndex = 0xFF;   // 0xFF: free
+        DMRTimerStats stats;
+    };
+
+    Timer timers[DMR_TIMER_MAX];
+    uint8_t heap[DMR_TIMER_MAX];    // Timer indexes, earliest deadline first
+    uint8_t count = 0;
+    uint32_t runs = 0;
+
+    uint64_t clockUs = 0;           // micros() extended to 64 bits
+    uint32_t clockMicros = 0;
+
+    uint64_t now();
+    DMRTimerId start(uint32_t delayMs, uint32_t periodMs, DMRTimerCallback callback, void *context,
+                     const char *name);
+    int16_t find(DMRTimerId id) const;
+    void release(uint8_t index);
+    void siftUp(uint8_t pos);
+    void siftDown(uint8_t pos);
+    void place(uint8_t pos, uint8_t index);
+};
@@ -0,0 +1,150 @@
+#include "DMR828S_trace.h"
+
+static DMRTraceEvent traceRing[DMR_TRACE_BUFFER_SIZE];
+static uint16_t traceHead = 0;
+static uint16_t traceCount = 0;
+static uint8_t traceLevel = DMR_TRACE_LEVEL;
+static DMRTraceStats traceStats;
+
+// Recording may happen from more than one task on ESP32
+#if defined(ESP32)
+static portMUX_TYPE traceMux = portMUX_INITIALIZER_UNLOCKED;
+#define TRACE_LOCK()    portENTER_CRITICAL(&traceMux)
+#define TRACE_UNLOCK()  portEXIT_CRITICAL(&traceMux)
+#else
+#define TRACE_LOCK()
+#define TRACE_UNLOCK()
+#endif
+
+static const char *const traceNames[TRACE_EVENT_COUNT] = {
+    "FRAME_TX",
+    "FRAME_RX",
+    "FRAME_INVALID",
+    "FRAME_UNHANDLED",
+    "PARSER_RESYNC",
+    "REQUEST_TIMEOUT",
+    "CONFIG_DONE",
+    "SMS_TX",
+    "SMS_RX",
+    "SMS_STATUS",
+    "SMS_TIMEOUT",
+    "CALL_EVENT",
+    "EMERGENCY",
+    "ENCRYPTION",
+    "RAW_TX",
+    "SMS_PART",
+    "SMS_EXPIRED",
+    "STALL",
+    "QUERY_REJECTED",
+};
+
+
+
+/********************************************************
+ * RECORDING
+ ********************************************************/
+void dmrTraceRecord(uint8_t level, uint16_t id, uint8_t argc,
+                    uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3)
+{
+    if (level > traceLevel)
+        return;
+
+    uint32_t now = micros();
+
+    TRACE_LOCK();
+    DMRTraceEvent &e = traceRing[traceHead];
+    e.timestamp = now;
+    e.id = id;
+    e.level = level;
+    e.argc = argc;
+    e.args[0] = a0;
+    e.args[1] = a1;
+    e.args[2] = a2;
+    e.args[3] = a3;
+
+    traceHead = (traceHead + 1) & (DMR_TRACE_BUFFER_SIZE - 1);
+    if (traceCount < DMR_TRACE_BUFFER_SIZE)
+        traceCount++;
+    else
+        traceStats.overwritten++;
+    traceStats.recorded++;
+    TRACE_UNLOCK();
+}
+
+
+
+/********************************************************
+ * RUNTIME CONTROL
+ ********************************************************/
+void dmrTraceSetLevel(uint8_t level)
+{
+    traceLevel = level > DMR_TRACE_LEVEL ? DMR_TRACE_LEVEL : level;
+}
+
+uint8_t dmrTraceGetLevel()
+{
+    return traceLevel;
+}
+
+void dmrTraceClear()
+{
+    TRACE_LOCK();
+    traceHead = 0;
+    traceCount = 0;
+    traceStats = DMRTraceStats();
+    TRACE_UNLOCK();
+}
+
+const DMRTraceStats& dmrTraceGetStats()
+{
+    return traceStats;
+}
+
+const char* dmrTraceEventName(uint16_t id)
+{
+    return id < TRACE_EVENT_COUNT ? traceNames[id] : "?";
+}
+
+
+
+/********************************************************
+ * DRAIN
+ ********************************************************/
+bool dmrTracePop(DMRTraceEvent &event)
+{
+    bool found = false;
+
+    TRACE_LOCK();
+    if (traceCount > 0) {
+        uint16_t tail = (traceHead - traceCount) & (DMR_TRACE_BUFFER_SIZE - 1);
+        event = traceRing[tail];
+        traceCount--;
+        found = true;
+    }
+    TRACE_UNLOCK();
+
+    return found;
+}
+
+size_t dmrTraceDrain(Print &out, size_t maxEvents)
+{
+    static const char levelChars[] = "-EID";
+    size_t written = 0;
+    DMRTraceEvent e;
+
+    // Formatting happens here, outside the recording path
+    while (written < maxEvents && dmrTracePop(e)) {
+        char line[96];
+        int pos = snprintf(line, sizeof(line), "[%10lu] %c %-16s",
+                           (unsigned long)e.timestamp,
+                           levelChars[e.level & 0x03],
+                           dmrTraceEventName(e.id));
+        for (uint8_t i = 0; i < e.argc && i < 4 && pos < (int)sizeof(line); i++) {
+            pos += snprintf(&line[pos], sizeof(line) - pos, " %lX", (unsigned long)e.args[i]);
+        }
+        out.println(line);
+        written++;
+    }
+
+    return written;
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <Arduino.h>
+
+// Binary trace log for the DMR828S library.
+//
+// Events are recorded as fixed-size binary records (timestamp, id, up to 4
+// args) in a RAM ring and only formatted when drained, so tracing costs a few
+// stores instead of dozens of Serial.print calls. Levels above DMR_TRACE_LEVEL
+// compile to nothing; the runtime level filters further without a rebuild.
+
+#define DMR_TRACE_LVL_OFF       0
+#define DMR_TRACE_LVL_ERROR     1
+#define DMR_TRACE_LVL_INFO      2
+#define DMR_TRACE_LVL_DEBUG     3
+
+// Highest level compiled in (override with -DDMR_TRACE_LEVEL=...)
+#ifndef DMR_TRACE_LEVEL
+#define DMR_TRACE_LEVEL         DMR_TRACE_LVL_INFO
+#endif
+
+// Ring capacity in events (power of two)
+#ifndef DMR_TRACE_BUFFER_SIZE
+#define DMR_TRACE_BUFFER_SIZE   128
+#endif
+
+// Trace event identifiers - keep in sync with the name table in DMR828S_trace.cpp
+enum DMRTraceEventId : uint16_t {
+    TRACE_FRAME_TX = 0,         // cmd, rw, sr, len
+    TRACE_FRAME_RX,             // cmd, rw, sr, len
+    TRACE_FRAME_INVALID,        // cmd, rw, sr, checksum
+    TRACE_FRAME_UNHANDLED,      // cmd, rw, sr, len
+    TRACE_PARSER_RESYNC,        // dropped bytes, resyncs, timeouts
+    TRACE_REQUEST_TIMEOUT,      // cmd, timeout ms
+    TRACE_CONFIG_DONE,          // acked, total, retries, elapsed ms
+    TRACE_SMS_TX,               // target, type, chars
+    TRACE_SMS_RX,               // source, chars
+    TRACE_SMS_STATUS,           // status code, target
+    TRACE_SMS_TIMEOUT,          // target, waited ms
+    TRACE_CALL_EVENT,           // sr, call type, contact
+    TRACE_EMERGENCY,            // source
+    TRACE_ENCRYPTION,           // enabled
+    TRACE_RAW_TX,               // length
+    TRACE_SMS_PART,             // peer, message id, part, total
+    TRACE_SMS_EXPIRED,          // source, message id, parts received, total
+    TRACE_STALL,                // stage (caller-defined), ms, UART backlog bytes, queued frames
+    TRACE_QUERY_REJECTED,       // cmd, reason (DMRQueryReject)
+    TRACE_EVENT_COUNT
+};
+
+struct DMRTraceEvent {
+    uint32_t timestamp;         // micros()
+    uint16_t id;
+    uint8_t level;
+    uint8_t argc;
+    uint32_t args[4];
+};
+
+struct DMRTraceStats {
+    uint32_t recorded = 0;
+    uint32_t overwritten = 0;   // Oldest events lost because nobody drained
+};
+
+// Recording (use the macros below so disabled levels vanish at compile time)
+void dmrTraceRecord(uint8_t level, uint16_t id, uint8_t argc,
+                    uint32_t a0 = 0, uint32_t a1 = 0, uint32_t a2 = 0, uint32_t a3 = 0);
+
+// Runtime control
+void dmrTraceSetLevel(uint8_t level);
+uint8_t dmrTraceGetLevel();
+void dmrTraceClear();
+const DMRTraceStats& dmrTraceGetStats();
+const char* dmrTraceEventName(uint16_t id);
+
+// Copy out the oldest event (returns false when empty)
+bool dmrTracePop(DMRTraceEvent &event);
+
+// Format and remove up to maxEvents events; returns the number written
+size_t dmrTraceDrain(Print &out, size_t maxEvents = DMR_TRACE_BUFFER_SIZE);
+
+// Argument counting for the macros (0-4 args)
+#define DMR_TRACE_NARGS_(_0, _1, _2, _3, _4, N, ...) N
+#define DMR_TRACE_NARGS(...) DMR_TRACE_NARGS_(_0, ##__VA_ARGS__, 4, 3, 2, 1, 0)
+#define DMR_TRACE_AT(level, id, ...) \
+    dmrTraceRecord(level, id, DMR_TRACE_NARGS(__VA_ARGS__), ##__VA_ARGS__)
+
+#if DMR_TRACE_LEVEL >= DMR_TRACE_LVL_ERROR
+#define DMR_TRACE_ERROR(id, ...) DMR_TRACE_AT(DMR_TRACE_LVL_ERROR, id, ##__VA_ARGS__)
+#else
+#define DMR_TRACE_ERROR(id, ...) do {} while (0)
+#endif
+
+#if DMR_TRACE_LEVEL >= DMR_TRACE_LVL_INFO
+#define DMR_TRACE_INFO(id, ...) DMR_TRACE_AT(DMR_TRACE_LVL_INFO, id, ##__VA_ARGS__)
+#else
+#define DMR_TRACE_INFO(id, ...) do {} while (0)
+#endif
+
+#if DMR_TRACE_LEVEL >= DMR_TRACE_LVL_DEBUG
+#define DMR_TRACE_DEBUG(id, ...) DMR_TRACE_AT(DMR_TRACE_LVL_DEBUG, id, ##__VA_ARGS__)
+#else
+#define DMR_TRACE_DEBUG(id, ...) do {} while (0)
+#endif
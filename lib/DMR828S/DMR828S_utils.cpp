@@ -2,10 +2,16 @@
 
 DMR828S_Utils::DMR828S_Utils(HardwareSerial &port) {
     serial = &port;
+    hwSerial = &port;
+}
+
+DMR828S_Utils::DMR828S_Utils(Stream &port) {
+    serial = &port;
 }
 
 void DMR828S_Utils::begin(uint32_t baud) {
-    serial->begin(baud);
+    if (hwSerial)
+        hwSerial->begin(baud);
 }
 
 
@@ -61,39 +67,59 @@ uint16_t DMR828S_Utils::calcChecksum(const uint8_t *buf, uint16_t len)
  * SEND FRAME
  ********************************************************/
 bool DMR828S_Utils::sendFrame(uint8_t cmd, uint8_t rw, uint8_t sr,
-                        const uint8_t *data, uint16_t len)
+                        const uint8_t *data, uint16_t len, bool flush)
 {
-    uint8_t buf[300];
-    uint16_t pos = 0;
+    uint8_t prefix[DMR_FRAME_PREFIX_LEN];
 
-    // Header
-    buf[pos++] = 0x68;
-    buf[pos++] = cmd;
-    buf[pos++] = rw;
-    buf[pos++] = sr;
+    prefix[0] = DMR_FRAME_HEAD;
+    prefix[1] = cmd;
+    prefix[2] = rw;
+    prefix[3] = sr;
 
     // Checksum (or zeroes if disabled)
-    uint16_t chk = checksumEnabled ? calcChecksum(buf, 4) : 0x0000;
-    buf[pos++] = (chk >> 8);
-    buf[pos++] = (chk & 0xFF);
+    uint16_t chk = checksumEnabled ? dmrHeaderChecksum(cmd, rw, sr) : 0x0000;
+    prefix[4] = (chk >> 8);
+    prefix[5] = (chk & 0xFF);
 
-    // Payload length
-    buf[pos++] = (len >> 8);
-    buf[pos++] = (len & 0xFF);
+    return sendPrefixed(prefix, data, len, flush);
+}
 
-    // Payload
-    for (int i = 0; i < len; i++)
-        buf[pos++] = data[i];
+bool DMR828S_Utils::sendPrefixed(const uint8_t *prefix, const uint8_t *data, uint16_t len, bool flush)
+{
+    if (len > DMR_MAX_PAYLOAD || (len > 0 && !data))
+        return false;
+
+    uint8_t header[DMR_FRAME_HEADER_LEN];
+    memcpy(header, prefix, DMR_FRAME_PREFIX_LEN);
+    header[6] = (len >> 8);
+    header[7] = (len & 0xFF);
 
-    // Tail
-    buf[pos++] = 0x10;
+    static const uint8_t tail = DMR_FRAME_TAIL;
 
     // Debug output
-    printHexPacket("TX →", buf, pos);
+    DMR_TRACE_DEBUG(TRACE_FRAME_TX, header[1], header[2], header[3], len);
+    if (debug) {
+        Serial.print("TX → ");
+        for (int i = 0; i < DMR_FRAME_HEADER_LEN; i++) {
+            printHexByte(header[i]);
+            Serial.print(" ");
+        }
+        for (int i = 0; i < len; i++) {
+            printHexByte(data[i]);
+            Serial.print(" ");
+        }
+        printHexByte(tail);
+        Serial.println(" ");
+    }
+
+    // Send header, payload and tail without assembling the frame
+    serial->write(header, DMR_FRAME_HEADER_LEN);
+    if (len > 0)
+        serial->write(data, len);
+    serial->write(&tail, 1);
 
-    // Send
-    serial->write(buf, pos);
-    serial->flush();
+    if (flush)
+        serial->flush();
 
     return true;
 }
@@ -101,62 +127,331 @@ bool DMR828S_Utils::sendFrame(uint8_t cmd, uint8_t rw, uint8_t sr,
 
 
 /********************************************************
- * READ FRAME
+ * RECEIVE RING
  ********************************************************/
-bool DMR828S_Utils::readFrame(DMRFrame &f)
+size_t DMR828S_Utils::feed(const uint8_t *data, size_t len)
+{
+    size_t accepted = 0;
+
+    while (accepted < len && rxCount < DMR_RX_RING_SIZE) {
+        size_t n = len - accepted;
+        if (n > (size_t)(DMR_RX_RING_SIZE - rxCount)) n = DMR_RX_RING_SIZE - rxCount;
+        if (n > (size_t)(DMR_RX_RING_SIZE - rxHead)) n = DMR_RX_RING_SIZE - rxHead;
+
+        memcpy(&rxRing[rxHead], &data[accepted], n);
+        memcpy(&rxRing[rxHead + DMR_RX_RING_SIZE], &data[accepted], n);
+
+        rxHead = (rxHead + n) & (DMR_RX_RING_SIZE - 1);
+        rxCount += n;
+        accepted += n;
+    }
+
+    if (accepted > 0)
+        rxLastByteTime = millis();
+    stats.overflows += len - accepted;
+
+    return accepted;
+}
+
+void DMR828S_Utils::pollSerial()
 {
-    static uint8_t buf[300];
-    static uint16_t idx = 0;
+    int avail = serial->available();
+
+    while (avail > 0 && rxCount < DMR_RX_RING_SIZE) {
+        size_t n = avail;
+        if (n > (size_t)(DMR_RX_RING_SIZE - rxCount)) n = DMR_RX_RING_SIZE - rxCount;
+        if (n > (size_t)(DMR_RX_RING_SIZE - rxHead)) n = DMR_RX_RING_SIZE - rxHead;
+
+        // Only request what is already buffered so readBytes() never waits
+        n = serial->readBytes(&rxRing[rxHead], n);
+        if (n == 0)
+            break;
+        memcpy(&rxRing[rxHead + DMR_RX_RING_SIZE], &rxRing[rxHead], n);
+
+        rxHead = (rxHead + n) & (DMR_RX_RING_SIZE - 1);
+        rxCount += n;
+        avail -= n;
+        rxLastByteTime = millis();
+    }
+}
 
-    while (serial->available()) {
-        uint8_t b = serial->read();
-        buf[idx++] = b;
+void DMR828S_Utils::discardRx(uint16_t count)
+{
+    if (count > rxCount)
+        count = rxCount;
+    rxTail = (rxTail + count) & (DMR_RX_RING_SIZE - 1);
+    rxCount -= count;
+}
 
-        // First byte must be 0x68
-        if (idx == 1 && b != 0x68) {
-            idx = 0;
+void DMR828S_Utils::resetParser()
+{
+    rxHead = 0;
+    rxTail = 0;
+    rxCount = 0;
+}
+
+
+
+/********************************************************
+ * PARSE FRAME
+ ********************************************************/
+bool DMR828S_Utils::parseFrame(DMRFrameView &f)
+{
+    while (rxCount > 0) {
+        const uint8_t *p = &rxRing[rxTail];
+
+        // Hunt for the next header byte
+        if (p[0] != DMR_FRAME_HEAD) {
+            discardRx(1);
+            stats.droppedBytes++;
             continue;
         }
 
-        if (idx >= 8) {
-            uint16_t payloadLen = (buf[6] << 8) | buf[7];
-            uint16_t expectedLen = 1 + 3 + 2 + 2 + payloadLen + 1;
-
-            if (idx == expectedLen) {
-                if (buf[idx - 1] != 0x10) {
-                    idx = 0;
-                    return false;
-                }
-
-                // Fill struct
-                f.cmd      = buf[1];
-                f.rw       = buf[2];
-                f.sr       = buf[3];
-                f.checksum = (buf[4] << 8) | buf[5];
-                f.length   = payloadLen;
-
-                for (int i = 0; i < payloadLen; i++)
-                    f.data[i] = buf[8 + i];
-
-                // Verify checksum if enabled
-                if (checksumEnabled) {
-                    uint16_t chk = calcChecksum(buf, 4);
-                    f.valid = (chk == f.checksum);
-                } else {
-                    f.valid = true;  // accept all packets
-                }
-
-                // Debug RX dump
-                printHexPacket("RX ←", buf, idx);
-
-                idx = 0;
-                return true;
+        uint16_t frameLen = DMR_FRAME_HEADER_LEN;
+        if (rxCount >= DMR_FRAME_HEADER_LEN) {
+            uint16_t payloadLen = (p[6] << 8) | p[7];
+
+            // A length we can never hold means this 0x68 was not a header
+            if (payloadLen > DMR_MAX_PAYLOAD) {
+                discardRx(1);
+                stats.resyncs++;
+                DMR_TRACE_DEBUG(TRACE_PARSER_RESYNC, stats.droppedBytes, stats.resyncs, stats.timeouts);
+                continue;
+            }
+            frameLen = DMR_FRAME_OVERHEAD + payloadLen;
+        }
+
+        if (rxCount < frameLen) {
+            // Partial frame - wait for more bytes unless the line went quiet
+            if (millis() - rxLastByteTime > DMR_RX_FRAME_TIMEOUT_MS) {
+                discardRx(1);
+                stats.timeouts++;
+                DMR_TRACE_DEBUG(TRACE_PARSER_RESYNC, stats.droppedBytes, stats.resyncs, stats.timeouts);
+                continue;
             }
+            return false;
         }
 
-        if (idx >= 299)
-            idx = 0;
+        // Bad tail: skip only the false header and rescan the bytes behind it
+        if (p[frameLen - 1] != DMR_FRAME_TAIL) {
+            discardRx(1);
+            stats.resyncs++;
+            DMR_TRACE_DEBUG(TRACE_PARSER_RESYNC, stats.droppedBytes, stats.resyncs, stats.timeouts);
+            continue;
+        }
+
+        f.cmd      = p[1];
+        f.rw       = p[2];
+        f.sr       = p[3];
+        f.checksum = (p[4] << 8) | p[5];
+        f.length   = frameLen - DMR_FRAME_OVERHEAD;
+        f.data     = &p[DMR_FRAME_HEADER_LEN];
+
+        // Verify checksum if enabled
+        if (checksumEnabled) {
+            uint16_t chk = calcChecksum(p, 4);
+            f.valid = (chk == f.checksum);
+        } else {
+            f.valid = true;  // accept all packets
+        }
+
+        // Debug RX dump
+        printHexPacket("RX ←", p, frameLen);
+
+        stats.frames++;
+        if (!f.valid)
+            stats.checksumErrors++;
+
+        // Bytes stay in place until the next fill, so the view remains valid
+        discardRx(frameLen);
+        return true;
     }
 
     return false;
 }
+
+
+
+/********************************************************
+ * READ FRAME
+ ********************************************************/
+void DMR828S_Utils::copyFrame(DMRFrame &dst, const DMRFrameView &src)
+{
+    dst.cmd      = src.cmd;
+    dst.rw       = src.rw;
+    dst.sr       = src.sr;
+    dst.checksum = src.checksum;
+    dst.length   = src.length;
+    dst.valid    = src.valid;
+    memcpy(dst.data, src.data, src.length);
+}
+
+bool DMR828S_Utils::readFrame(DMRFrameView &f)
+{
+#if defined(ESP32)
+    if (eventRx) {
+        if (!rxQueue.pop(rxFrame))
+            return false;
+
+        uint32_t us = micros() - rxFrame.rxUs;
+        rxLatency.frames++;
+        rxLatency.lastUs = us;
+        rxLatency.sumUs += us;
+        if (us > rxLatency.maxUs)
+            rxLatency.maxUs = us;
+
+        f.cmd      = rxFrame.cmd;
+        f.rw       = rxFrame.rw;
+        f.sr       = rxFrame.sr;
+        f.checksum = rxFrame.checksum;
+        f.length   = rxFrame.length;
+        f.data     = rxFrame.data;
+        f.valid    = rxFrame.valid;
+        return true;
+    }
+#endif
+
+    pollSerial();
+    return parseFrame(f);
+}
+
+bool DMR828S_Utils::readFrame(DMRFrame &f)
+{
+    DMRFrameView view;
+    if (!readFrame(view))
+        return false;
+
+    copyFrame(f, view);
+    return true;
+}
+
+
+
+/********************************************************
+ * EVENT-DRIVEN RECEIVE
+ ********************************************************/
+bool DMR828S_Utils::beginEventRx(uint8_t queueDepth)
+{
+#if defined(ESP32)
+    if (eventRx)
+        return true;
+    if (!hwSerial)
+        return false;
+
+    rxReady = xSemaphoreCreateBinary();
+    if (!rxReady)
+        return false;
+
+    // Drop whatever a previous session left behind
+    DMRFrame stale;
+    while (rxQueue.pop(stale)) {}
+    rxQueueLimit = queueDepth < rxQueue.capacity() ? queueDepth : rxQueue.capacity();
+
+    rxTaskStop = false;
+    if (xTaskCreatePinnedToCore(rxTaskEntry, "dmr_rx", DMR_RX_TASK_STACK, this,
+                                DMR_RX_TASK_PRIORITY, &rxTask, DMR_RX_TASK_CORE) != pdPASS) {
+        vSemaphoreDelete(rxReady);
+        rxReady = nullptr;
+        return false;
+    }
+
+    // The driver raises a receive event when the line has been idle for a few
+    // symbols (end of a burst, i.e. end of a frame) or the FIFO passes the
+    // threshold. We only wake the task here; parsing happens in task context.
+    hwSerial->setRxTimeout(DMR_RX_IDLE_SYMBOLS);
+    hwSerial->setRxFIFOFull(DMR_RX_FIFO_THRESHOLD);
+    hwSerial->onReceive([this]() {
+        if (rxTask) xTaskNotifyGive(rxTask);
+    });
+
+    eventRx = true;
+    return true;
+#else
+    (void)queueDepth;
+    return false;
+#endif
+}
+
+void DMR828S_Utils::endEventRx()
+{
+#if defined(ESP32)
+    if (!eventRx)
+        return;
+
+    hwSerial->onReceive(nullptr);
+    rxTaskStop = true;
+    xTaskNotifyGive(rxTask);
+    while (rxTask)
+        delay(1);
+
+    vSemaphoreDelete(rxReady);
+    rxReady = nullptr;
+    eventRx = false;
+#endif
+}
+
+void DMR828S_Utils::waitForRx(uint32_t timeout_ms)
+{
+#if defined(ESP32)
+    if (eventRx) {
+        // A give left over from a frame already read only costs one early return
+        if (rxQueue.empty())
+            xSemaphoreTake(rxReady, pdMS_TO_TICKS(timeout_ms));
+        return;
+    }
+#endif
+    delay(timeout_ms);
+}
+
+void DMR828S_Utils::wakeRx()
+{
+#if defined(ESP32)
+    if (eventRx)
+        xSemaphoreGive(rxReady);
+#endif
+}
+
+uint32_t DMR828S_Utils::getRxBacklogBytes()
+{
+    int available = serial->available();
+    return available > 0 ? available : 0;
+}
+
+uint16_t DMR828S_Utils::getRxQueuedFrames() const
+{
+#if defined(ESP32)
+    if (eventRx)
+        return rxQueue.size();
+#endif
+    return 0;
+}
+
+#if defined(ESP32)
+void DMR828S_Utils::rxTaskEntry(void *arg)
+{
+    static_cast<DMR828S_Utils*>(arg)->rxTaskLoop();
+}
+
+void DMR828S_Utils::rxTaskLoop()
+{
+    DMRFrameView view;
+
+    while (!rxTaskStop) {
+        // The wait timeout lets a stalled partial frame expire in parseFrame()
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(DMR_RX_FRAME_TIMEOUT_MS));
+
+        pollSerial();
+        while (parseFrame(view)) {
+            copyFrame(rxTaskFrame, view);
+            rxTaskFrame.rxUs = micros();
+            if (rxQueue.size() >= rxQueueLimit || !rxQueue.push(rxTaskFrame))
+                stats.queueDrops++;
+            else
+                xSemaphoreGive(rxReady);
+        }
+    }
+
+    rxTask = nullptr;
+    vTaskDelete(NULL);
+}
+#endif
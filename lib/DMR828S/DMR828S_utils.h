@@ -1,5 +1,56 @@
 #pragma once
 #include <Arduino.h>
+#include "DMR828S_trace.h"
+#if defined(ESP32)
+#include "DMR828S_queue.h"
+#endif
+
+// Frame layout constants
+#define DMR_FRAME_HEAD          0x68
+#define DMR_FRAME_TAIL          0x10
+#define DMR_FRAME_PREFIX_LEN    6       // HEAD CMD R/W S/R CHK_H CHK_L
+#define DMR_FRAME_HEADER_LEN    8       // prefix + LEN_H LEN_L
+#define DMR_FRAME_OVERHEAD      9       // header + tail
+#define DMR_MAX_PAYLOAD         256
+
+// Receive ring size (power of two, must hold at least one maximum frame)
+#ifndef DMR_RX_RING_SIZE
+#define DMR_RX_RING_SIZE        512
+#endif
+
+// Drop a partial frame if no new byte arrives within this window
+#ifndef DMR_RX_FRAME_TIMEOUT_MS
+#define DMR_RX_FRAME_TIMEOUT_MS 100
+#endif
+
+// Event-driven receive (ESP32): frames queued between the receive task and
+// update(). Power of two; beginEventRx() can use fewer slots, not more.
+#ifndef DMR_RX_QUEUE_DEPTH
+#define DMR_RX_QUEUE_DEPTH      8
+#endif
+
+// UART idle time, in symbols, that ends a burst and wakes the receive task
+#ifndef DMR_RX_IDLE_SYMBOLS
+#define DMR_RX_IDLE_SYMBOLS     2
+#endif
+
+// FIFO fill level that wakes the receive task during long frames
+#ifndef DMR_RX_FIFO_THRESHOLD
+#define DMR_RX_FIFO_THRESHOLD   32
+#endif
+
+#ifndef DMR_RX_TASK_STACK
+#define DMR_RX_TASK_STACK       3072
+#endif
+
+// Above loop() so a completed frame is queued as soon as the line goes idle
+#ifndef DMR_RX_TASK_PRIORITY
+#define DMR_RX_TASK_PRIORITY    3
+#endif
+
+#ifndef DMR_RX_TASK_CORE
+#define DMR_RX_TASK_CORE        1
+#endif
 
 // DMR Frame structure for protocol communication
 struct DMRFrame {
@@ -10,12 +61,77 @@ struct DMRFrame {
     uint16_t length = 0;
     uint8_t data[256];
     bool valid = false;
+    uint32_t rxUs = 0;              // micros() when the receive task queued it (event-driven only)
+};
+
+// Zero-copy view of a received frame. data points into the parser's
+// receive ring and stays valid until the next readFrame()/parseFrame() call.
+struct DMRFrameView {
+    uint8_t cmd = 0;
+    uint8_t rw = 0;
+    uint8_t sr = 0;
+    uint16_t checksum = 0;
+    uint16_t length = 0;
+    const uint8_t *data = nullptr;
+    bool valid = false;
+};
+
+// Receive parser counters
+struct DMRParserStats {
+    uint32_t frames = 0;            // Complete frames delivered
+    uint32_t checksumErrors = 0;    // Delivered frames that failed checksum
+    uint32_t droppedBytes = 0;      // Bytes discarded while hunting for a header
+    uint32_t resyncs = 0;           // False headers (bad length or tail) skipped
+    uint32_t timeouts = 0;          // Partial frames abandoned after DMR_RX_FRAME_TIMEOUT_MS
+    uint32_t overflows = 0;         // Bytes refused because the ring was full
+    uint32_t queueDrops = 0;        // Frames lost because the event-driven queue was full
+};
+
+// Event-driven receive: time from the receive task queueing a frame to
+// readFrame() handing it out, i.e. how long the consumer left it waiting
+struct DMRRxLatency {
+    uint32_t frames = 0;
+    uint32_t lastUs = 0;
+    uint32_t maxUs = 0;
+    uint64_t sumUs = 0;
+    uint32_t meanUs() const { return frames ? sumUs / frames : 0; }
 };
 
+// Header checksum (same algorithm as calcChecksum(buf, 4)) usable in constant expressions
+constexpr uint16_t dmrFoldChecksum(uint32_t sum) {
+    return (sum >> 16) ? dmrFoldChecksum((sum & 0xFFFF) + (sum >> 16)) : (uint16_t)(sum ^ 0xFFFF);
+}
+
+constexpr uint16_t dmrHeaderChecksum(uint8_t cmd, uint8_t rw, uint8_t sr) {
+    return dmrFoldChecksum((((uint32_t)DMR_FRAME_HEAD << 8) | cmd) + (((uint32_t)rw << 8) | sr));
+}
+
+static_assert(dmrHeaderChecksum(0x01, 0x01, 0x01) == 0x96FD, "header checksum mismatch");
+
+// Frame prefix for a fixed command, built at compile time. One instance per
+// CMD/RW/SR combination actually used; both variants live in flash.
+template <uint8_t CMD, uint8_t RW = 0x01, uint8_t SR = 0x01>
+struct DMRFrameTemplate {
+    static constexpr uint16_t checksum = dmrHeaderChecksum(CMD, RW, SR);
+    static constexpr uint8_t prefix[DMR_FRAME_PREFIX_LEN] = {
+        DMR_FRAME_HEAD, CMD, RW, SR, (uint8_t)(checksum >> 8), (uint8_t)(checksum & 0xFF)
+    };
+    static constexpr uint8_t prefixNoChecksum[DMR_FRAME_PREFIX_LEN] = {
+        DMR_FRAME_HEAD, CMD, RW, SR, 0x00, 0x00
+    };
+};
+
+template <uint8_t CMD, uint8_t RW, uint8_t SR>
+constexpr uint8_t DMRFrameTemplate<CMD, RW, SR>::prefix[DMR_FRAME_PREFIX_LEN];
+
+template <uint8_t CMD, uint8_t RW, uint8_t SR>
+constexpr uint8_t DMRFrameTemplate<CMD, RW, SR>::prefixNoChecksum[DMR_FRAME_PREFIX_LEN];
+
 // Low-level DMR828S protocol utilities class
 class DMR828S_Utils {
 public:
     DMR828S_Utils(HardwareSerial &port);
+    DMR828S_Utils(Stream &port);    // Any byte stream, e.g. DMR828S_Simulator
     
     // Basic setup
     void begin(uint32_t baud);
@@ -24,10 +140,50 @@ public:
     bool checksumEnabled = true;
     bool debug = true;
     
-    // Core protocol functions
+    // Core protocol functions. Frames go out as header, payload and tail
+    // slices straight from the caller's buffer; pass flush = false to return
+    // as soon as the bytes are queued in the UART driver.
     bool sendFrame(uint8_t cmd, uint8_t rw, uint8_t sr,
-                   const uint8_t *data, uint16_t len);
+                   const uint8_t *data, uint16_t len, bool flush = true);
+    
+    // Same, with the header and checksum for a fixed command taken from
+    // DMRFrameTemplate instead of being computed per call.
+    template <uint8_t CMD, uint8_t RW = 0x01, uint8_t SR = 0x01>
+    bool sendFrame(const uint8_t *data, uint16_t len, bool flush = true) {
+        return sendPrefixed(checksumEnabled ? DMRFrameTemplate<CMD, RW, SR>::prefix
+                                            : DMRFrameTemplate<CMD, RW, SR>::prefixNoChecksum,
+                            data, len, flush);
+    }
+    bool sendPrefixed(const uint8_t *prefix, const uint8_t *data, uint16_t len, bool flush = true);
     bool readFrame(DMRFrame &frame);
+    bool readFrame(DMRFrameView &frame);
+    
+    // Incremental receive path: feed() appends raw bytes to the ring,
+    // parseFrame() extracts the next frame without touching the serial port.
+    size_t feed(const uint8_t *data, size_t len);
+    bool parseFrame(DMRFrameView &frame);
+    void resetParser();
+    const DMRParserStats& getParserStats() const { return stats; }
+    void resetParserStats() { stats = DMRParserStats(); }
+    
+    // Event-driven receive (ESP32 UART ports only). A task woken by the UART driver's
+    // idle-line and FIFO-threshold events parses frames and queues them;
+    // readFrame() then pops from the queue instead of polling the port.
+    bool beginEventRx(uint8_t queueDepth = DMR_RX_QUEUE_DEPTH);
+    void endEventRx();
+    bool isEventRxActive() const { return eventRx; }
+    const DMRRxLatency& getRxLatency() const { return rxLatency; }
+    void resetRxLatency() { rxLatency = DMRRxLatency(); }
+    
+    // Sleep until a frame is queued or timeout_ms elapses (plain delay when polling)
+    void waitForRx(uint32_t timeout_ms);
+    // Ends another task's waitForRx() early, e.g. when work was queued for it
+    void wakeRx();
+    // Received but not yet handled: bytes waiting in the port (UART FIFO and
+    // driver buffer) and, with event receive, frames queued for readFrame().
+    // Safe to call from another task, as a snapshot.
+    uint32_t getRxBacklogBytes();
+    uint16_t getRxQueuedFrames() const;
     
     // Utility functions
     uint16_t calcChecksum(const uint8_t *buf, uint16_t len);
@@ -35,8 +191,37 @@ public:
     void printHexPacket(const char *prefix, const uint8_t *buf, uint16_t len);
     
     // Direct access to serial for advanced users
-    HardwareSerial* getSerial() { return serial; }
+    Stream* getSerial() { return serial; }
     
 private:
-    HardwareSerial *serial;
+    Stream *serial;
+    HardwareSerial *hwSerial = nullptr;     // Set when the port is a real UART
+    
+    // Mirrored receive ring: every byte at i is also stored at i + DMR_RX_RING_SIZE,
+    // so any frame starting inside the ring can be read as one contiguous slice.
+    uint8_t rxRing[2 * DMR_RX_RING_SIZE];
+    uint16_t rxHead = 0;
+    uint16_t rxTail = 0;
+    uint16_t rxCount = 0;
+    unsigned long rxLastByteTime = 0;
+    DMRParserStats stats;
+    DMRRxLatency rxLatency;
+    
+    void pollSerial();
+    void discardRx(uint16_t count);
+    static void copyFrame(DMRFrame &dst, const DMRFrameView &src);
+    
+    volatile bool eventRx = false;
+#if defined(ESP32)
+    TaskHandle_t rxTask = nullptr;
+    DMRSPSCQueue<DMRFrame, DMR_RX_QUEUE_DEPTH> rxQueue;    // Receive task -> readFrame()
+    uint8_t rxQueueLimit = DMR_RX_QUEUE_DEPTH;
+    SemaphoreHandle_t rxReady = nullptr;    // Given after each push; waitForRx() sleeps on it
+    volatile bool rxTaskStop = false;
+    DMRFrame rxTaskFrame;           // Staging copy owned by the receive task
+    DMRFrame rxFrame;               // Backs the view returned by readFrame()
+    
+    static void rxTaskEntry(void *arg);
+    void rxTaskLoop();
+#endif
 };
@@ -6,10 +6,19 @@
 #include "commands/GPSCommands.h"
 #include "commands/LoRaCommands.h"
 #include "commands/EncryptionCommands.h"
+#include "commands/HopCommands.h"
 #include "managers/LoRaManager.h"
 #include "managers/KeyboardManager.h"
+#include "managers/DisplayManager.h"
+#include "managers/ConfigManager.h"
+#include "managers/BootManager.h"
+#include "managers/TaskManager.h"
+#include "managers/MemoryManager.h"
 #include "BluetoothSerial.h"
 
+static void onScanDone(const DMRChannelScanner &scanner, void *context);
+static bool resumeLinkSampler = false;
+
 extern DMR828S dmr;
 extern WalkieTalkieState wtState;
 extern BluetoothSerial SerialBT;
@@ -17,6 +26,14 @@ extern DemoMode currentMode;
 
 
 void processCommand(Stream* stream, String command) {
+    DMR_MEM_SCOPE(MEM_COMMAND);
+    
+    // Run on the task that owns what the command touches; it comes back here there
+    if (routeCommand(stream, command)) {
+        return;
+    }
+    StallWatch watch(command);
+    
     if (command.startsWith("gsm")) {
         handleGSMCommand(stream, command);
     }
@@ -29,6 +46,9 @@ void processCommand(Stream* stream, String command) {
     else if (command.startsWith("encrypt")) {
         handleEncryptionCommand(stream, command);
     }
+    else if (command == "hop" || command.startsWith("hop ")) {
+        handleHopCommand(stream, command);
+    }
     else if (command.startsWith("sms ")) {
         // ...existing code...
         int firstSpace = command.indexOf(' ', 4);
@@ -36,11 +56,13 @@ void processCommand(Stream* stream, String command) {
             String idStr = command.substring(4, firstSpace);
             String message = command.substring(firstSpace + 1);
             uint32_t targetID = strtoul(idStr.c_str(), NULL, 16);
-            if (dmr.sendSMS(targetID, message.c_str())) {
-                stream->print("📤 SMS sent to 0x"); stream->print(targetID, HEX);
+            DMRSMSHandle handle = dmr.queueSMS(targetID, message.c_str());
+            if (handle != DMR_SMS_INVALID_HANDLE) {
+                stream->print("📤 SMS #"); stream->print(handle);
+                stream->print(" queued to 0x"); stream->print(targetID, HEX);
                 stream->print(": "); stream->println(message);
             } else {
-                stream->println("❌ SMS send failed");
+                stream->println("❌ SMS send failed (queue full or text too long)");
             }
         }
     }
@@ -76,6 +98,7 @@ void processCommand(Stream* stream, String command) {
         int ch = command.substring(8).toInt();
         if (ch >= 1 && ch <= 16) {
             wtState.currentChannel = ch;
+            markConfigDirty();
             if (dmr.setChannel(ch)) {
                 stream->print("📻 Channel: "); stream->println(ch);
             }
@@ -86,6 +109,7 @@ void processCommand(Stream* stream, String command) {
         int vol = command.substring(7).toInt();
         if (vol >= 1 && vol <= 9) {
             wtState.volume = vol;
+            markConfigDirty();
             if (dmr.setVolume(vol)) {
                 stream->print("🔊 Volume: "); stream->println(vol);
             }
@@ -97,6 +121,7 @@ void processCommand(Stream* stream, String command) {
         
         if (radioID > 0 && radioID <= 0xFFFFFF) {
             wtState.myRadioID = radioID;
+            markConfigDirty();
             if (dmr.setRadioID(radioID)) {
                 stream->print("🆔 Radio ID: 0x"); stream->println(radioID, HEX);
             } else {
@@ -111,14 +136,79 @@ void processCommand(Stream* stream, String command) {
         soldierID.trim();
         if (soldierID.length() > 0) {
             wtState.soldierID = soldierID;
+            markConfigDirty();
             stream->println("✅ Soldier ID set: " + soldierID);
         } else {
             stream->println("❌ Invalid soldier ID");
         }
     }
+    else if (command == "boottime") {
+        showBootTimeTo(stream);
+    }
+    else if (command == "tasks") {
+        showTasksTo(stream);
+    }
+    else if (command == "tasks reset") {
+        resetTaskStats();
+        stream->println("⚙️ Task, timer and event latency counters cleared");
+    }
+    else if (command == "timers") {
+        showTimersTo(stream);
+    }
+    else if (command == "perf") {
+        showPerfTo(stream);
+    }
+    else if (command == "perf reset") {
+        resetPerf();
+        stream->println("📊 Stage latency histograms cleared");
+    }
+    else if (command == "stalls") {
+        showStallsTo(stream);
+    }
+    else if (command == "stalls clear") {
+        clearStalls();
+        stream->println("🐢 Stall log cleared");
+    }
+    else if (command.startsWith("stalls budget ")) {
+        long ms = command.substring(14).toInt();
+        if (ms >= 0 && ms <= 10000) {
+            setStallBudget(ms);
+            stream->print("🐢 Stall budget: ");
+            stream->print(ms);
+            stream->println(ms ? " ms" : " (off)");
+        } else {
+            stream->println("❌ Use: stalls budget <0-10000 ms>");
+        }
+    }
+    else if (command == "mem") {
+        showMemoryTo(stream);
+    }
+    else if (command == "mem reset") {
+        resetMemory();
+        stream->println("🧮 Allocation counters and heap samples cleared");
+    }
+    else if (command == "config") {
+        showConfigTo(stream);
+    }
+    else if (command == "config save") {
+        if (saveConfig()) {
+            stream->println("💾 Configuration saved");
+        } else {
+            stream->println("❌ Could not write configuration to NVS");
+        }
+    }
+    else if (command == "config reset") {
+        resetConfig();
+        stream->println("💾 Stored configuration erased, defaults apply from the next boot");
+    }
     else if (command == "status") {
         showStatusTo(stream);
     }
+    else if (command == "status refresh") {
+        // Drop the shadow registers so the settings are read back from the module
+        dmr.invalidateCache();
+        showStatusTo(stream);
+    }
     else if (command == "info") {
         showDeviceInfoTo(stream);
     }
@@ -263,7 +353,117 @@ void processCommand(Stream* stream, String command) {
         }
     }
 
+    else if (command == "trace" || command.startsWith("trace ")) {
+        String arg = command.length() > 5 ? command.substring(6) : "";
+        arg.trim();
+        
+        if (arg.startsWith("level")) {
+            String levelStr = arg.substring(5);
+            levelStr.trim();
+            if (levelStr.length() > 0) {
+                dmrTraceSetLevel(levelStr.toInt());
+            }
+            stream->print("🔎 Trace level: ");
+            stream->print(dmrTraceGetLevel());
+            stream->print(" (compiled max ");
+            stream->print(DMR_TRACE_LEVEL);
+            stream->println(")");
+        } else if (arg == "clear") {
+            dmrTraceClear();
+            stream->println("🔎 Trace buffer cleared");
+        } else {
+            const DMRTraceStats &ts = dmrTraceGetStats();
+            stream->print("🔎 Trace: ");
+            stream->print(ts.recorded);
+            stream->print(" recorded, ");
+            stream->print(ts.overwritten);
+            stream->println(" overwritten");
+            size_t n = dmrTraceDrain(*stream);
+            if (n == 0) {
+                stream->println("  (no events)");
+            }
+        }
+    }
 
+    else if (command == "linkstats" || command.startsWith("linkstats ")) {
+        String arg = command.length() > 9 ? command.substring(10) : "";
+        arg.trim();
+        
+        if (arg.startsWith("rate")) {
+            String rateStr = arg.substring(4);
+            rateStr.trim();
+            uint32_t rate = rateStr.toInt();
+            if (rate == 0) {
+                linkSampler.stop();
+                stream->println("📶 Link sampling stopped");
+            } else {
+                linkSampler.begin(rate);
+                stream->print("📶 Link sampling every ");
+                stream->print(linkSampler.getInterval());
+                stream->println(" ms");
+            }
+        } else if (arg == "clear") {
+            linkSampler.clear();
+            stream->println("📶 Link history cleared");
+        } else {
+            showLinkStatsTo(stream, arg.toInt() * 1000UL);
+        }
+    }
+    else if (command == "scan" || command.startsWith("scan ")) {
+        String arg = command.length() > 4 ? command.substring(5) : "";
+        arg.trim();
+        
+        if (arg == "stop") {
+            channelScanner.abort();
+            stream->println("📡 Scan stopping, restoring channel...");
+        } else if (arg == "result") {
+            showScanResultsTo(stream);
+        } else if (arg == "use") {
+            uint8_t best = channelScanner.isRunning() ? 0 : channelScanner.getBestChannel();
+            if (best == 0) {
+                stream->println("❌ No completed scan");
+            } else {
+                processCommand(stream, "channel " + String(best));
+            }
+        } else {
+            // scan [dwell_ms] [first-last]
+            uint32_t dwell = DMR_SCAN_DEFAULT_DWELL_MS;
+            uint16_t mask = DMR_SCAN_ALL_CHANNELS;
+            int space = arg.indexOf(' ');
+            String dwellStr = space >= 0 ? arg.substring(0, space) : arg;
+            String rangeStr = space >= 0 ? arg.substring(space + 1) : "";
+            if (dwellStr.toInt() > 0) {
+                dwell = dwellStr.toInt();
+            }
+            int dash = rangeStr.indexOf('-');
+            if (dash > 0) {
+                int first = rangeStr.substring(0, dash).toInt();
+                int last = rangeStr.substring(dash + 1).toInt();
+                mask = 0;
+                for (int ch = first; ch <= last && ch <= 16; ch++) {
+                    if (ch >= 1) mask |= 1U << (ch - 1);
+                }
+            }
+            
+            if (hopScheduler.isRunning()) {
+                stream->println("❌ Stop hopping first (hop stop)");
+                return;
+            }
+            
+            // RSSI taken on other channels would pollute the link history
+            bool sampling = linkSampler.isRunning();
+            linkSampler.stop();
+            if (channelScanner.start(mask, dwell, onScanDone, nullptr, wtState.currentChannel)) {
+                resumeLinkSampler = sampling;
+                stream->print("📡 Scanning, ");
+                stream->print(dwell);
+                stream->println(" ms per channel...");
+            } else {
+                if (sampling) linkSampler.begin(linkSampler.getInterval());
+                stream->println("❌ Cannot scan now (scan running, SMS queued or config in progress)");
+            }
+        }
+    }
     else if (command == "i2cscan") {
         scanI2CDevices();
     }
@@ -272,9 +472,10 @@ void processCommand(Stream* stream, String command) {
     }
     else if (command == "keyscan") {
         stream->println("Keyboard scanning mode enabled. Watch for key presses...");
-        for (int i = 0; i < 50; i++) { // Scan for 1 second (50 * 20ms)
+        for (int i = 0; i < 1000 / KEY_SCAN_MS; i++) { // Scan for 1 second at the keypad timer's rate
             scanKeyboard();
-            delay(20);
+            handleKeyEvents();
+            delay(KEY_SCAN_MS);
         }
         stream->println("Keyboard scanning test complete.");
     }
@@ -313,6 +514,15 @@ void showCommandsTo(Stream* stream) {
     stream->println();
     stream->println("Information:");
     stream->println("  status                  - Show status");
+    stream->println("  status refresh          - Re-read module settings");
+    stream->println("  config [save|reset]     - Show, save now, or erase stored settings");
+    stream->println("  boottime                - Per-stage boot timeline");
+    stream->println("  tasks [reset]           - Task stacks, queue waits, worst event latency");
+    stream->println("  timers                  - Periodic jobs: wakeups, missed periods, lateness");
+    stream->println("  perf [reset]            - Per-stage latency histograms, worst case and when");
+    stream->println("  stalls [clear]          - Handlers over budget, with DMR receive backlog");
+    stream->println("  stalls budget <ms>      - Stall budget (0=off)");
+    stream->println("  mem [reset]             - Allocations per site and hour, heap fragmentation");
     stream->println("  info                    - Device info");
     stream->println("  smsinfo                 - SMS tracking status");
     stream->println("  fallback                - Manual fallback trigger");
@@ -324,12 +534,23 @@ void showCommandsTo(Stream* stream) {
     stream->println("  i2cscan                 - Scan for I2C devices");
     stream->println("  keytest                 - Test keyboard matrix");
     stream->println("  keyscan                 - Live keyboard scanning test");
+    stream->println("  trace                   - Dump DMR trace events");
+    stream->println("  trace level <0-3>       - Set trace level (0=off 3=debug)");
+    stream->println("  trace clear             - Clear trace buffer");
+    stream->println("  linkstats [seconds]     - RSSI/link statistics (all or last N s)");
+    stream->println("  linkstats rate <ms>     - Link sampling interval (0=stop)");
+    stream->println("  linkstats clear         - Clear link history");
+    stream->println("  scan [ms] [first-last]  - Channel occupancy scan (dwell per channel)");
+    stream->println("  scan stop/result/use    - Abort, show table, switch to best channel");
+    stream->println("  hop start <seed> <base_hz> <spacing_hz> <n> [slot_ms] - GPS-timed hopping");
+    stream->println("  hop stop / hop / hop lead <ms|auto> - Stop, status, retune lead");
     stream->println();
     stream->println("GSM Fallback:");
     stream->println("  gsmstatus               - Check GSM module status");
     stream->println("  gsmcmd <AT_command>     - Send raw AT cmd to GSM");
     stream->println("  gsmphone <number>       - Set fallback phone number");
     stream->println("  gsmsms <number> <msg>   - Send SMS via GSM directly");
+    stream->println("  gsmgps <number>         - Send GPS location via GSM");
     stream->println("  soldierid <id>          - Set soldier identification");
     stream->println();
     stream->println("LoRa Communication:");
@@ -373,9 +594,12 @@ void showStatusTo(Stream* stream) {
     stream->print("Radio ID: 0x"); stream->println(wtState.myRadioID, HEX);
     stream->print("Channel: "); stream->println(wtState.currentChannel);
     stream->print("Volume: "); stream->println(wtState.volume);
-    stream->print("RSSI: "); stream->println(dmr.getRSSI());
+    // Recent sampler reading when there is one, else ask the module
+    DMRLinkSample sample;
+    bool sampled = getRecentLinkSample(sample);
+    stream->print("RSSI: "); stream->println(sampled ? sample.rssi : dmr.getRSSI());
     
-    DMRModuleStatus status = dmr.getModuleStatus();
+    DMRModuleStatus status = sampled && sample.status ? (DMRModuleStatus)sample.status : dmr.getModuleStatus();
     stream->print("Module Status: ");
     switch(status) {
         case STATUS_RECEIVING: stream->println("Receiving"); break;
@@ -384,15 +608,26 @@ void showStatusTo(Stream* stream) {
         default: stream->println("Unknown"); break;
     }
     
+    // Module settings come from the shadow registers; only missing ones are queried
+    stream->print("Color Code: "); stream->print(dmr.getColorCode());
+    stream->print(", Slot: "); stream->print(dmr.getTimeSlot());
+    stream->print(", Power: "); stream->println(dmr.getTXPower());
+    stream->print("Encryption: "); stream->println(dmr.getEncryptionStatus() ? "ON" : "OFF");
+    uint32_t age = dmr.getCacheAge(SHADOW_COLOR_CODE);
+    if (age != DMR_SHADOW_NEVER) {
+        stream->print("  (settings read "); stream->print(age / 1000); stream->println(" s ago)");
+    }
+    
     // GPS Status
     stream->println();
     stream->println("📍 GPS Status:");
+    GPSFixSnapshot fix = currentGPSFix();
     stream->print("  Position: ");
-    stream->print(gpsState.latitude, 6);
+    stream->print(fix.latitude, 6);
     stream->print(", ");
-    stream->println(gpsState.longitude, 6);
+    stream->println(fix.longitude, 6);
     stream->print("  Valid Fix: ");
-    stream->println(gpsState.hasValidFix ? "YES" : "NO");
+    stream->println(fix.valid ? "YES" : "NO");
     stream->print("  Auto-transmission: ");
     stream->println(gpsState.continuousMode ? "ENABLED" : "DISABLED");
     
@@ -404,7 +639,8 @@ void showStatusTo(Stream* stream) {
     stream->print("  Network: ");
     stream->println(gsmState.networkRegistered ? "REGISTERED" : "NOT REGISTERED");
     stream->print("  Fallback Phone: ");
-    stream->println(gsmState.phoneNumber.length() > 0 ? gsmState.phoneNumber : "Not configured");
+    String phone = currentPhoneNumber();
+    stream->println(phone.length() > 0 ? phone : "Not configured");
 }
 
 void showDeviceInfo() {
@@ -434,4 +670,77 @@ void showDeviceInfoTo(Stream* stream) {
     stream->print("Uptime: ");
     stream->print(millis() / 1000);
     stream->println(" seconds");
-}
\ No newline at end of file
+}
+
+void showLinkStatsTo(Stream* stream, uint32_t windowMs) {
+    stream->println("\n📶 Link Statistics:");
+    stream->println("===================");
+    stream->print("Sampling: ");
+    if (linkSampler.isRunning()) {
+        stream->print("every "); stream->print(linkSampler.getInterval()); stream->println(" ms");
+    } else {
+        stream->println("stopped");
+    }
+    
+    DMRLinkStats stats;
+    if (!linkSampler.getStats(stats, windowMs)) {
+        stream->print("No answered samples yet (");
+        stream->print(stats.missed);
+        stream->println(" missed)");
+        return;
+    }
+    
+    stream->print("Window: "); stream->print(stats.spanMs / 1000); stream->print(" s, ");
+    stream->print(stats.samples); stream->print(" samples, ");
+    stream->print(stats.missed); stream->println(" missed");
+    stream->print("RSSI last/min/max: "); stream->print(stats.last); stream->print(" / ");
+    stream->print(stats.min); stream->print(" / "); stream->println(stats.max);
+    stream->print("RSSI mean: "); stream->println(stats.mean, 1);
+    stream->print("RSSI p10/p50/p90: "); stream->print(stats.p10); stream->print(" / ");
+    stream->print(stats.p50); stream->print(" / "); stream->println(stats.p90);
+    stream->print("Trend: "); stream->print(stats.trendPerMin, 1); stream->println(" per min");
+    stream->print("Busy: RX "); stream->print(stats.receiving * 100 / stats.samples);
+    stream->print("%, TX "); stream->print(stats.transmitting * 100 / stats.samples); stream->println("%");
+}
+
+void showScanResultsTo(Stream* stream) {
+    if (channelScanner.isRunning()) {
+        stream->print("📡 Scan running, channel ");
+        stream->println(channelScanner.getCurrentChannel());
+        return;
+    }
+    if (channelScanner.getResultCount() == 0) {
+        stream->println("📡 No scan yet");
+        return;
+    }
+    
+    stream->println("\n📡 Channel Scan:");
+    stream->println("CH  Busy%  RSSI avg/min/max  Samples");
+    for (uint8_t i = 0; i < channelScanner.getResultCount(); i++) {
+        const DMRChannelScanResult &r = channelScanner.getResult(i);
+        char line[48];
+        if (r.switched) {
+            snprintf(line, sizeof(line), "%2u  %5u  %3u / %3u / %3u     %u",
+                     r.channel, r.occupancy(), r.rssiMean(), r.rssiMin, r.rssiMax, r.samples);
+        } else {
+            snprintf(line, sizeof(line), "%2u  (switch failed)", r.channel);
+        }
+        stream->println(line);
+    }
+    stream->print("Best channel: "); stream->println(channelScanner.getBestChannel());
+    stream->print("Restored to channel ");
+    stream->print(channelScanner.getOriginalChannel());
+    stream->println(channelScanner.wasRestored() ? "" : " - NOT ACKED, check the radio");
+}
+
+// Runs on the radio task long after the command returned, so the results go
+// to Bluetooth like the other DMR callbacks, not to whoever asked
+static void onScanDone(const DMRChannelScanner &scanner, void *context) {
+    if (resumeLinkSampler) {
+        linkSampler.begin(linkSampler.getInterval());
+    }
+    showScanResultsTo(&SerialBT);
+    if (scanner.getBestChannel()) {
+        addMessage("Scan: best CH " + String(scanner.getBestChannel()));
+    }
+}
@@ -4,47 +4,336 @@
 #include "managers/LoRaManager.h"
 #include "managers/DisplayManager.h"
 #include "managers/KeyboardManager.h"
+#include "managers/ConfigManager.h"
+#include "managers/BootManager.h"
+#include "managers/TaskManager.h"
+#include "managers/MemoryManager.h"
 
 // Global instances
 DMR828S dmr(Serial2);
+DMRLinkSampler linkSampler(dmr);
+DMRChannelScanner channelScanner(dmr);
+DMRHopScheduler hopScheduler(dmr);
 BluetoothSerial SerialBT;
 WalkieTalkieState wtState;
 DemoMode currentMode = MODE_WALKIE_FEATURES;
 
-void initializeSystem() {
-    // Initialize GSM module on Serial1
-    Serial1.begin(9600, SERIAL_8N1, GSM_RX_PIN, GSM_TX_PIN);
+// Boot step: open the DMR UART, then poll module status until the module
+// answers instead of waiting a fixed 2 s for it to come up
+static bool dmrAnswered = false;
+
+static void onDMRProbe(bool ok, const DMRFrameView &response, void *context) {
+    if (ok) {
+        dmrAnswered = true;
+    }
+}
+
+static BootStatus pollDMRInit(BootStage &stage) {
+    if (stage.phase == 0) {
+        Serial2.begin(57600, SERIAL_8N1, 16, 17); // RX2=GPIO16, TX2=GPIO17
+        dmr.begin(57600);
+        dmr.enableDebug(false);  // Hex dumps off; events go to the trace buffer
+        dmr.enableChecksum(false);
+        
+        // Let a UART-event-driven task parse frames; update() just drains its queue
+        if (!dmr.getLowLevel().beginEventRx()) {
+            Serial.println("⚠️ DMR event receive unavailable - polling Serial2");
+        }
+        
+        // Set event callbacks
+        dmr.setSMSReceivedCallback(onSMSReceived);
+        dmr.setSMSSendStatusCallback(onSMSStatus);
+        dmr.setCallReceivedCallback(onCallReceived);
+        dmr.setCallEndedCallback(onCallEnded);
+        dmr.setEmergencyCallback(onEmergency);
+        
+        // Further consumers of the same frames: position parsing, call-out log, display
+        dmr.subscribeEvent(DMR_EVENT_SMS_RECEIVED, onPositionSMS);
+        dmr.subscribeEvent(DMR_EVENT_CALL_OUT_START, onCallOutEvent);
+        dmr.subscribeEvent(DMR_EVENT_CALL_OUT_END, onCallOutEvent);
+        dmr.subscribeEvent(DMR_EVENT_CALL_OUT_FAILED, onCallOutEvent);
+        subscribeDisplayEvents();
+        
+        dmrAnswered = false;
+        stage.pollAt = millis() - DMR_PROBE_INTERVAL_MS;
+        bootPhase(stage, 1);
+    }
     
-    // Initialize Bluetooth
-    SerialBT.begin("FATMAN"); // Bluetooth device name
+    dmr.update();
+    if (dmrAnswered) {
+        // RSSI/status history for linkstats, the display and routing decisions
+        linkSampler.begin(DMR_LINK_DEFAULT_INTERVAL_MS);
+        return BOOT_READY;
+    }
+    if (!dmr.isRequestPending(DMR_CMD_CHECK_STATUS) && millis() - stage.pollAt >= DMR_PROBE_INTERVAL_MS) {
+        dmr.requestModuleStatus(onDMRProbe);
+        stage.pollAt = millis();
+        stage.tries++;
+    }
+    return BOOT_RUNNING;
+}
+
+// Report the outcome of a boot/profile config transaction
+static void reportConfigResult(const DMRConfigResult &result) {
+    SerialBT.print("⚙️ DMR config: ");
+    SerialBT.print(result.acked); SerialBT.print("/"); SerialBT.print(result.total);
+    SerialBT.print(" acked in "); SerialBT.print(result.elapsedMs); SerialBT.print(" ms");
+    if (result.retries > 0) {
+        SerialBT.print(", "); SerialBT.print(result.retries); SerialBT.print(" retries");
+    }
+    SerialBT.println();
     
-    // Initialize GSM module
-    initializeGSM();
+    for (uint8_t i = 0; i < result.failed; i++) {
+        SerialBT.print("❌ Not acknowledged: cmd 0x");
+        SerialBT.println(result.failedCmds[i], HEX);
+    }
+}
+
+// Bring the module in line with the stored configuration, sending only what
+// differs from what it reports. Colour code, slot and power belong to the
+// channel, so a channel change is committed and the channel read back first.
+// Volume, mic gain and squelch cannot be read back and are always sent.
+// Polled like the other boot steps: each phase sends one async request or
+// commit and waits for its callback, keeping update() running meanwhile.
+struct ConfigApply {
+    bool allSettings = true;
+    bool replied = false;           // The phase's request or commit finished
+    bool ok = false;
+    bool known = false;             // Channel parameters read back
+    DMRChannelParams params;
+    uint32_t radioID = 0;
+    uint8_t skipped = 0;
+    DMRConfigResult channelResult;
+    DMRConfigResult result;
+    unsigned long startMs = 0;
+};
+
+static ConfigApply configApply;
+
+static void awaitReply(bool sent) {
+    // A request that could not go out counts as answered, without data
+    configApply.replied = !sent;
+    configApply.ok = false;
+}
+
+static void onApplyParams(bool ok, const DMRFrameView &response, void *context) {
+    configApply.ok = ok && dmr.parseChannelParams(response.data, response.length, configApply.params);
+    configApply.replied = true;
+}
+
+static void onApplyRadioID(bool ok, const DMRFrameView &response, void *context) {
+    configApply.ok = ok && response.length >= 3;
+    if (configApply.ok) {
+        configApply.radioID = ((uint32_t)response.data[0] << 16) | ((uint32_t)response.data[1] << 8) |
+                              response.data[2];
+    }
+    configApply.replied = true;
+}
+
+static void onApplyCommitted(const DMRConfigResult &result, void *context) {
+    *(DMRConfigResult *)context = result;
+    configApply.replied = true;
+}
+
+static void requestApplyRadioID(BootStage &stage) {
+    if (configApply.known) {
+        awaitReply(dmr.requestRadioID(onApplyRadioID));
+    } else {
+        awaitReply(false);
+    }
+    bootPhase(stage, 4);
+}
+
+static BootStatus pollApplyConfig(BootStage &stage) {
+    ConfigApply &apply = configApply;
+    if (stage.phase == 0) {
+        apply.skipped = 0;
+        apply.known = false;
+        apply.channelResult = DMRConfigResult();
+        apply.result = DMRConfigResult();
+        apply.startMs = millis();
+        awaitReply(dmr.requestChannelParams(onApplyParams));
+        bootPhase(stage, 1);
+        return BOOT_RUNNING;
+    }
     
-    // Initialize LoRa module
-    initializeLoRa();
+    dmr.update();
+    if (!apply.replied) {
+        return BOOT_RUNNING;
+    }
     
-    // Initialize GPS
-    initializeGPS();
+    switch (stage.phase) {
+        case 1:
+            // Channel parameters as the module has them
+            apply.known = apply.ok;
+            if (apply.known && apply.params.channel != wtConfig.channel) {
+                dmr.beginConfig();
+                dmr.setChannel(wtConfig.channel);
+                awaitReply(dmr.commitConfigAsync(onApplyCommitted, &apply.channelResult));
+                bootPhase(stage, 2);
+            } else {
+                if (apply.known) apply.skipped++;
+                requestApplyRadioID(stage);
+            }
+            return BOOT_RUNNING;
+            
+        case 2:
+            // Channel changed: read back what the new channel holds
+            if (apply.channelResult.failed == 0 && apply.channelResult.total > 0) {
+                awaitReply(dmr.requestChannelParams(onApplyParams));
+                bootPhase(stage, 3);
+            } else {
+                apply.known = false;
+                requestApplyRadioID(stage);
+            }
+            return BOOT_RUNNING;
+            
+        case 3:
+            apply.known = apply.ok && apply.params.channel == wtConfig.channel;
+            requestApplyRadioID(stage);
+            return BOOT_RUNNING;
+            
+        case 4: {
+            // Everything else that differs, in one transaction
+            bool radioIDKnown = apply.ok;
+            DMRChannelParams &params = apply.params;
+            bool known = apply.known;
+            dmr.beginConfig();
+            if (!known) {
+                // Module did not answer; fall back to sending everything
+                dmr.setChannel(wtConfig.channel);
+            }
+            if (known && radioIDKnown && apply.radioID == wtConfig.radioID) {
+                apply.skipped++;
+            } else {
+                dmr.setRadioID(wtConfig.radioID);
+            }
+            dmr.setVolume(wtConfig.volume);
+            
+            if (apply.allSettings) {
+                if (known && params.colorCode == wtConfig.colorCode) apply.skipped++; else dmr.setColorCode(wtConfig.colorCode);
+                if (known && params.timeSlot == wtConfig.timeSlot) apply.skipped++; else dmr.setTimeSlot(wtConfig.timeSlot);
+                if (known && params.power == wtConfig.txPower) apply.skipped++; else dmr.setTXPower(wtConfig.txPower);
+                dmr.setMicGain(wtConfig.micGain);
+                dmr.setSQLLevel(wtConfig.sqlLevel);
+            }
+            awaitReply(dmr.commitConfigAsync(onApplyCommitted, &apply.result));
+            bootPhase(stage, 5);
+            return BOOT_RUNNING;
+        }
+    }
     
-    // Initialize I2C Display and Keyboard
-    initializeDisplay();
-    initializeKeyboard();
+    DMRConfigResult &diff = apply.result;
+    const DMRConfigResult &result = apply.channelResult;
+    diff.total += result.total;
+    diff.acked += result.acked;
+    diff.retries += result.retries;
+    diff.elapsedMs += result.elapsedMs;
+    for (uint8_t i = 0; i < result.failed && diff.failed < DMR_CONFIG_MAX_WRITES; i++) {
+        diff.failedCmds[diff.failed++] = result.failedCmds[i];
+    }
+    reportConfigResult(diff);
     
-    // Initialize DMR module
-    Serial2.begin(57600, SERIAL_8N1, 16, 17); // RX2=GPIO16, TX2=GPIO17
-    dmr.begin(57600);
-    dmr.enableDebug(true);
-    dmr.enableChecksum(false);
+    SerialBT.print("⚙️ Config ");
+    SerialBT.print(configState.loaded ? "from NVS" : "defaults");
+    SerialBT.print(", "); SerialBT.print(apply.skipped); SerialBT.print(" unchanged setting(s) skipped, ");
+    SerialBT.print(millis() - apply.startMs); SerialBT.println(" ms total");
+    return BOOT_READY;
+}
+
+// Setup functions for different modes
+void setupBasicTest() {
+    // Radio ID, channel and volume
+    configApply.allSettings = false;
+    runBootStep(pollApplyConfig, 0);
+}
+
+void setupWalkieFeatures() {
+    // Complete walkie-talkie setup
+    configApply.allSettings = true;
+    runBootStep(pollApplyConfig, 0);
+}
+
+// Boot step: module settings for the current mode; the radio can transmit after this
+static BootStatus setupDMRMode(BootStage &stage) {
+    if (currentMode == MODE_LOW_LEVEL) {
+        setupLowLevel();
+        markTransmitReady();
+        return BOOT_READY;
+    }
+    if (stage.phase == 0) {
+        configApply.allSettings = currentMode == MODE_WALKIE_FEATURES;
+    }
+    BootStatus status = pollApplyConfig(stage);
+    if (status == BOOT_READY) {
+        markTransmitReady();
+    }
+    return status;
+}
+
+static BootStatus startBluetooth(BootStage &stage) {
+    if (!SerialBT.begin("FATMAN")) { // Bluetooth device name
+        stage.detail = "no controller";
+        return BOOT_FAILED;
+    }
+    return BOOT_READY;
+}
+
+static BootStatus loadStoredConfig(BootStage &stage) {
+    // Settings saved at runtime survive the reset
+    stage.detail = loadConfig() ? "from NVS" : "defaults";
+    return BOOT_READY;
+}
+
+// Boot stages, in the order each pass visits them. Everything that reports
+// over Bluetooth waits for it; the keypad shares the display's I2C bus.
+enum BootStageIndex {
+    STAGE_BLUETOOTH,
+    STAGE_CONFIG,
+    STAGE_DMR,
+    STAGE_DMR_SETUP,
+    STAGE_GSM,
+    STAGE_LORA,
+    STAGE_GPS,
+    STAGE_DISPLAY,
+    STAGE_KEYBOARD,
+    STAGE_COUNT
+};
+
+static BootStage bootStages[STAGE_COUNT] = {
+    BootStage("bluetooth", startBluetooth),
+    BootStage("config", loadStoredConfig),
+    BootStage("dmr", pollDMRInit, BOOT_STAGE(STAGE_BLUETOOTH), DMR_BOOT_TIMEOUT_MS),
+    BootStage("dmr setup", setupDMRMode, BOOT_STAGE(STAGE_DMR) | BOOT_STAGE(STAGE_CONFIG)),
+    BootStage("gsm", pollGSMInit, BOOT_STAGE(STAGE_BLUETOOTH), GSM_INIT_TIMEOUT_MS),
+    BootStage("lora", pollLoRaInit, BOOT_STAGE(STAGE_BLUETOOTH), LORA_INIT_TIMEOUT_MS),
+    BootStage("gps", pollGPSInit),
+    BootStage("display", pollDisplayInit),
+    BootStage("keyboard", pollKeyboardInit, BOOT_STAGE(STAGE_DISPLAY)),
+};
+
+void initializeSystem() {
+    // Allocation counts cover the whole boot
+    initializeMemory();
+    
+    // Queues first: boot steps may already log to the display
+    initializeTasks();
+    
+    // Initialize GSM module on Serial1
+    Serial1.begin(9600, SERIAL_8N1, GSM_RX_PIN, GSM_TX_PIN);
     
-    // Set event callbacks
-    dmr.setSMSReceivedCallback(onSMSReceived);
-    dmr.setSMSSendStatusCallback(onSMSStatus);
-    dmr.setCallReceivedCallback(onCallReceived);
-    dmr.setCallEndedCallback(onCallEnded);
-    dmr.setEmergencyCallback(onEmergency);
+    // Stages run interleaved as their dependencies come up
+    runBoot(bootStages, STAGE_COUNT, BOOT_DEADLINE_MS);
     
-    delay(2000); // Wait for module to initialize
+    if (bootState.transmitReadyMs) {
+        SerialBT.print("⏱️ Ready to transmit in ");
+        SerialBT.print(bootState.transmitReadyMs - bootState.startMs);
+        SerialBT.print(" ms, boot done in ");
+    } else {
+        SerialBT.print("⏱️ DMR not configured, boot done in ");
+    }
+    SerialBT.print(bootState.endMs - bootState.startMs);
+    SerialBT.println(" ms - 'boottime' for details");
 }
 
 // DMR Event Callbacks
@@ -53,14 +342,29 @@ void onSMSReceived(const DMRSMSMessage& message) {
     output += "From: 0x" + String(message.sourceID, HEX) + "\n";
     output += "Message: " + String(message.message) + "\n";
     SerialBT.print(output);
-    
-    // Check if this is a GPS message and parse it
-    String msgStr = String(message.message);
-    if (msgStr.startsWith("GPS ")) {
+}
+
+void onPositionSMS(const DMREvent& event, void* context) {
+    String msgStr = String(event.sms->message);
+    if (isPositionReport(msgStr)) {
         parseIncomingGPS(msgStr, "DMR");
     }
 }
 
+void onCallOutEvent(const DMREvent& event, void* context) {
+    switch (event.type) {
+        case DMR_EVENT_CALL_OUT_START:
+            SerialBT.println("📞 Calling 0x" + String(event.targetID, HEX));
+            break;
+        case DMR_EVENT_CALL_OUT_END:
+            SerialBT.println("📞 Call-out Ended");
+            break;
+        default:
+            SerialBT.println("📞 Call-out Failed");
+            break;
+    }
+}
+
 void onCallReceived(const DMRCallInfo& callInfo) {
     String output = "\n📞 Incoming Call:\n";
     output += "From: 0x" + String(callInfo.contactID, HEX) + "\n";
@@ -86,6 +390,21 @@ void onEmergency(uint32_t sourceID) {
     SerialBT.print(output);
 }
 
+// Runs on the radio task: the number and position are its copies of the
+// comms and GPS tasks' state
+static void postGSMFallback(const char *reason, uint32_t targetID) {
+    String phone = currentPhoneNumber();
+    if (phone.length() == 0) {
+        SerialBT.println("❌ No fallback phone number configured");
+        return;
+    }
+    GPSFixSnapshot fix = currentGPSFix();
+    String fallbackMsg = String(reason) + ". Target: 0x" + String(targetID, HEX);
+    fallbackMsg += ". Last known position: " + String(fix.latitude, 6) + ", " + String(fix.longitude, 6);
+    // The modem exchange takes seconds; it runs on the comms task, not here
+    postCommand(TASK_COMMS, &SerialBT, "gsmsms " + phone + " " + fallbackMsg);
+}
+
 void onSMSStatus(uint32_t targetID, SMSSendStatus status) {
     String output = "\n📱 SMS Send Status:\n";
     output += "To: 0x" + String(targetID, HEX) + "\n";
@@ -99,26 +418,14 @@ void onSMSStatus(uint32_t targetID, SMSSendStatus status) {
             SerialBT.print(output);
             
             // GSM fallback - send to predefined emergency number
-            if (gsmState.phoneNumber.length() > 0) {
-                String fallbackMsg = "EMERGENCY: VHF Radio SMS failed. Target: 0x" + String(targetID, HEX);
-                fallbackMsg += ". Last known position: " + String(gpsState.latitude, 6) + ", " + String(gpsState.longitude, 6);
-                sendGSMFallbackSMS(gsmState.phoneNumber, fallbackMsg);
-            } else {
-                SerialBT.println("❌ No fallback phone number configured");
-            }
+            postGSMFallback("EMERGENCY: VHF Radio SMS failed", targetID);
             return;
         case SMS_SEND_TIMEOUT:
             output += "Status: ⏰ TIMEOUT - Trying GSM fallback...\n";
             SerialBT.print(output);
             
             // GSM fallback for timeout
-            if (gsmState.phoneNumber.length() > 0) {
-                String fallbackMsg = "TIMEOUT: VHF Radio SMS timeout. Target: 0x" + String(targetID, HEX);
-                fallbackMsg += ". Last known position: " + String(gpsState.latitude, 6) + ", " + String(gpsState.longitude, 6);
-                sendGSMFallbackSMS(gsmState.phoneNumber, fallbackMsg);
-            } else {
-                SerialBT.println("❌ No fallback phone number configured");
-            }
+            postGSMFallback("TIMEOUT: VHF Radio SMS timeout", targetID);
             return;
     }
     
@@ -126,28 +433,6 @@ void onSMSStatus(uint32_t targetID, SMSSendStatus status) {
     SerialBT.print(output);
 }
 
-// Setup functions for different modes
-void setupBasicTest() {
-    // Basic configuration
-    dmr.setRadioID(wtState.myRadioID);
-    dmr.setChannel(wtState.currentChannel);
-    dmr.setVolume(wtState.volume);
-}
-
-void setupWalkieFeatures() {
-    // Complete walkie-talkie setup
-    dmr.setRadioID(wtState.myRadioID);
-    dmr.setChannel(wtState.currentChannel);
-    dmr.setVolume(wtState.volume);
-    
-    // Additional settings
-    dmr.setColorCode(1);
-    dmr.setTimeSlot(1);
-    dmr.setTXPower(3);
-    dmr.setMicGain(8);
-    dmr.setSQLLevel(5);
-}
-
 void setupLowLevel() {
     SerialBT.println("🔧 Low-Level Protocol Mode");
     
@@ -159,6 +444,45 @@ void setupLowLevel() {
     SerialBT.println("Low-level protocol access ready");
 }
 
+// Latest sampler reading, if it is recent enough to stand in for a live query
+bool getRecentLinkSample(DMRLinkSample &sample) {
+    return linkSampler.getLatest(sample) && sample.ok &&
+           millis() - sample.time <= 2 * linkSampler.getInterval();
+}
+
+const char* moduleStatusName(uint8_t status) {
+    switch (status) {
+        case STATUS_RECEIVING: return "RX";
+        case STATUS_TRANSMITTING: return "TX";
+        case STATUS_STANDBY: return "Standby";
+        default: return "?";
+    }
+}
+
+// Feed each new GPS UTC fix to the hop clock, then retune if a slot boundary passed
+void updateFrequencyHopping() {
+    GPSTimeSync sync;
+    if (receiveGPSTime(sync)) {
+        hopScheduler.setTime(sync.utcMillis, sync.atMillis);
+    }
+    hopScheduler.update();
+}
+
+// Periodic status line, from the link sampler so the loop never waits on the module
+static void printStatusLine(const char *prefix) {
+    SerialBT.print(prefix);
+    SerialBT.print("Ch:"); SerialBT.print(wtState.currentChannel);
+    SerialBT.print(", Vol:"); SerialBT.print(wtState.volume);
+    
+    DMRLinkSample sample;
+    if (getRecentLinkSample(sample)) {
+        SerialBT.print(", RSSI:"); SerialBT.print(sample.rssi);
+        SerialBT.print(", Status:"); SerialBT.println(moduleStatusName(sample.status));
+    } else {
+        SerialBT.println(", RSSI: no recent sample");
+    }
+}
+
 // Loop functions for different modes
 void loopBasicTest() {
     static unsigned long lastStatus = 0;
@@ -166,18 +490,7 @@ void loopBasicTest() {
         lastStatus = millis();
         
         // Show periodic status
-        SerialBT.print(", Ch:"); SerialBT.print(wtState.currentChannel);
-        SerialBT.print(", Vol:"); SerialBT.print(wtState.volume);
-        SerialBT.print(", RSSI:"); SerialBT.print(dmr.getRSSI());
-        
-        DMRModuleStatus status = dmr.getModuleStatus();
-        SerialBT.print(", Status:");
-        switch(status) {
-            case STATUS_RECEIVING: SerialBT.println("RX"); break;
-            case STATUS_TRANSMITTING: SerialBT.println("TX"); break;
-            case STATUS_STANDBY: SerialBT.println("Standby"); break;
-            default: SerialBT.println("?"); break;
-        }
+        printStatusLine("");
     }
 }
 
@@ -187,18 +500,7 @@ void loopWalkieFeatures() {
         lastStatus = millis();
         
         // Show periodic status
-        SerialBT.print("📊 Ch:"); SerialBT.print(wtState.currentChannel);
-        SerialBT.print(", Vol:"); SerialBT.print(wtState.volume);
-        SerialBT.print(", RSSI:"); SerialBT.print(dmr.getRSSI());
-        
-        DMRModuleStatus status = dmr.getModuleStatus();
-        SerialBT.print(", Status:");
-        switch(status) {
-            case STATUS_RECEIVING: SerialBT.println("RX"); break;
-            case STATUS_TRANSMITTING: SerialBT.println("TX"); break;
-            case STATUS_STANDBY: SerialBT.println("Standby"); break;
-            default: SerialBT.println("?"); break;
-        }
+        printStatusLine("📊 ");
     }
 }
 
@@ -246,9 +548,13 @@ void handleBluetoothCommands() {
 
 // =============== GPS JSON FORMATTING FUNCTIONS ===============
 
-String formatGPSToJSON(double lat, double lon, String soldierId, String commMode) {
+String formatGPSToJSON(double lat, double lon, String soldierId, String commMode, String timestamp) {
+    DMR_MEM_SCOPE(MEM_GPS_JSON);
+    
     // Get GPS timestamp (uses GPS time if available, fallback to system time)
-    String timestamp = getGPSTimestamp();
+    if (timestamp.length() == 0) {
+        timestamp = getGPSTimestamp();
+    }
     
     // Create JSON string
     String json = "{\n";
@@ -263,6 +569,19 @@ String formatGPSToJSON(double lat, double lon, String soldierId, String commMode
 }
 
 void parseIncomingGPS(String message, String commMode) {
+    // Compact binary report: "#G" + base64url (see PositionCodec.h)
+    if (message.startsWith(POSITION_TEXT_PREFIX)) {
+        PositionReport report;
+        if (decodePositionText(message, report)) {
+            String timestamp = report.hasTime ? getGPSTimestamp(report.secondsOfDay) : "";
+            processGPSData(report.latitude, report.longitude, report.soldierID, commMode, timestamp);
+        } else {
+            // Usually a delta whose key report was lost; the next key report recovers
+            SerialBT.println("⚠️ Undecodable GPS report via " + commMode);
+        }
+        return;
+    }
+    
     // Parse GPS message format: "GPS STATUS: SOLDIER_ID,LAT,LON"
     if (message.startsWith("GPS ")) {
         int colonPos = message.indexOf(": ");
@@ -288,9 +607,9 @@ void parseIncomingGPS(String message, String commMode) {
     }
 }
 
-void processGPSData(double lat, double lon, String soldierId, String commMode) {
+void processGPSData(double lat, double lon, String soldierId, String commMode, String timestamp) {
     // Format to JSON
-    String jsonData = formatGPSToJSON(lat, lon, soldierId, commMode);
+    String jsonData = formatGPSToJSON(lat, lon, soldierId, commMode, timestamp);
     
     // Output JSON to Serial and Bluetooth
     SerialBT.println("\n📍 GPS Data Received:");
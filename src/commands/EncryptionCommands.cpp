@@ -57,7 +57,8 @@ void handleEncryptionCommand(Stream* stream, String command) {
         }
     }
     else if (command == "encrypt status") {
-        // Get current encryption status
-        stream->println("🔐 Encryption Status: [Feature available - check DMR module]");
+        // Answered from the shadow registers after the first query
+        stream->print("🔐 Encryption Status: ");
+        stream->println(dmr.getEncryptionStatus() ? "ON" : "OFF");
     }
 }
\ No newline at end of file
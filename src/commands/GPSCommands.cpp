@@ -1,6 +1,7 @@
 #include "GPSCommands.h"
 #include "../../include/WalkieTalkie.h"
 #include "../managers/GPSManager.h"
+#include "../managers/TaskManager.h"
 #include "DMR828S.h"
 
 extern WalkieTalkieState wtState;
@@ -14,39 +15,21 @@ void handleGPSCommand(Stream* stream, String command) {
         uint32_t targetID = strtoul(idStr.c_str(), NULL, 16);
         
         if (targetID > 0) {
-            // Get GPS data
-            double lat, lon;
-            String status;
-            
-            if (gpsState.hasValidFix) {
-                lat = gpsState.latitude;
-                lon = gpsState.longitude;
-                status = "CURRENT";
-            } else if (gpsState.hasLastLocation) {
-                lat = gpsState.lastLatitude;
-                lon = gpsState.lastLongitude;
-                status = "LAST GPS";
-            } else {
-                lat = 29.938971327453903;
-                lon = 77.56449807342506;
-                status = "DEFAULT";
-            }
-            
-            // Create GPS message with soldier ID
-            String gpsMessage = "GPS " + status + ": ";
-            gpsMessage += wtState.soldierID + ",";
-            gpsMessage += String(lat, 6) + "," + String(lon, 6);
+            // Compact report; deltas follow the last key report sent over DMR
+            static PositionEncoder dmrEncoder;
+            PositionReport report = getPositionReport(currentSoldierID());
+            String gpsMessage = encodePositionText(report, dmrEncoder);
             
             // Send via SMS
-            if (dmr.sendSMS(targetID, gpsMessage.c_str())) {
+            if (gpsMessage.length() > 0 && dmr.sendSMS(targetID, gpsMessage.c_str())) {
                 stream->print("📍 GPS sent to 0x");
                 stream->print(targetID, HEX);
                 stream->print(" (");
-                stream->print(status);
+                stream->print(positionFixName(report.fix));
                 stream->print("): ");
-                stream->print(lat, 6);
+                stream->print(report.latitude, 6);
                 stream->print(", ");
-                stream->println(lon, 6);
+                stream->println(report.longitude, 6);
             } else {
                 stream->println("❌ GPS SMS send failed");
             }
@@ -82,11 +65,7 @@ void handleGPSCommand(Stream* stream, String command) {
             // Validate: interval = minutes * 60 + seconds
             unsigned long totalSeconds = (minutes * 60) + seconds;
             if (targetID > 0 && totalSeconds >= 1 && totalSeconds <= 86400) { // Max 24 hours
-                gpsState.continuousMode = true;
-                gpsState.targetID = targetID;
-                gpsState.intervalMinutes = minutes;
-                gpsState.intervalSeconds = seconds;
-                gpsState.lastTransmission = 0; // Send immediately on next check
+                startContinuousGPS(targetID, minutes, seconds);
                 
                 stream->print("📍 Auto-GPS enabled: 0x");
                 stream->print(targetID, HEX);
@@ -103,7 +82,7 @@ void handleGPSCommand(Stream* stream, String command) {
         }
     }
     else if (command == "gpsstop") {
-        gpsState.continuousMode = false;
+        stopContinuousGPS();
         stream->println("📍 Auto-GPS transmission stopped");
     }
     else if (command == "gpsinfo") {
@@ -1,6 +1,8 @@
 #include "GSMCommands.h"
 #include "../../include/WalkieTalkie.h"
 #include "../managers/GSMManager.h"
+#include "../managers/GPSManager.h"
+#include "../managers/TaskManager.h"
 
 extern GSMState gsmState;
 extern WalkieTalkieState wtState;
@@ -120,4 +122,26 @@ void handleGSMCommand(Stream* stream, String command) {
             stream->println("❌ Format: gsmsms <number> <message>");
         }
     }
+    else if (command.startsWith("gsmgps ")) {
+        String phone = command.substring(7);
+        phone.trim();
+        if (phone.length() > 0) {
+            // Compact report; deltas follow the last key report sent over GSM
+            static PositionEncoder gsmEncoder;
+            PositionReport report = getPositionReport(currentSoldierID());
+            String gpsMessage = encodePositionText(report, gsmEncoder);
+            if (gpsMessage.length() > 0) {
+                sendGSMFallbackSMS(phone, gpsMessage);
+                stream->print("📍 GPS sent via GSM to ");
+                stream->print(phone);
+                stream->print(" (");
+                stream->print(positionFixName(report.fix));
+                stream->println(")");
+            } else {
+                stream->println("❌ Failed to encode GPS report");
+            }
+        } else {
+            stream->println("❌ Format: gsmgps <number>");
+        }
+    }
 }
@@ -0,0 +1,110 @@
+#include "HopCommands.h"
+#include "../../include/WalkieTalkie.h"
+#include "../managers/GPSManager.h"
+#include "../managers/DisplayManager.h"
+#include "DMR828S_hop.h"
+
+static void printFrequency(Stream* stream, uint32_t hz) {
+    stream->print(hz / 1000000UL);
+    stream->print(".");
+    uint32_t khz = (hz / 1000UL) % 1000;
+    if (khz < 100) stream->print("0");
+    if (khz < 10) stream->print("0");
+    stream->print(khz);
+    stream->print(" MHz");
+}
+
+static void showHopStatus(Stream* stream) {
+    stream->println("\n🔀 Frequency Hopping:");
+    stream->print("State: "); stream->println(hopScheduler.isRunning() ? "HOPPING" : "OFF");
+    stream->print("GPS clock: ");
+    stream->println(hopScheduler.isSynced() ? "synced" : (gpsState.hasUtc ? "stale" : "waiting for GPS"));
+    if (hopScheduler.getFrequencyCount() == 0) {
+        return;
+    }
+    stream->print("Seed: 0x"); stream->println(hopScheduler.getSeed(), HEX);
+    stream->print("Set: "); stream->print(hopScheduler.getFrequencyCount());
+    stream->print(" freqs, slot "); stream->print(hopScheduler.getSlotMs());
+    stream->print(" ms, lead "); stream->print(hopScheduler.getLead()); stream->println(" ms");
+    
+    if (hopScheduler.isRunning() && hopScheduler.getFrequency()) {
+        stream->print("Now: slot "); stream->print((uint32_t)hopScheduler.getSlot());
+        stream->print(" @ "); printFrequency(stream, hopScheduler.getFrequency());
+        stream->print(", next "); printFrequency(stream, hopScheduler.frequencyForSlot(hopScheduler.getSlot() + 1));
+        stream->println();
+    }
+    
+    const DMRHopStats &s = hopScheduler.getStats();
+    stream->print("Retunes: "); stream->print(s.retunes);
+    stream->print(" (acked "); stream->print(s.acked);
+    stream->print(", refused "); stream->print(s.refused);
+    stream->print(", timeout "); stream->print(s.timeouts); stream->println(")");
+    if (s.acked) {
+        char line[64];
+        snprintf(line, sizeof(line), "Retune latency: last %lu, min %lu, mean %lu, max %lu us",
+                 (unsigned long)s.lastUs, (unsigned long)s.minUs,
+                 (unsigned long)s.meanUs(), (unsigned long)s.maxUs);
+        stream->println(line);
+    }
+}
+
+void handleHopCommand(Stream* stream, String command) {
+    if (command == "hop" || command == "hop status") {
+        showHopStatus(stream);
+    }
+    else if (command.startsWith("hop start ")) {
+        // hop start <seed> <base_hz> <spacing_hz> <count> [slot_ms]
+        char args[96];
+        snprintf(args, sizeof(args), "%s", command.substring(10).c_str());
+        char *fields[5];
+        uint8_t n = 0;
+        for (char *tok = strtok(args, " "); tok && n < 5; tok = strtok(NULL, " ")) {
+            fields[n++] = tok;
+        }
+        if (n < 4) {
+            stream->println("❌ Usage: hop start <seed> <base_hz> <spacing_hz> <count> [slot_ms]");
+            return;
+        }
+        if (channelScanner.isRunning()) {
+            stream->println("❌ Channel scan in progress");
+            return;
+        }
+        
+        uint32_t seed = strtoul(fields[0], NULL, 0);
+        uint32_t base = strtoul(fields[1], NULL, 10);
+        uint32_t spacing = strtoul(fields[2], NULL, 10);
+        uint32_t count = strtoul(fields[3], NULL, 10);
+        uint32_t slot = n > 4 ? strtoul(fields[4], NULL, 10) : DMR_HOP_DEFAULT_SLOT_MS;
+        
+        if (count > DMR_HOP_MAX_FREQUENCIES || !hopScheduler.setFrequencies(base, spacing, count)) {
+            stream->print("❌ Hop set must have 1-"); stream->print(DMR_HOP_MAX_FREQUENCIES);
+            stream->println(" frequencies");
+            return;
+        }
+        if (!hopScheduler.start(seed, slot)) {
+            stream->print("❌ Cannot start (slot must be >= "); stream->print(DMR_HOP_MIN_SLOT_MS);
+            stream->println(" ms)");
+            return;
+        }
+        hopScheduler.clearStats();
+        stream->print("🔀 Hopping over "); stream->print(count);
+        stream->print(" frequencies from "); printFrequency(stream, base);
+        stream->println(hopScheduler.isSynced() ? "" : " once GPS time is available");
+        addMessage("Hopping ON");
+    }
+    else if (command == "hop stop") {
+        hopScheduler.stop();
+        stream->println("🔀 Hopping OFF");
+        addMessage("Hopping OFF");
+    }
+    else if (command.startsWith("hop lead ")) {
+        String arg = command.substring(9);
+        arg.trim();
+        hopScheduler.setLead(arg == "auto" ? DMR_HOP_AUTO_LEAD : (uint16_t)arg.toInt());
+        stream->print("🔀 Retune lead: "); stream->print(hopScheduler.getLead());
+        stream->println(arg == "auto" ? " ms (measured)" : " ms");
+    }
+    else {
+        stream->println("❓ Hop commands: hop [status], hop start <seed> <base_hz> <spacing_hz> <count> [slot_ms], hop stop, hop lead <ms|auto>");
+    }
+}
@@ -0,0 +1,4 @@
+#pragma once
+#include <Arduino.h>
+
+void handleHopCommand(Stream* stream, String command);
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "../../include/WalkieTalkie.h"
 #include "../managers/LoRaManager.h"
 #include "../managers/GPSManager.h"
+#include "../managers/TaskManager.h"
 
 extern WalkieTalkieState wtState;
 extern LoRaState loraState;
@@ -46,39 +47,20 @@ void handleLoRaCommand(Stream* stream, String command) {
         String targetStr = command.substring(8);
         targetStr.trim();
         if (targetStr.length() > 0) {
-            // Get GPS data
-            double lat, lon;
-            String status;
+            // Compact report; deltas follow the last key report sent over LoRa
+            static PositionEncoder loraEncoder;
+            PositionReport report = getPositionReport(currentSoldierID());
+            String gpsMessage = encodePositionText(report, loraEncoder);
             
-            if (gpsState.hasValidFix) {
-                lat = gpsState.latitude;
-                lon = gpsState.longitude;
-                status = "CURRENT";
-            } else if (gpsState.hasLastLocation) {
-                lat = gpsState.lastLatitude;
-                lon = gpsState.lastLongitude;
-                status = "LAST GPS";
-            } else {
-                lat = 29.938971327453903;
-                lon = 77.56449807342506;
-                status = "DEFAULT";
-            }
-            
-            // Create GPS message with soldier ID
-            String gpsMessage = "GPS " + status + ": ";
-            gpsMessage += wtState.soldierID + ",";
-            gpsMessage += String(lat, 6) + "," + String(lon, 6);
-            gpsMessage += " [TO:" + targetStr + "]";
-            
-            if (sendLoRaMessage(gpsMessage)) {
+            if (gpsMessage.length() > 0 && sendLoRaMessage(gpsMessage + " [TO:" + targetStr + "]")) {
                 stream->print("📍 GPS sent via LoRa to ");
                 stream->print(targetStr);
                 stream->print(" (");
-                stream->print(status);
+                stream->print(positionFixName(report.fix));
                 stream->print("): ");
-                stream->print(lat, 6);
+                stream->print(report.latitude, 6);
                 stream->print(", ");
-                stream->println(lon, 6);
+                stream->println(report.longitude, 6);
             } else {
                 stream->println("❌ Failed to send GPS via LoRa");
             }
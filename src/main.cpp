@@ -6,52 +6,37 @@
 #include "CommandProcessor.h"
 #include "managers/DisplayManager.h"
 #include "managers/KeyboardManager.h"
+#include "managers/ConfigManager.h"
+#include "managers/TaskManager.h"
 
 void setup() {
-    // Initialize all system components
+    // Initialize all system components, including the module setup for currentMode
     initializeSystem();
     
-    // Setup based on current mode
-    switch (currentMode) {
-        case MODE_BASIC_TEST:
-            setupBasicTest();
-            break;
-        case MODE_WALKIE_FEATURES:
-            setupWalkieFeatures();
-            break;
-        case MODE_LOW_LEVEL:
-            setupLowLevel();
-            break;
-    }
-    
     // Show available commands
     showCommands();
+    
+#if WT_USE_TASKS
+    // From here each subsystem runs in its own pinned task
+    startTasks();
+#else
+    startTaskTimers();
+#endif
 }
 
 void loop() {
-    // Always handle DMR events
-    dmr.update();
-    
-    // Handle GPS data
-    readGPS();
-    
-    // Handle continuous GPS transmission
-    handleContinuousGPS();
-    
-    // Check for incoming GSM SMS
-    checkIncomingGSMSMS();
-    
-    // Check for incoming LoRa messages
-    checkLoRaMessages();
-    
-    // Handle Bluetooth commands
-    handleBluetoothCommands();
+#if WT_USE_TASKS
+    // Nothing left for the Arduino loop task
+    vTaskDelete(NULL);
+#else
+    uint32_t passStart = micros();
     
-    // Handle keyboard input
-    scanKeyboard();
+    // DMR events, background RSSI/status polls, channel scan steps, hop retunes
+    updateRadio();
     
-    // Update display
-    updateDisplay();
+    // GPS, GSM, LoRa, Bluetooth, keypad, display and stored config, each when its timer is due
+    uint32_t waitMs = runTaskTimers();
+    checkPassBudget(passStart);
     
     // // Run mode-specific loop
     // switch (currentMode) {
@@ -66,6 +51,8 @@ void loop() {
     //         break;
     // }
     
-    // Small delay to prevent overwhelming the system
-    delay(10);
+    // Sleep until the next deadline, or until a frame arrives (event-driven receive)
+    uint32_t radioMs = radioWaitMs();
+    dmr.getLowLevel().waitForRx(waitMs < radioMs ? waitMs : radioMs);
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "BootManager.h"
+
+BootState bootState;
+
+void bootPhase(BootStage &stage, uint8_t phase) {
+    stage.phase = phase;
+    stage.phaseAt = millis();
+}
+
+void markTransmitReady() {
+    bootState.transmitReadyMs = millis();
+}
+
+static void finishStage(BootStage &stage, BootStatus status, const char *detail = nullptr) {
+    stage.status = status;
+    stage.endMs = millis();
+    if (detail) {
+        stage.detail = detail;
+    }
+}
+
+void runBoot(BootStage *stages, uint8_t count, unsigned long deadlineMs) {
+    bootState.stages = stages;
+    bootState.count = count;
+    bootState.startMs = millis();
+    bootState.transmitReadyMs = 0;
+    
+    bool busy = true;
+    while (busy) {
+        busy = false;
+        
+        for (uint8_t i = 0; i < count; i++) {
+            BootStage &stage = stages[i];
+            
+            if (stage.status == BOOT_PENDING) {
+                bool waiting = false;
+                bool broken = false;
+                for (uint8_t j = 0; j < count; j++) {
+                    if (!(stage.after & BOOT_STAGE(j))) continue;
+                    if (stages[j].status == BOOT_PENDING || stages[j].status == BOOT_RUNNING) {
+                        waiting = true;
+                    } else if (stages[j].status != BOOT_READY) {
+                        broken = true;
+                    }
+                }
+                if (broken) {
+                    stage.startMs = millis();
+                    finishStage(stage, BOOT_SKIPPED, "dependency failed");
+                    continue;
+                }
+                if (waiting) {
+                    busy = true;
+                    continue;
+                }
+                stage.status = BOOT_RUNNING;
+                stage.startMs = millis();
+                bootPhase(stage, 0);
+            }
+            
+            if (stage.status == BOOT_RUNNING) {
+                BootStatus result = stage.step(stage);
+                if (result == BOOT_RUNNING && stage.timeoutMs && millis() - stage.startMs > stage.timeoutMs) {
+                    finishStage(stage, BOOT_FAILED, "timeout");
+                } else if (result != BOOT_RUNNING) {
+                    finishStage(stage, result);
+                } else {
+                    busy = true;
+                }
+            }
+        }
+        
+        if (busy && millis() - bootState.startMs > deadlineMs) {
+            for (uint8_t i = 0; i < count; i++) {
+                if (stages[i].status == BOOT_PENDING || stages[i].status == BOOT_RUNNING) {
+                    if (stages[i].status == BOOT_PENDING) stages[i].startMs = millis();
+                    finishStage(stages[i], BOOT_FAILED, "boot deadline");
+                }
+            }
+            break;
+        }
+        
+        // One tick for the Bluetooth stack and the idle task between passes
+        if (busy) delay(1);
+    }
+    
+    bootState.endMs = millis();
+}
+
+bool runBootStep(BootStep step, uint32_t timeoutMs) {
+    BootStage stage("", step, 0, timeoutMs);
+    stage.status = BOOT_RUNNING;
+    stage.startMs = millis();
+    bootPhase(stage, 0);
+    
+    BootStatus result;
+    while ((result = step(stage)) == BOOT_RUNNING) {
+        if (timeoutMs && millis() - stage.startMs > timeoutMs) {
+            return false;
+        }
+        delay(1);
+    }
+    return result == BOOT_READY;
+}
+
+const char* bootStatusName(BootStatus status) {
+    switch (status) {
+        case BOOT_PENDING: return "pending";
+        case BOOT_RUNNING: return "running";
+        case BOOT_READY: return "ready";
+        case BOOT_FAILED: return "FAILED";
+        case BOOT_SKIPPED: return "skipped";
+        default: return "?";
+    }
+}
+
+void showBootTimeTo(Stream* stream) {
+    if (bootState.count == 0) {
+        stream->println("⏱️ No boot timeline recorded");
+        return;
+    }
+    unsigned long t0 = bootState.startMs;
+    
+    stream->print("\n⏱️ Boot Timeline (staged boot began ");
+    stream->print(t0); stream->println(" ms after reset):");
+    stream->println("Stage         Start  Ready   Took  Result");
+    for (uint8_t i = 0; i < bootState.count; i++) {
+        const BootStage &s = bootState.stages[i];
+        char line[80];
+        snprintf(line, sizeof(line), "%-12s %6lu %6lu %6lu  %s%s%s", s.name,
+                 s.startMs - t0, s.endMs - t0, s.endMs - s.startMs, bootStatusName(s.status),
+                 s.detail[0] ? ", " : "", s.detail);
+        stream->println(line);
+    }
+    
+    stream->print("Ready to transmit: ");
+    if (bootState.transmitReadyMs) {
+        stream->print(bootState.transmitReadyMs - t0); stream->println(" ms");
+    } else {
+        stream->println("never (DMR not configured)");
+    }
+    stream->print("All stages done: ");
+    stream->print(bootState.endMs - t0); stream->println(" ms");
+}
\ No newline at end of file
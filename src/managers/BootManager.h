@@ -0,0 +1,63 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Staged boot: each stage is a step function polled until it reports ready or
+// failed. Stages whose dependencies are ready run interleaved, so one waiting
+// on a modem does not hold up another, and steps poll for readiness instead
+// of sleeping.
+
+#define BOOT_MAX_STAGES 12
+#define BOOT_STAGE(index) (1U << (index))
+
+enum BootStatus : uint8_t {
+    BOOT_PENDING = 0,       // Waiting for dependencies
+    BOOT_RUNNING,
+    BOOT_READY,
+    BOOT_FAILED,
+    BOOT_SKIPPED            // A dependency failed
+};
+
+struct BootStage;
+typedef BootStatus (*BootStep)(BootStage &stage);
+
+struct BootStage {
+    const char *name;
+    BootStep step;
+    uint16_t after;                 // BOOT_STAGE() bits that must be ready first
+    uint32_t timeoutMs;             // 0 = no limit
+    
+    // Progress, owned by the step
+    uint8_t phase = 0;
+    unsigned long phaseAt = 0;      // millis() when phase was entered
+    unsigned long pollAt = 0;       // For the step's own retry pacing
+    uint8_t tries = 0;
+    const char *detail = "";        // Shown by boottime
+    
+    // Filled in by the runner
+    BootStatus status = BOOT_PENDING;
+    unsigned long startMs = 0;
+    unsigned long endMs = 0;
+    
+    BootStage(const char *name, BootStep step, uint16_t after = 0, uint32_t timeoutMs = 0)
+        : name(name), step(step), after(after), timeoutMs(timeoutMs) {}
+};
+
+// Boot state
+struct BootState {
+    BootStage *stages = nullptr;
+    uint8_t count = 0;
+    unsigned long startMs = 0;      // millis() when the staged boot began
+    unsigned long endMs = 0;
+    unsigned long transmitReadyMs = 0;  // DMR module configured; 0 if it never was
+};
+
+extern BootState bootState;
+
+// Boot functions
+void runBoot(BootStage *stages, uint8_t count, unsigned long deadlineMs);
+bool runBootStep(BootStep step, uint32_t timeoutMs);    // One step on its own, blocking
+void bootPhase(BootStage &stage, uint8_t phase);
+void markTransmitReady();
+const char* bootStatusName(BootStatus status);
+void showBootTimeTo(Stream* stream);
\ No newline at end of file
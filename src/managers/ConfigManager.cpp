@@ -0,0 +1,127 @@
+#include "ConfigManager.h"
+#include "WalkieTalkie.h"
+#include <Preferences.h>
+
+WalkieTalkieConfig wtConfig;
+ConfigState configState;
+
+// Runtime state lives in wtState; the record mirrors it plus boot-only settings
+static void configToState() {
+    wtState.myRadioID = wtConfig.radioID;
+    wtState.currentChannel = wtConfig.channel;
+    wtState.volume = wtConfig.volume;
+    wtState.soldierID = String(wtConfig.soldierID);
+}
+
+static void stateToConfig() {
+    wtConfig.radioID = wtState.myRadioID;
+    wtConfig.channel = wtState.currentChannel;
+    wtConfig.volume = wtState.volume;
+    snprintf(wtConfig.soldierID, sizeof(wtConfig.soldierID), "%s", wtState.soldierID.c_str());
+}
+
+bool loadConfig() {
+    WalkieTalkieConfig stored;
+    Preferences prefs;
+    size_t length = 0;
+    
+    if (prefs.begin(CONFIG_NAMESPACE, true)) {
+        length = prefs.getBytesLength(CONFIG_KEY);
+        if (length > sizeof(stored)) {
+            length = 0;                 // Newer firmware wrote it; do not guess at the layout
+        }
+        if (length > 0) {
+            length = prefs.getBytes(CONFIG_KEY, &stored, length);
+        }
+        prefs.end();
+    }
+    
+    // Header must be intact and describe exactly what was read
+    size_t header = offsetof(WalkieTalkieConfig, radioID);
+    if (length < header || stored.magic != CONFIG_MAGIC || stored.size != length ||
+        stored.version == 0 || stored.version > CONFIG_VERSION) {
+        wtConfig = WalkieTalkieConfig();
+        configState.loaded = false;
+        configToState();
+        return false;
+    }
+    
+    // Fields past the stored size keep the defaults WalkieTalkieConfig() gave them
+    stored.soldierID[sizeof(stored.soldierID) - 1] = '\0';
+    configState.loadedVersion = stored.version;
+    stored.version = CONFIG_VERSION;
+    wtConfig = stored;
+    configState.loaded = true;
+    configToState();
+    return true;
+}
+
+bool saveConfig() {
+    stateToConfig();
+    wtConfig.magic = CONFIG_MAGIC;
+    wtConfig.version = CONFIG_VERSION;
+    wtConfig.size = sizeof(wtConfig);
+    
+    Preferences prefs;
+    if (!prefs.begin(CONFIG_NAMESPACE, false)) {
+        return false;
+    }
+    bool ok = prefs.putBytes(CONFIG_KEY, &wtConfig, sizeof(wtConfig)) == sizeof(wtConfig);
+    prefs.end();
+    
+    if (ok) {
+        configState.dirty = false;
+        configState.saves++;
+    }
+    return ok;
+}
+
+void markConfigDirty() {
+    configState.dirty = true;
+    configState.changedAt = millis();
+}
+
+void updateConfigStore() {
+    if (configState.dirty && millis() - configState.changedAt >= CONFIG_SAVE_DELAY_MS) {
+        if (!saveConfig()) {
+            // Try again after another delay rather than every loop
+            configState.changedAt = millis();
+        }
+    }
+}
+
+bool resetConfig() {
+    Preferences prefs;
+    bool ok = prefs.begin(CONFIG_NAMESPACE, false);
+    if (ok) {
+        prefs.remove(CONFIG_KEY);
+        prefs.end();
+    }
+    // The running settings stay as they are until the next boot
+    wtConfig = WalkieTalkieConfig();
+    configState.loaded = false;
+    configState.dirty = false;
+    return ok;
+}
+
+void showConfigTo(Stream* stream) {
+    stream->println("\n💾 Stored Configuration:");
+    stream->print("Source: ");
+    if (configState.loaded) {
+        stream->print("NVS, version "); stream->println(configState.loadedVersion);
+    } else {
+        stream->println("defaults (nothing stored)");
+    }
+    stream->print("Radio ID: 0x"); stream->println(wtConfig.radioID, HEX);
+    stream->print("Channel: "); stream->println(wtConfig.channel);
+    stream->print("Volume: "); stream->println(wtConfig.volume);
+    stream->print("Color code: "); stream->print(wtConfig.colorCode);
+    stream->print(", Time slot: "); stream->print(wtConfig.timeSlot);
+    stream->print(", TX power: "); stream->println(wtConfig.txPower);
+    stream->print("Mic gain: "); stream->print(wtConfig.micGain);
+    stream->print(", SQL: "); stream->println(wtConfig.sqlLevel);
+    stream->print("Soldier ID: "); stream->println(wtConfig.soldierID);
+    if (configState.dirty) {
+        stream->println("(unsaved changes pending)");
+    }
+}
\ No newline at end of file
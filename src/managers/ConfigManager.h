@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Arduino.h>
+
+// NVS location of the persisted settings
+#define CONFIG_NAMESPACE "walkie"
+#define CONFIG_KEY "config"
+
+#define CONFIG_MAGIC 0x46435457UL       // "WTCF"
+#define CONFIG_VERSION 1
+
+// Runtime changes are written once they have been quiet this long
+// (keypad channel stepping would otherwise wear the flash)
+#define CONFIG_SAVE_DELAY_MS 5000
+
+// Persisted configuration record. The layout is append-only: add new fields
+// at the end and bump CONFIG_VERSION. A shorter record from older firmware
+// loads with defaults for the fields it does not have.
+struct WalkieTalkieConfig {
+    uint32_t magic = CONFIG_MAGIC;
+    uint16_t version = CONFIG_VERSION;
+    uint16_t size = 0;                  // Bytes stored, set on save
+    
+    uint32_t radioID = 0x000001;
+    uint8_t channel = 1;
+    uint8_t volume = 5;
+    uint8_t colorCode = 1;
+    uint8_t timeSlot = 1;
+    uint8_t txPower = 3;
+    uint8_t micGain = 8;
+    uint8_t sqlLevel = 5;
+    uint8_t reserved = 0;
+    char soldierID[16] = "BSF12345";
+};
+
+// Config state
+struct ConfigState {
+    bool loaded = false;                // Record came from NVS (false: defaults)
+    uint16_t loadedVersion = 0;
+    bool dirty = false;
+    unsigned long changedAt = 0;
+    uint32_t saves = 0;
+};
+
+extern WalkieTalkieConfig wtConfig;
+extern ConfigState configState;
+
+// Config functions
+bool loadConfig();                      // NVS -> wtConfig -> wtState; false if defaults were used
+bool saveConfig();                      // wtState -> wtConfig -> NVS, now
+void markConfigDirty();                 // Save after CONFIG_SAVE_DELAY_MS of no further changes
+void updateConfigStore();               // Call from loop()
+bool resetConfig();                     // Erase the record; defaults from the next boot
+void showConfigTo(Stream* stream);
\ No newline at end of file
@@ -2,13 +2,41 @@
 #include "GPSManager.h"
 #include "GSMManager.h"
 #include "WalkieTalkie.h"
+#include "MemoryManager.h"
+#include "TaskManager.h"
 
 DisplayState displayState;
 U8G2_SSD1306_128X64_NONAME_F_HW_I2C u8g2(U8G2_R2, /* reset=*/ U8X8_PIN_NONE);
 
+// Message log entry in flight from another task
+struct DisplayMessage {
+    char text[DISPLAY_MESSAGE_LEN];
+};
+
+// Radio callbacks, commands on any task and the UI itself all log here
+static DMRMPSCQueue<DisplayMessage, DISPLAY_QUEUE_DEPTH> messageQueue;
+
+// Latest radio and GPS state as published by their tasks; the screens read only these
+static LinkSnapshot shownLink;
+static GPSFixSnapshot shownFix;
+
+static void storeMessage(const String &message) {
+    displayState.messages[displayState.messageIndex] = message;
+    displayState.messageIndex = (displayState.messageIndex + 1) % 6;
+}
+
 void initializeDisplay() {
+    runBootStep(pollDisplayInit, 0);
+}
+
+// Boot step: the startup screen stays up while the other stages finish;
+// updateDisplay() replaces it with the menu once the loop runs
+BootStatus pollDisplayInit(BootStage &stage) {
     // Initialize U8g2
-    u8g2.begin();
+    if (!u8g2.begin()) {
+        stage.detail = "no display";
+        return BOOT_FAILED;
+    }
     u8g2.enableUTF8Print();
     
     displayState.initialized = true;
@@ -24,33 +52,36 @@ void initializeDisplay() {
     u8g2.drawStr(0, 60, "Use keypad to navigate");
     u8g2.sendBuffer();
     
-    delay(2000);
-    
     // Initialize menu system
     initializeMenus();
-    showMenu();
+    return BOOT_READY;
 }
 
 void updateDisplay() {
+    DisplayMessage item;
+    while (messageQueue.pop(item)) {
+        storeMessage(String(item.text));
+    }
+    receiveLinkSnapshot(shownLink);
+    shownFix = currentGPSFix();
+    
     if (!displayState.initialized) return;
     
-    // Update display every 500ms or when needed
-    if (millis() - displayState.lastUpdate > 500) {
-        displayState.lastUpdate = millis();
-        
-        if (displayState.inputMode) {
-            showInputScreen();
-        } else if (displayState.inMenu) {
-            showMenu();
-        } else if (displayState.currentScreen == "main") {
-            showMainScreen();
-        } else if (displayState.currentScreen == "status") {
-            showStatusScreen();
-        } else if (displayState.currentScreen == "gps") {
-            showGPSScreen();
-        } else if (displayState.currentScreen == "gsm") {
-            showGSMScreen();
-        }
+    // Called every DISPLAY_REFRESH_MS by the UI task's timer
+    if (displayState.inputMode) {
+        showInputScreen();
+    } else if (displayState.inMenu) {
+        showMenu();
+    } else if (displayState.currentScreen == "main") {
+        showMainScreen();
+    } else if (displayState.currentScreen == "status") {
+        showStatusScreen();
+    } else if (displayState.currentScreen == "gps") {
+        showGPSScreen();
+    } else if (displayState.currentScreen == "gsm") {
+        showGSMScreen();
+    } else if (displayState.currentScreen == "link") {
+        showLinkScreen();
     }
 }
 
@@ -64,11 +95,15 @@ void showMainScreen() {
     
     // Status indicators
     char statusLine[32];
-    snprintf(statusLine, sizeof(statusLine), "CH:%d VOL:%d", wtState.currentChannel, wtState.volume);
+    if (shownLink.recent) {
+        snprintf(statusLine, sizeof(statusLine), "CH:%d VOL:%d RSSI:%d", shownLink.channel, shownLink.volume, shownLink.sample.rssi);
+    } else {
+        snprintf(statusLine, sizeof(statusLine), "CH:%d VOL:%d", shownLink.channel, shownLink.volume);
+    }
     u8g2.drawStr(0, 25, statusLine);
     
     // GPS Status
-    if (gpsState.hasValidFix) {
+    if (shownFix.valid) {
         u8g2.drawStr(0, 35, "GPS: LOCK");
     } else {
         u8g2.drawStr(0, 35, "GPS: SEARCH");
@@ -98,13 +133,13 @@ void showStatusScreen() {
     u8g2.drawHLine(0, 12, 128);
     
     char line[32];
-    snprintf(line, sizeof(line), "Radio ID: 0x%X", (unsigned int)wtState.myRadioID);
+    snprintf(line, sizeof(line), "Radio ID: 0x%X", (unsigned int)shownLink.radioID);
     u8g2.drawStr(0, 25, line);
     
-    snprintf(line, sizeof(line), "Channel: %d", wtState.currentChannel);
+    snprintf(line, sizeof(line), "Channel: %d", shownLink.channel);
     u8g2.drawStr(0, 35, line);
     
-    snprintf(line, sizeof(line), "GPS Fix: %s", gpsState.hasValidFix ? "YES" : "NO");
+    snprintf(line, sizeof(line), "GPS Fix: %s", shownFix.valid ? "YES" : "NO");
     u8g2.drawStr(0, 45, line);
     
     snprintf(line, sizeof(line), "GSM Reg: %s", gsmState.networkRegistered ? "YES" : "NO");
@@ -116,6 +151,34 @@ void showStatusScreen() {
     u8g2.sendBuffer();
 }
 
+void showLinkScreen() {
+    u8g2.clearBuffer();
+    u8g2.setFont(u8g2_font_6x10_tf);
+    
+    u8g2.drawStr(0, 10, "DMR Link");
+    u8g2.drawHLine(0, 12, 128);
+    
+    char line[32];
+    const DMRLinkStats &stats = shownLink.stats;
+    if (shownLink.hasStats) {
+        snprintf(line, sizeof(line), "RSSI %d (%d-%d)", stats.last, stats.min, stats.max);
+        u8g2.drawStr(0, 25, line);
+        snprintf(line, sizeof(line), "Avg %.1f Med %d", stats.mean, stats.p50);
+        u8g2.drawStr(0, 35, line);
+        snprintf(line, sizeof(line), "Trend %+.1f/min", stats.trendPerMin);
+        u8g2.drawStr(0, 45, line);
+        snprintf(line, sizeof(line), "%us, %u miss", (unsigned)(stats.spanMs / 1000), stats.missed);
+        u8g2.drawStr(0, 55, line);
+    } else {
+        u8g2.drawStr(0, 25, shownLink.sampling ? "Sampling..." : "Sampling off");
+    }
+    
+    u8g2.setFont(u8g2_font_5x7_tf);
+    u8g2.drawStr(0, 64, "#=Back");
+    
+    u8g2.sendBuffer();
+}
+
 void showGPSScreen() {
     u8g2.clearBuffer();
     u8g2.setFont(u8g2_font_6x10_tf);
@@ -123,15 +186,15 @@ void showGPSScreen() {
     u8g2.drawStr(0, 10, "GPS Information");
     u8g2.drawHLine(0, 12, 128);
     
-    if (gpsState.hasValidFix) {
+    if (shownFix.valid) {
         u8g2.drawStr(0, 25, "Status: LOCKED");
         
         char latLine[32];
-        snprintf(latLine, sizeof(latLine), "Lat: %.6f", gpsState.latitude);
+        snprintf(latLine, sizeof(latLine), "Lat: %.6f", shownFix.latitude);
         u8g2.drawStr(0, 35, latLine);
         
         char lonLine[32]; 
-        snprintf(lonLine, sizeof(lonLine), "Lon: %.6f", gpsState.longitude);
+        snprintf(lonLine, sizeof(lonLine), "Lon: %.6f", shownFix.longitude);
         u8g2.drawStr(0, 45, lonLine);
     } else {
         u8g2.drawStr(0, 25, "Status: SEARCHING");
@@ -159,8 +222,9 @@ void showGSMScreen() {
     snprintf(line, sizeof(line), "Signal: %d/31", gsmState.signalStrength);
     u8g2.drawStr(0, 35, line);
     
-    if (gsmState.phoneNumber.length() > 0) {
-        snprintf(line, sizeof(line), "Phone: %s", gsmState.phoneNumber.c_str());
+    String phone = currentPhoneNumber();
+    if (phone.length() > 0) {
+        snprintf(line, sizeof(line), "Phone: %s", phone.c_str());
         u8g2.drawStr(0, 45, line);
     } else {
         u8g2.drawStr(0, 45, "Phone: Not set");
@@ -173,8 +237,37 @@ void showGSMScreen() {
 }
 
 void addMessage(String message) {
-    displayState.messages[displayState.messageIndex] = message;
-    displayState.messageIndex = (displayState.messageIndex + 1) % 6;
+    // Any task may log; the UI task moves the lines into the ring in updateDisplay()
+    DisplayMessage item;
+    snprintf(item.text, sizeof(item.text), "%s", message.c_str());
+    messageQueue.push(item);            // Full: the UI is behind and the line is dropped
+}
+
+// Message log fed from DMR events, alongside the Bluetooth output
+static void onDisplayEvent(const DMREvent &event, void *context) {
+    switch (event.type) {
+        case DMR_EVENT_SMS_RECEIVED:
+            addMessage("SMS 0x" + String(event.sourceID, HEX) + ": " + String(event.sms->message));
+            break;
+        case DMR_EVENT_CALL_IN_START:
+            addMessage("Call from 0x" + String(event.sourceID, HEX));
+            break;
+        case DMR_EVENT_CALL_OUT_START:
+            addMessage("Call to 0x" + String(event.targetID, HEX));
+            break;
+        case DMR_EVENT_EMERGENCY:
+            addMessage("ALARM 0x" + String(event.sourceID, HEX));
+            break;
+        default:
+            break;
+    }
+}
+
+void subscribeDisplayEvents() {
+    dmr.subscribeEvent(DMR_EVENT_SMS_RECEIVED, onDisplayEvent);
+    dmr.subscribeEvent(DMR_EVENT_CALL_IN_START, onDisplayEvent);
+    dmr.subscribeEvent(DMR_EVENT_CALL_OUT_START, onDisplayEvent);
+    dmr.subscribeEvent(DMR_EVENT_EMERGENCY, onDisplayEvent);
 }
 
 void showMessage(String message, int duration) {
@@ -280,6 +373,7 @@ void initializeMenus() {
 }
 
 void createMainMenu() {
+    DMR_MEM_SCOPE(MEM_MENU);
     displayState.currentMenu.title = "Main Menu";
     displayState.currentMenu.selectedItem = 0;
     displayState.currentMenu.itemCount = 8;
@@ -389,13 +483,14 @@ void createDebugMenu() {
 void createCommStatusMenu() {
     displayState.currentMenu.title = "Comm Status";
     displayState.currentMenu.selectedItem = 0;
-    displayState.currentMenu.itemCount = 5;
+    displayState.currentMenu.itemCount = 6;
     
     displayState.currentMenu.items[0] = {"DMR Status", "status", false};
-    displayState.currentMenu.items[1] = {"LoRa Status", "lorastatus", false};
-    displayState.currentMenu.items[2] = {"GSM Status", "gsmstatus", false};
-    displayState.currentMenu.items[3] = {"Fallback Test", "fallback", false};
-    displayState.currentMenu.items[4] = {"Back", "back", false};
+    displayState.currentMenu.items[1] = {"DMR Link", "link_screen", false};
+    displayState.currentMenu.items[2] = {"LoRa Status", "lorastatus", false};
+    displayState.currentMenu.items[3] = {"GSM Status", "gsmstatus", false};
+    displayState.currentMenu.items[4] = {"Fallback Test", "fallback", false};
+    displayState.currentMenu.items[5] = {"Back", "back", false};
 }
 
 void createSettingsMenu() {
@@ -410,6 +505,7 @@ void createSettingsMenu() {
 }
 
 void showMenu() {
+    DMR_MEM_SCOPE(MEM_MENU);
     u8g2.clearBuffer();
     u8g2.setFont(u8g2_font_6x10_tf);
     
@@ -464,6 +560,8 @@ void navigateDown() {
 }
 
 void selectMenuItem() {
+    // Menus are copied whole onto the stack, every String in them
+    DMR_MEM_SCOPE(MEM_MENU);
     MenuItem selectedItem = displayState.currentMenu.items[displayState.currentMenu.selectedItem];
     
     if (selectedItem.isSubmenu) {
@@ -501,6 +599,7 @@ void selectMenuItem() {
 }
 
 void goBack() {
+    DMR_MEM_SCOPE(MEM_MENU);
     if (displayState.menuStackDepth > 0) {
         // Pop menu from stack
         displayState.menuStackDepth--;
@@ -646,6 +745,9 @@ void executeMenuAction(String action) {
         displayCapturedOutput();
         displayState.inMenu = false;
         delay(500);
+    } else if (action == "link_screen") {
+        displayState.currentScreen = "link";
+        displayState.inMenu = false;
     } else if (action == "gps_position") {
         captureCommandOutput("gpsinfo");
         displayCapturedOutput();
@@ -799,6 +901,7 @@ public:
     
     // Print methods to capture output
     size_t write(uint8_t c) override {
+        DMR_MEM_SCOPE(MEM_CAPTURE);
         if (c == '\r') return 1; // Skip carriage returns
         capturedText += (char)c;
         return 1;
@@ -3,12 +3,19 @@
 #include <Arduino.h>
 #include <Wire.h>
 #include <U8g2lib.h>
+#include "BootManager.h"
+#include "DMR828S_queue.h"
 
 // OLED Display Configuration
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
 #define SCREEN_ADDRESS 0x3C
 
+// Message log lines queued from other tasks (a line is ~25 characters wide).
+// Depth is a power of two (DMRMPSCQueue).
+#define DISPLAY_MESSAGE_LEN 48
+#define DISPLAY_QUEUE_DEPTH 8
+
 // Menu structures
 struct MenuItem {
     String title;
@@ -28,7 +35,6 @@ struct DisplayState {
     bool initialized = false;
     String currentScreen = "menu";
     int currentLine = 0;
-    unsigned long lastUpdate = 0;
     String statusLine = "";
     String messages[6]; // 6 lines for messages
     int messageIndex = 0;
@@ -61,12 +67,15 @@ extern U8G2_SSD1306_128X64_NONAME_F_HW_I2C u8g2;
 
 // Display functions
 void initializeDisplay();
+BootStatus pollDisplayInit(BootStage &stage);
 void updateDisplay();
 void showMainScreen();
 void showStatusScreen();
 void showGPSScreen();
 void showGSMScreen();
+void showLinkScreen();
 void addMessage(String message);
+void subscribeDisplayEvents();
 void showMessage(String message, int duration = 2000);
 void displayError(String error);
 void displaySuccess(String success);
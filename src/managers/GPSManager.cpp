@@ -1,11 +1,33 @@
 #include "GPSManager.h"
+#include "TaskManager.h"
+#include "MemoryManager.h"
+#include "WalkieTalkie.h"
 
 GPSState gpsState;
 
+static DMRTimerId continuousTimer = DMR_INVALID_TIMER;
+
+// Days since 1970-01-01 for a proleptic Gregorian date
+static int32_t daysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    int32_t era = (year >= 0 ? year : year - 399) / 400;
+    int32_t yearOfEra = year - era * 400;
+    int32_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int32_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
 void initializeGPS() {
+    runBootStep(pollGPSInit, 0);
+}
+
+// Boot step: the port is all there is to open; the fix arrives whenever the
+// receiver has one and readGPS() picks it up, so nothing waits for it here
+BootStatus pollGPSInit(BootStage &stage) {
     // GPS module on Serial0 (9600 baud is standard for most GPS modules)
     Serial.begin(9600); // GPS module baud rate
-    delay(1000);
+    stage.detail = "fix pending";
+    return BOOT_READY;
 }
 
 void readGPS() {
@@ -31,6 +53,8 @@ void readGPS() {
 }
 
 void parseNMEA(String sentence) {
+    DMR_MEM_SCOPE(MEM_NMEA);
+    
     // Parse GPGGA or GNGGA sentences for position data
     if (sentence.startsWith("$GPGGA") || sentence.startsWith("$GNGGA")) {
         // Split sentence by commas
@@ -117,22 +141,36 @@ void parseNMEA(String sentence) {
                 gpsState.gpsMonth = dateStr.substring(2, 4).toInt();
                 int year = dateStr.substring(4, 6).toInt();
                 gpsState.gpsYear = (year < 80) ? 2000 + year : 1900 + year; // Y2K handling
+                
+                // Time (field 1) - HHMMSS.sss, from the same sentence as the date
+                if (fields[1].length() >= 6) {
+                    String timeStr = fields[1];
+                    uint32_t secondsOfDay = timeStr.substring(0, 2).toInt() * 3600UL +
+                                            timeStr.substring(2, 4).toInt() * 60UL +
+                                            timeStr.substring(4, 6).toInt();
+                    uint32_t fraction = timeStr.length() > 7 ? (uint32_t)(timeStr.substring(6).toFloat() * 1000) : 0;
+                    int32_t days = daysFromCivil(gpsState.gpsYear, gpsState.gpsMonth, gpsState.gpsDay);
+                    gpsState.utcMillis = ((uint64_t)days * 86400UL + secondsOfDay) * 1000ULL + fraction;
+                    gpsState.utcAtMillis = millis();
+                    gpsState.hasUtc = true;
+                }
             }
         }
     }
 }
 
 void sendGPSLocation(Stream* stream, uint32_t targetID) {
+    GPSFixSnapshot fix = currentGPSFix();
     double lat, lon;
     String status;
     
-    if (gpsState.hasValidFix) {
-        lat = gpsState.latitude;
-        lon = gpsState.longitude;
+    if (fix.valid) {
+        lat = fix.latitude;
+        lon = fix.longitude;
         status = "CURRENT";
-    } else if (gpsState.hasLastLocation) {
-        lat = gpsState.lastLatitude;
-        lon = gpsState.lastLongitude;
+    } else if (fix.hasLast) {
+        lat = fix.lastLatitude;
+        lon = fix.lastLongitude;
         status = "LAST GPS";
     } else {
         lat = 29.938971327453903;
@@ -156,43 +194,49 @@ void sendGPSLocation(Stream* stream, uint32_t targetID) {
     stream->println(lon, 6);
 }
 
-void handleContinuousGPS() {
-    if (!gpsState.continuousMode) return;
-    
-    unsigned long currentTime = millis();
-    unsigned long totalSeconds = (gpsState.intervalMinutes * 60) + gpsState.intervalSeconds;
-    unsigned long intervalMs = totalSeconds * 1000; // Convert to milliseconds
+static void sendContinuousGPS(void *context) {
+    // The DMR module belongs to the radio task; "gps <id>" sends the report there
+    postCommand(TASK_RADIO, &SerialBT, "gps " + String(gpsState.targetID, HEX));
+}
+
+void startContinuousGPS(uint32_t targetID, unsigned long minutes, unsigned long seconds) {
+    stopContinuousGPS();
+    gpsState.continuousMode = true;
+    gpsState.targetID = targetID;
+    gpsState.intervalMinutes = minutes;
+    gpsState.intervalSeconds = seconds;
     
-    // Check if it's time to send GPS
-    if (gpsState.lastTransmission == 0 || 
-        (currentTime - gpsState.lastTransmission) >= intervalMs) {
-        
-        gpsState.lastTransmission = currentTime;
-        
-        // Send GPS location notification - actual sending handled by main
-        // This function just manages timing
-    }
+    unsigned long intervalMs = ((minutes * 60) + seconds) * 1000;
+    sendContinuousGPS(nullptr);
+    continuousTimer = taskTimers(TASK_GPS).startPeriodic(intervalMs, sendContinuousGPS, nullptr, "gpsauto");
+}
+
+void stopContinuousGPS() {
+    taskTimers(TASK_GPS).cancel(continuousTimer);
+    continuousTimer = DMR_INVALID_TIMER;
+    gpsState.continuousMode = false;
 }
 
 String getGPSTimestamp() {
-    if (gpsState.hasValidTime) {
+    GPSFixSnapshot fix = currentGPSFix();
+    if (fix.hasTime) {
         // Format: YYYY-MM-DDTHH:MM:SSZ
-        String timestamp = String(gpsState.gpsYear) + "-";
+        String timestamp = String(fix.year) + "-";
         
-        if (gpsState.gpsMonth < 10) timestamp += "0";
-        timestamp += String(gpsState.gpsMonth) + "-";
+        if (fix.month < 10) timestamp += "0";
+        timestamp += String(fix.month) + "-";
         
-        if (gpsState.gpsDay < 10) timestamp += "0";
-        timestamp += String(gpsState.gpsDay) + "T";
+        if (fix.day < 10) timestamp += "0";
+        timestamp += String(fix.day) + "T";
         
-        if (gpsState.gpsHour < 10) timestamp += "0";
-        timestamp += String(gpsState.gpsHour) + ":";
+        if (fix.hour < 10) timestamp += "0";
+        timestamp += String(fix.hour) + ":";
         
-        if (gpsState.gpsMinute < 10) timestamp += "0";
-        timestamp += String(gpsState.gpsMinute) + ":";
+        if (fix.minute < 10) timestamp += "0";
+        timestamp += String(fix.minute) + ":";
         
-        if (gpsState.gpsSecond < 10) timestamp += "0";
-        timestamp += String(gpsState.gpsSecond) + "Z";
+        if (fix.second < 10) timestamp += "0";
+        timestamp += String(fix.second) + "Z";
         
         return timestamp;
     } else {
@@ -213,4 +257,47 @@ String getGPSTimestamp() {
         
         return timestamp;
     }
-}
\ No newline at end of file
+}
+// Timestamp for a report stamped with the sender's time of day (the date is ours)
+String getGPSTimestamp(uint32_t secondsOfDay) {
+    String timestamp = getGPSTimestamp().substring(0, 11);
+    int hours = secondsOfDay / 3600;
+    int minutes = (secondsOfDay / 60) % 60;
+    int seconds = secondsOfDay % 60;
+    
+    if (hours < 10) timestamp += "0";
+    timestamp += String(hours) + ":";
+    if (minutes < 10) timestamp += "0";
+    timestamp += String(minutes) + ":";
+    if (seconds < 10) timestamp += "0";
+    timestamp += String(seconds) + "Z";
+    
+    return timestamp;
+}
+
+// Best position we have: current fix, else last fix, else the default
+PositionReport getPositionReport(const String &soldierID) {
+    GPSFixSnapshot fix = currentGPSFix();
+    PositionReport report;
+    report.soldierID = soldierID;
+    
+    if (fix.valid) {
+        report.latitude = fix.latitude;
+        report.longitude = fix.longitude;
+        report.fix = POSITION_FIX_CURRENT;
+    } else if (fix.hasLast) {
+        report.latitude = fix.lastLatitude;
+        report.longitude = fix.lastLongitude;
+        report.fix = POSITION_FIX_LAST;
+    } else {
+        report.latitude = 29.938971327453903;
+        report.longitude = 77.56449807342506;
+        report.fix = POSITION_FIX_DEFAULT;
+    }
+    
+    if (fix.hasTime) {
+        report.hasTime = true;
+        report.secondsOfDay = fix.hour * 3600UL + fix.minute * 60UL + fix.second;
+    }
+    return report;
+}
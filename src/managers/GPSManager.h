@@ -1,6 +1,8 @@
 #pragma once
 
 #include <Arduino.h>
+#include "PositionCodec.h"
+#include "BootManager.h"
 
 // GPS state structure
 struct GPSState {
@@ -21,20 +23,30 @@ struct GPSState {
     int gpsMonth = 1;
     int gpsYear = 2025;
     
+    // UTC from the last valid RMC sentence, which carries date and time
+    // together (no skew at midnight); the clock for frequency hopping
+    bool hasUtc = false;
+    uint64_t utcMillis = 0;             // Since the Unix epoch
+    unsigned long utcAtMillis = 0;      // millis() when that sentence was parsed
+    
     // Continuous GPS transmission
     bool continuousMode = false;
     uint32_t targetID = 0;
     unsigned long intervalMinutes = 5;
     unsigned long intervalSeconds = 0;
-    unsigned long lastTransmission = 0;
 };
 
 extern GPSState gpsState;
 
 // GPS functions
 void initializeGPS();
+BootStatus pollGPSInit(BootStage &stage);
 void readGPS();
 void parseNMEA(String sentence);
 void sendGPSLocation(Stream* stream, uint32_t targetID);
-void handleContinuousGPS();
-String getGPSTimestamp();
\ No newline at end of file
+// On the GPS task: report at once, then every interval from its timer
+void startContinuousGPS(uint32_t targetID, unsigned long minutes, unsigned long seconds);
+void stopContinuousGPS();
+String getGPSTimestamp();
+String getGPSTimestamp(uint32_t secondsOfDay);
+PositionReport getPositionReport(const String &soldierID);
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "GSMManager.h"
+#include "PositionCodec.h"
 #include "BluetoothSerial.h"
 
 extern BluetoothSerial SerialBT;
@@ -6,31 +7,95 @@ extern BluetoothSerial SerialBT;
 GSMState gsmState;
 
 void initializeGSM() {
-    SerialBT.println("📱 Initializing GSM module...");
-    
-    // Reset GSM module
-    Serial1.println("ATZ");
-    delay(1000);
+    runBootStep(pollGSMInit, GSM_INIT_TIMEOUT_MS);
+}
+
+// Boot step: reset, probe with AT until the modem answers, text mode, network.
+// Every wait ends on the modem's "OK" rather than a fixed delay.
+BootStatus pollGSMInit(BootStage &stage) {
+    static String response = "";
+    while (Serial1.available() && response.length() < 128) {
+        response += (char)Serial1.read();
+    }
+    unsigned long inPhase = millis() - stage.phaseAt;
     
-    // Check if GSM module responds
-    Serial1.println("AT");
-    delay(500);
-    if (waitForGSMResponse("OK", 2000)) {
-        SerialBT.println("✅ GSM module detected");
+    switch (stage.phase) {
+        case 0:
+            SerialBT.println("📱 Initializing GSM module...");
+            response = "";
+            Serial1.println("ATZ");
+            stage.pollAt = millis();
+            bootPhase(stage, 1);
+            return BOOT_RUNNING;
+        
+        case 1:
+            // ATZ or one of the AT probes answered
+            if (response.indexOf("OK") != -1) {
+                SerialBT.println("✅ GSM module detected");
+                response = "";
+                Serial1.println("AT+CMGF=1");
+                bootPhase(stage, 2);
+            } else if (inPhase > GSM_PROBE_TIMEOUT_MS) {
+                SerialBT.println("❌ GSM module not responding");
+                gsmState.initialized = false;
+                stage.detail = "no answer";
+                return BOOT_FAILED;
+            } else if (millis() - stage.pollAt >= GSM_PROBE_INTERVAL_MS) {
+                response = "";
+                Serial1.println("AT");
+                stage.pollAt = millis();
+            }
+            return BOOT_RUNNING;
         
-        // Set text mode for SMS
-        Serial1.println("AT+CMGF=1");
-        waitForGSMResponse("OK", 1000);
+        case 2:
+            // Text mode for SMS
+            if (response.indexOf("OK") != -1 || inPhase > GSM_COMMAND_TIMEOUT_MS) {
+                response = "";
+                Serial1.println("AT+CREG?");
+                bootPhase(stage, 3);
+            }
+            return BOOT_RUNNING;
         
-        // Check network registration
-        checkGSMNetwork();
+        case 3:
+            // Network registration
+            if (response.indexOf("OK") == -1 && inPhase <= GSM_COMMAND_TIMEOUT_MS) {
+                return BOOT_RUNNING;
+            }
+            gsmState.initialized = true;
+            if (response.indexOf("+CREG: 0,1") != -1 || response.indexOf("+CREG: 0,5") != -1) {
+                gsmState.networkRegistered = true;
+                SerialBT.println("✅ GSM network registered");
+                response = "";
+                Serial1.println("AT+CSQ");
+                bootPhase(stage, 4);
+                return BOOT_RUNNING;
+            }
+            gsmState.networkRegistered = false;
+            SerialBT.println("❌ GSM network not registered");
+            SerialBT.println("✅ GSM module initialized");
+            stage.detail = "no network";
+            return BOOT_READY;
         
-        gsmState.initialized = true;
-        SerialBT.println("✅ GSM module initialized");
-    } else {
-        SerialBT.println("❌ GSM module not responding");
-        gsmState.initialized = false;
+        case 4:
+            // Signal strength
+            if (response.indexOf("OK") == -1 && inPhase <= GSM_COMMAND_TIMEOUT_MS) {
+                return BOOT_RUNNING;
+            }
+            {
+                int csqIndex = response.indexOf("+CSQ: ");
+                int commaIndex = csqIndex != -1 ? response.indexOf(",", csqIndex) : -1;
+                if (commaIndex != -1) {
+                    int rssi = response.substring(csqIndex + 6, commaIndex).toInt();
+                    if (rssi != 99) {
+                        gsmState.signalStrength = rssi;
+                    }
+                }
+            }
+            SerialBT.println("✅ GSM module initialized");
+            stage.detail = "registered";
+            return BOOT_READY;
     }
+    return BOOT_FAILED;
 }
 
 bool waitForGSMResponse(String expectedResponse, unsigned long timeout) {
@@ -209,7 +274,7 @@ void readGSMSMS(int index) {
             SerialBT.println("Message: " + message);
             
             // Check if this is a GPS message and parse it
-            if (message.startsWith("GPS ")) {
+            if (isPositionReport(message)) {
                 // Need to include WalkieTalkie.h functions
                 extern void parseIncomingGPS(String message, String commMode);
                 parseIncomingGPS(message, "GSM");
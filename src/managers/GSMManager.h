@@ -1,6 +1,13 @@
 #pragma once
 
 #include <Arduino.h>
+#include "BootManager.h"
+
+// Modem probing during init: AT every interval until "OK", or give up
+#define GSM_PROBE_INTERVAL_MS 250
+#define GSM_PROBE_TIMEOUT_MS 3000
+#define GSM_COMMAND_TIMEOUT_MS 1000
+#define GSM_INIT_TIMEOUT_MS 6000
 
 // GSM state structure
 struct GSMState {
@@ -15,6 +22,7 @@ extern GSMState gsmState;
 
 // GSM functions
 void initializeGSM();
+BootStatus pollGSMInit(BootStage &stage);
 bool waitForGSMResponse(String expectedResponse, unsigned long timeout);
 void checkGSMNetwork();
 void getGSMSignalStrength();
@@ -7,6 +7,12 @@ extern BluetoothSerial SerialBT;
 
 KeyboardState keyboardState;
 
+// Key events, from the matrix scan to the key handler job. Handlers run
+// outside the scan, so one that blocks (menus, showMessage) never does so
+// with a column driven low and is profiled apart from the scan; a press
+// made meanwhile waits here rather than being lost.
+static DMRSPSCQueue<KeyAction, KEY_QUEUE_DEPTH> keyEvents;
+
 // Direct I2C communication for keyboard
 #define PCF8574_ADDR 0x20
 
@@ -19,9 +25,13 @@ const KeyAction keyMatrix[ROWS][COLS] = {
 };
 
 void initializeKeyboard() {
+    runBootStep(pollKeyboardInit, 0);
+}
+
+// Boot step: the PCF8574 acking its address is the readiness check
+BootStatus pollKeyboardInit(BootStage &stage) {
     // Initialize I2C
     Wire.begin(I2C_SDA, I2C_SCL);
-    delay(100);
     
     // Initialize PCF8574 pins to all HIGH (rows and columns)
     Wire.beginTransmission(PCF8574_ADDR);
@@ -32,19 +42,17 @@ void initializeKeyboard() {
     } else {
         keyboardState.initialized = false;
         Serial.println("Failed to initialize keyboard!");
-        return;
+        stage.detail = "no PCF8574";
+        return BOOT_FAILED;
     }
     
     keyboardState.inputMode = 0; // Start in numeric mode
+    return BOOT_READY;
 }
 
 void scanKeyboard() {
     if (!keyboardState.initialized) return;
     
-    static unsigned long lastScan = 0;
-    if (millis() - lastScan < 50) return; // Debouncing
-    lastScan = millis();
-    
     // Scan the 4x4 matrix using working method
     for (byte col = 0; col < COLS; col++) {
         // Drive one column LOW (0), rest HIGH (1)
@@ -108,7 +116,7 @@ void scanKeyboard() {
                             }
                             
                             if (longPressKey != KEY_NONE) {
-                                handleKeyPress(longPressKey);
+                                keyEvents.push(longPressKey);
                                 keyboardState.keyPressed[keyIndex] = false; // Prevent repeat
                                 keyboardState.lastKey = KEY_NONE;
                             }
@@ -123,7 +131,7 @@ void scanKeyboard() {
                         
                         // Process the key press (only if it wasn't a long press)
                         if (keyboardState.lastKey == keyMatrix[row][col]) {
-                            handleKeyPress(keyboardState.lastKey);
+                            keyEvents.push(keyboardState.lastKey);
                             keyboardState.lastKey = KEY_NONE;
                         }
                     }
@@ -138,6 +146,13 @@ void scanKeyboard() {
     Wire.endTransmission();
 }
 
+void handleKeyEvents() {
+    KeyAction key;
+    while (keyEvents.pop(key)) {
+        handleKeyPress(key);
+    }
+}
+
 KeyAction getKeyPress() {
     KeyAction key = keyboardState.lastKey;
     keyboardState.lastKey = KEY_NONE;
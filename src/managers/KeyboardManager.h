@@ -2,6 +2,8 @@
 
 #include <Arduino.h>
 #include <Wire.h>
+#include "BootManager.h"
+#include "DMR828S_queue.h"
 
 // GPIO Extender Configuration (PCF8574)
 #define PCF8574_ADDRESS 0x20
@@ -13,6 +15,9 @@
 #define ROWS 4
 #define COLS 4
 
+// Key events waiting for the key handler job (power of two)
+#define KEY_QUEUE_DEPTH 8
+
 // Key mappings
 enum KeyAction {
     KEY_NONE = 0,
@@ -52,7 +57,9 @@ extern KeyboardState keyboardState;
 
 // Keyboard functions
 void initializeKeyboard();
-void scanKeyboard();
+BootStatus pollKeyboardInit(BootStage &stage);
+void scanKeyboard();                    // Producer: queues key events
+void handleKeyEvents();                 // Consumer: runs the handlers for queued events
 KeyAction getKeyPress();
 void handleKeyPress(KeyAction key);
 void processInput();
@@ -1,4 +1,5 @@
 #include "LoRaManager.h"
+#include "PositionCodec.h"
 #include "WalkieTalkie.h"
 #include "BluetoothSerial.h"
 
@@ -7,20 +8,32 @@ extern BluetoothSerial SerialBT;
 LoRaState loraState;
 
 void initializeLoRa() {
-    SerialBT.println("📡 Initializing LoRa module...");
-    
-    // Set LoRa pins
-    LoRa.setPins(LORA_SS_PIN, LORA_RST_PIN, LORA_DIO0_PIN);
+    runBootStep(pollLoRaInit, LORA_INIT_TIMEOUT_MS);
+}
+
+// Boot step: LoRa.begin() checks the radio's version register, so it is the
+// readiness probe itself; retried on a short interval instead of 500 ms sleeps
+BootStatus pollLoRaInit(BootStage &stage) {
+    if (stage.phase == 0) {
+        SerialBT.println("📡 Initializing LoRa module...");
+        
+        // Set LoRa pins
+        LoRa.setPins(LORA_SS_PIN, LORA_RST_PIN, LORA_DIO0_PIN);
+        bootPhase(stage, 1);
+    } else if (millis() - stage.pollAt < LORA_RETRY_INTERVAL_MS) {
+        return BOOT_RUNNING;
+    }
     
     // Initialize LoRa with Asian frequency
-    int attempts = 0;
-    while (!LoRa.begin(LORA_FREQUENCY) && attempts < 10) {
-        SerialBT.print(".");
-        delay(500);
-        attempts++;
+    stage.pollAt = millis();
+    if (!LoRa.begin(LORA_FREQUENCY)) {
+        if (++stage.tries < LORA_INIT_ATTEMPTS) {
+            SerialBT.print(".");
+            return BOOT_RUNNING;
+        }
     }
     
-    if (attempts < 10) {
+    if (stage.tries < LORA_INIT_ATTEMPTS) {
         // LoRa initialized successfully
         LoRa.setSyncWord(LORA_SYNC_WORD);
         LoRa.setTxPower(20); // Set max transmission power
@@ -36,11 +49,14 @@ void initializeLoRa() {
         SerialBT.println("  Frequency: 433MHz");
         SerialBT.println("  Sync Word: 0xF3");
         SerialBT.println("  TX Power: 20dBm");
-    } else {
-        SerialBT.println("❌ LoRa module not responding");
-        loraState.initialized = false;
-        loraState.available = false;
+        return BOOT_READY;
     }
+    
+    SerialBT.println("❌ LoRa module not responding");
+    loraState.initialized = false;
+    loraState.available = false;
+    stage.detail = "no answer";
+    return BOOT_FAILED;
 }
 
 bool sendLoRaMessage(String message) {
@@ -92,7 +108,7 @@ void checkLoRaMessages() {
 
 void handleLoRaMessage(String message) {
     // Check if this is a GPS message and parse it
-    if (message.startsWith("GPS ")) {
+    if (isPositionReport(message)) {
         // Parse GPS coordinates from LoRa
         extern void parseIncomingGPS(String message, String commMode);
         parseIncomingGPS(message, "LoRa");
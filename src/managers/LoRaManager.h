@@ -3,6 +3,7 @@
 #include <Arduino.h>
 #include <SPI.h>
 #include <LoRa.h>
+#include "BootManager.h"
 
 // LoRa pin definitions
 #define LORA_SS_PIN 5
@@ -13,6 +14,11 @@
 #define LORA_FREQUENCY 433E6
 #define LORA_SYNC_WORD 0xF3
 
+// Init: LoRa.begin() attempts and the pause between them
+#define LORA_INIT_ATTEMPTS 10
+#define LORA_RETRY_INTERVAL_MS 100
+#define LORA_INIT_TIMEOUT_MS 2000
+
 // LoRa state structure
 struct LoRaState {
     bool initialized = false;
@@ -27,6 +33,7 @@ extern LoRaState loraState;
 
 // LoRa functions
 void initializeLoRa();
+BootStatus pollLoRaInit(BootStage &stage);
 bool sendLoRaMessage(String message);
 void checkLoRaMessages();
 void handleLoRaMessage(String message);
@@ -0,0 +1,28 @@
+#include "MemoryManager.h"
+
+static const char *const memSiteNames[MEM_SITE_COUNT] = {
+    "other", "radio", "gps", "ui", "comms", "commands", "nmea parse", "gps json", "menu", "capture",
+};
+
+static DMRMemTracker memTracker(memSiteNames, MEM_SITE_COUNT);
+
+void initializeMemory() {
+    memTracker.attach();
+    memTracker.sample();
+}
+
+void sampleMemory() {
+    memTracker.sample();
+}
+
+void showMemoryTo(Stream* stream) {
+    stream->print("\n🧮 Memory (heap sampled every ");
+    stream->print(MEM_SAMPLE_MS / 60000);
+    stream->println(" min):");
+    memTracker.printTo(*stream);
+}
+
+void resetMemory() {
+    memTracker.reset();
+    memTracker.sample();
+}
\ No newline at end of file
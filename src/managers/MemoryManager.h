@@ -0,0 +1,33 @@
+#pragma once
+
+#include <Arduino.h>
+#include "DMR828S_mem.h"
+
+// Heap use over a long run, for the 'mem' command. Every allocation is
+// counted against the site the allocating task is in: each task's work
+// under its subsystem, and the String-heavy call sites under their own
+// name. The heap is sampled on a timer, so the report shows the allocation
+// rate, live blocks and the largest free block drifting over the last
+// DMR_MEM_HISTORY samples. Counting needs DMR_MEM_HOOKS and the allocator
+// wrapped at link time (platformio.ini).
+#define MEM_SAMPLE_MS 300000UL          // 24 samples: the last two hours
+
+enum MemSite : uint8_t {
+    MEM_OTHER,                          // Outside any scope: boot, Bluetooth stack, Arduino core
+    MEM_RADIO,                          // Radio pass, DMR event callbacks included
+    MEM_GPS,
+    MEM_UI,                             // Bluetooth input, keypad, display, stored config
+    MEM_COMMS,                          // GSM and LoRa
+    MEM_COMMAND,                        // processCommand handlers, on whichever task runs them
+    MEM_NMEA,                           // parseNMEA field split
+    MEM_GPS_JSON,                       // formatGPSToJSON
+    MEM_MENU,                           // Menu construction, navigation and drawing
+    MEM_CAPTURE,                        // Command output captured for the display
+    MEM_SITE_COUNT
+};
+
+// Memory functions
+void initializeMemory();                // First thing at boot: count from here
+void sampleMemory();                    // Timer job, every MEM_SAMPLE_MS
+void showMemoryTo(Stream* stream);
+void resetMemory();
\ No newline at end of file
@@ -0,0 +1,262 @@
+#include "PositionCodec.h"
+
+// Unit roster known to every radio; index is what goes on air. Keep the
+// order identical across the fleet and only append.
+static String positionDictionary[POSITION_DICTIONARY_SIZE] = { "BSF12345" };
+static uint8_t positionDictionaryCount = 1;
+
+// Last key report seen from each sender
+struct PositionKey {
+    bool used = false;
+    String soldierID;
+    uint8_t seq = 0;
+    int32_t lat = 0;
+    int32_t lon = 0;
+    uint32_t lastUsed = 0;
+};
+static PositionKey positionKeys[POSITION_KEY_SLOTS];
+static uint32_t positionKeyClock = 0;
+
+static const char base64Chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+#define POSITION_SCALE          100000L
+#define POSITION_LAT_OFFSET     (90L * POSITION_SCALE)
+#define POSITION_LON_OFFSET     (180L * POSITION_SCALE)
+#define POSITION_DELTA_LIMIT    2047
+
+// =============== DICTIONARY ===============
+
+int positionDictionaryFind(const String &soldierID) {
+    for (uint8_t i = 0; i < positionDictionaryCount; i++) {
+        if (positionDictionary[i] == soldierID) return i;
+    }
+    return -1;
+}
+
+int positionDictionaryAdd(const String &soldierID) {
+    int index = positionDictionaryFind(soldierID);
+    if (index >= 0) return index;
+    if (positionDictionaryCount >= POSITION_DICTIONARY_SIZE) return -1;
+    positionDictionary[positionDictionaryCount] = soldierID;
+    return positionDictionaryCount++;
+}
+
+// =============== BINARY ===============
+
+static int32_t quantize(double degrees) {
+    return (int32_t)lround(degrees * POSITION_SCALE);
+}
+
+size_t encodePosition(const PositionReport &report, PositionEncoder &encoder, uint8_t *out, size_t capacity) {
+    if (capacity < POSITION_MAX_BINARY) return 0;
+
+    int32_t lat = quantize(report.latitude);
+    int32_t lon = quantize(report.longitude);
+    if (lat < -POSITION_LAT_OFFSET || lat > POSITION_LAT_OFFSET ||
+        lon < -POSITION_LON_OFFSET || lon > POSITION_LON_OFFSET) {
+        return 0;
+    }
+
+    // Key report when there is nothing to diff against or the diff does not fit
+    int32_t dLat = lat - encoder.keyLat;
+    int32_t dLon = lon - encoder.keyLon;
+    bool key = !encoder.hasKey || encoder.sinceKey >= POSITION_KEY_INTERVAL ||
+               encoder.keySoldier != report.soldierID ||
+               abs(dLat) > POSITION_DELTA_LIMIT || abs(dLon) > POSITION_DELTA_LIMIT;
+    if (key) {
+        encoder.hasKey = true;
+        encoder.keySeq++;
+        encoder.keyLat = lat;
+        encoder.keyLon = lon;
+        encoder.keySoldier = report.soldierID;
+        encoder.sinceKey = 0;
+    } else {
+        encoder.sinceKey++;
+    }
+
+    size_t n = 0;
+    out[n++] = (POSITION_CODEC_VERSION << 6) | ((key ? 0 : 1) << 5) |
+               ((report.fix & 0x03) << 3) | ((report.hasTime ? 1 : 0) << 2);
+
+    int index = positionDictionaryFind(report.soldierID);
+    if (index >= 0) {
+        out[n++] = index;
+    } else {
+        uint8_t idLength = report.soldierID.length() > POSITION_MAX_ID_LENGTH ?
+                           POSITION_MAX_ID_LENGTH : report.soldierID.length();
+        out[n++] = POSITION_INLINE_ID;
+        out[n++] = idLength;
+        memcpy(&out[n], report.soldierID.c_str(), idLength);
+        n += idLength;
+    }
+    out[n++] = encoder.keySeq;
+
+    if (key) {
+        uint64_t packed = ((uint64_t)(lat + POSITION_LAT_OFFSET) << 26) | (uint32_t)(lon + POSITION_LON_OFFSET);
+        for (int shift = 48; shift >= 0; shift -= 8) {
+            out[n++] = (packed >> shift) & 0xFF;
+        }
+    } else {
+        uint32_t packed = ((uint32_t)(dLat & 0xFFF) << 12) | (uint32_t)(dLon & 0xFFF);
+        out[n++] = packed >> 16;
+        out[n++] = packed >> 8;
+        out[n++] = packed;
+    }
+
+    if (report.hasTime) {
+        uint16_t halfSeconds = (report.secondsOfDay % 86400) / 2;
+        out[n++] = halfSeconds >> 8;
+        out[n++] = halfSeconds;
+    }
+    return n;
+}
+
+static PositionKey* findKey(const String &soldierID) {
+    for (uint8_t i = 0; i < POSITION_KEY_SLOTS; i++) {
+        if (positionKeys[i].used && positionKeys[i].soldierID == soldierID) return &positionKeys[i];
+    }
+    return nullptr;
+}
+
+static PositionKey* allocateKey(const String &soldierID) {
+    PositionKey *slot = findKey(soldierID);
+    if (slot) return slot;
+
+    // Free slot, else the sender heard from least recently
+    slot = &positionKeys[0];
+    for (uint8_t i = 0; i < POSITION_KEY_SLOTS; i++) {
+        if (!positionKeys[i].used) return &positionKeys[i];
+        if (positionKeys[i].lastUsed < slot->lastUsed) slot = &positionKeys[i];
+    }
+    return slot;
+}
+
+static int32_t signExtend12(uint32_t value) {
+    return (value & 0x800) ? (int32_t)value - 0x1000 : (int32_t)value;
+}
+
+bool decodePosition(const uint8_t *data, size_t length, PositionReport &report) {
+    size_t n = 0;
+    if (length < 3 || (data[0] >> 6) != POSITION_CODEC_VERSION) return false;
+
+    bool delta = data[0] & 0x20;
+    uint8_t fix = (data[0] >> 3) & 0x03;
+    bool hasTime = data[0] & 0x04;
+    if (fix > POSITION_FIX_DEFAULT) return false;
+    n++;
+
+    String soldierID;
+    if (data[n] == POSITION_INLINE_ID) {
+        n++;
+        uint8_t idLength = data[n++];
+        if (idLength > POSITION_MAX_ID_LENGTH || n + idLength > length) return false;
+        for (uint8_t i = 0; i < idLength; i++) soldierID += (char)data[n++];
+    } else {
+        if (data[n] >= positionDictionaryCount) return false;
+        soldierID = positionDictionary[data[n++]];
+    }
+
+    // Everything left has a fixed size
+    size_t rest = 1 + (delta ? 3 : 7) + (hasTime ? 2 : 0);
+    if (length - n != rest) return false;
+    uint8_t seq = data[n++];
+
+    int32_t lat, lon;
+    if (!delta) {
+        uint64_t packed = 0;
+        for (uint8_t i = 0; i < 7; i++) packed = (packed << 8) | data[n++];
+        lat = (int32_t)(packed >> 26) - POSITION_LAT_OFFSET;
+        lon = (int32_t)(packed & 0x3FFFFFF) - POSITION_LON_OFFSET;
+        if (lat > POSITION_LAT_OFFSET || lon > POSITION_LON_OFFSET) return false;
+
+        PositionKey *keyReport = allocateKey(soldierID);
+        keyReport->used = true;
+        keyReport->soldierID = soldierID;
+        keyReport->seq = seq;
+        keyReport->lat = lat;
+        keyReport->lon = lon;
+        keyReport->lastUsed = ++positionKeyClock;
+    } else {
+        // Without the key this delta was taken against there is no position
+        PositionKey *keyReport = findKey(soldierID);
+        if (!keyReport || keyReport->seq != seq) return false;
+        uint32_t packed = ((uint32_t)data[n] << 16) | ((uint32_t)data[n + 1] << 8) | data[n + 2];
+        n += 3;
+        lat = keyReport->lat + signExtend12(packed >> 12);
+        lon = keyReport->lon + signExtend12(packed & 0xFFF);
+        keyReport->lastUsed = ++positionKeyClock;
+    }
+
+    report.soldierID = soldierID;
+    report.latitude = (double)lat / POSITION_SCALE;
+    report.longitude = (double)lon / POSITION_SCALE;
+    report.fix = (PositionFix)fix;
+    report.hasTime = hasTime;
+    report.secondsOfDay = hasTime ? (((uint32_t)data[n] << 8) | data[n + 1]) * 2 : 0;
+    return true;
+}
+
+// =============== TEXT ===============
+
+String encodePositionText(const PositionReport &report, PositionEncoder &encoder) {
+    uint8_t data[POSITION_MAX_BINARY];
+    size_t length = encodePosition(report, encoder, data, sizeof(data));
+    if (length == 0) return "";
+
+    String text = POSITION_TEXT_PREFIX;
+    text.reserve(strlen(POSITION_TEXT_PREFIX) + (length * 4 + 2) / 3);
+    for (size_t i = 0; i < length; i += 3) {
+        uint32_t chunk = (uint32_t)data[i] << 16;
+        if (i + 1 < length) chunk |= (uint32_t)data[i + 1] << 8;
+        if (i + 2 < length) chunk |= data[i + 2];
+
+        text += base64Chars[(chunk >> 18) & 0x3F];
+        text += base64Chars[(chunk >> 12) & 0x3F];
+        if (i + 1 < length) text += base64Chars[(chunk >> 6) & 0x3F];
+        if (i + 2 < length) text += base64Chars[chunk & 0x3F];
+    }
+    return text;
+}
+
+static int base64Value(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '-') return 62;
+    if (c == '_') return 63;
+    return -1;
+}
+
+bool decodePositionText(const String &message, PositionReport &report) {
+    if (!message.startsWith(POSITION_TEXT_PREFIX)) return false;
+
+    // The report runs to the first space (LoRa appends a target tag)
+    uint8_t data[POSITION_MAX_BINARY];
+    size_t length = 0;
+    uint32_t bits = 0;
+    uint8_t bitCount = 0;
+    for (unsigned int i = strlen(POSITION_TEXT_PREFIX); i < message.length() && message[i] != ' '; i++) {
+        int value = base64Value(message[i]);
+        if (value < 0) return false;
+        bits = (bits << 6) | value;
+        bitCount += 6;
+        if (bitCount >= 8) {
+            if (length >= sizeof(data)) return false;
+            bitCount -= 8;
+            data[length++] = (bits >> bitCount) & 0xFF;
+        }
+    }
+    return decodePosition(data, length, report);
+}
+
+bool isPositionReport(const String &message) {
+    return message.startsWith(POSITION_TEXT_PREFIX) || message.startsWith("GPS ");
+}
+
+const char* positionFixName(PositionFix fix) {
+    switch (fix) {
+        case POSITION_FIX_CURRENT: return "CURRENT";
+        case POSITION_FIX_LAST: return "LAST GPS";
+        default: return "DEFAULT";
+    }
+}
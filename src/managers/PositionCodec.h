@@ -0,0 +1,64 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Compact position reports
+//
+// Binary layout (version 1, big-endian):
+//   [0]  header   ver(2) | delta(1) | fix(2) | time(1) | 0(2)
+//   [1]  soldier  dictionary index, or 0xFF followed by length + ASCII ID
+//   [n]  key      sequence of the key report (its own for a key report)
+//   key:   lat/lon in 1e-5 degree units, offset to unsigned, 25 + 26 bits in 7 bytes
+//   delta: lat/lon difference to that key report, two signed 12-bit fields in 3 bytes
+//   time:  seconds of day / 2, 2 bytes (only when the time bit is set)
+//
+// A delta decodes only against the key report it names, so a lost delta
+// never corrupts the ones after it; a lost key report makes the following
+// deltas undecodable until the next key. As text the report is
+// POSITION_TEXT_PREFIX + base64url (no padding).
+#define POSITION_CODEC_VERSION      1
+#define POSITION_TEXT_PREFIX        "#G"
+#define POSITION_KEY_INTERVAL       8       // Deltas between key reports
+#define POSITION_MAX_BINARY         32
+#define POSITION_DICTIONARY_SIZE    16
+#define POSITION_KEY_SLOTS          8       // Senders the decoder tracks
+#define POSITION_INLINE_ID          0xFF
+#define POSITION_MAX_ID_LENGTH      15
+
+enum PositionFix : uint8_t {
+    POSITION_FIX_CURRENT = 0,
+    POSITION_FIX_LAST = 1,
+    POSITION_FIX_DEFAULT = 2
+};
+
+struct PositionReport {
+    String soldierID;
+    double latitude = 0;
+    double longitude = 0;
+    PositionFix fix = POSITION_FIX_DEFAULT;
+    bool hasTime = false;
+    uint32_t secondsOfDay = 0;
+};
+
+// Sender side state, one per link (each link has its own receivers)
+struct PositionEncoder {
+    bool hasKey = false;
+    uint8_t keySeq = 0;
+    int32_t keyLat = 0;
+    int32_t keyLon = 0;
+    uint8_t sinceKey = 0;
+    String keySoldier;
+};
+
+// Soldier ID dictionary shared by the unit; IDs not in it are sent inline
+int positionDictionaryAdd(const String &soldierID);
+int positionDictionaryFind(const String &soldierID);
+
+size_t encodePosition(const PositionReport &report, PositionEncoder &encoder, uint8_t *out, size_t capacity);
+bool decodePosition(const uint8_t *data, size_t length, PositionReport &report);
+String encodePositionText(const PositionReport &report, PositionEncoder &encoder);
+bool decodePositionText(const String &message, PositionReport &report);
+
+// True for compact ("#G...") and legacy ("GPS ...") reports
+bool isPositionReport(const String &message);
+const char* positionFixName(PositionFix fix);
@@ -0,0 +1,794 @@
+#include "TaskManager.h"
+#include "WalkieTalkie.h"
+#include "GPSManager.h"
+#include "GSMManager.h"
+#include "LoRaManager.h"
+#include "DisplayManager.h"
+#include "KeyboardManager.h"
+#include "ConfigManager.h"
+#include "MemoryManager.h"
+
+TaskState taskState;
+
+// Output of a routed command. The caller stops waiting after
+// TASK_ROUTE_TIMEOUT_MS, and its stream may live on its stack (display
+// capture), so the owner writes through this proxy and the caller detaches it
+// before returning; output after that is dropped. Freed by whichever side
+// releases it last.
+class RoutedStream final : public Stream {
+public:
+    RoutedStream(Stream *target) :
+        done(xSemaphoreCreateBinary()), target(target), lock(xSemaphoreCreateMutex()) {}
+    
+    bool ready() const { return done && lock; }
+    
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buffer, size_t size) override {
+        xSemaphoreTake(lock, portMAX_DELAY);
+        if (target) {
+            target->write(buffer, size);
+        }
+        xSemaphoreGive(lock);
+        return size;
+    }
+    int available() override { return forward(&Stream::available); }
+    int read() override { return forward(&Stream::read); }
+    int peek() override { return forward(&Stream::peek); }
+    
+    // Caller side, once it stops waiting
+    void detach() {
+        xSemaphoreTake(lock, portMAX_DELAY);
+        target = nullptr;
+        xSemaphoreGive(lock);
+    }
+    
+    void release() {
+        if (refs.fetch_sub(1) == 1) {
+            delete this;
+        }
+    }
+    
+    SemaphoreHandle_t done;             // Given by the owner when the command has run
+    
+private:
+    ~RoutedStream() {
+        if (done) vSemaphoreDelete(done);
+        if (lock) vSemaphoreDelete(lock);
+    }
+    
+    int forward(int (Stream::*call)()) {
+        xSemaphoreTake(lock, portMAX_DELAY);
+        int result = target ? (target->*call)() : -1;
+        xSemaphoreGive(lock);
+        return result;
+    }
+    
+    Stream *target;
+    SemaphoreHandle_t lock;
+    std::atomic<uint8_t> refs{2};       // Caller and owner
+};
+
+// A command handed to its owner task. The text is heap-allocated by the sender
+// and freed by the owner; `routed` is released when it has run (null: nobody waits).
+struct TaskCommand {
+    String *command;
+    Stream *stream;
+    RoutedStream *routed;
+    uint32_t postedUs;
+};
+
+static void radioTask(void *arg);
+static void timerTask(void *arg);
+
+struct TaskSpec {
+    const char *name;
+    TaskFunction_t entry;
+    uint32_t stack;
+    UBaseType_t priority;
+    BaseType_t core;
+    MemSite memSite;                    // Allocations made by its jobs
+};
+
+static const TaskSpec taskSpecs[TASK_COUNT] = {
+    { "radio", radioTask, RADIO_TASK_STACK, RADIO_TASK_PRIORITY, RADIO_TASK_CORE, MEM_RADIO },
+    { "gps", timerTask, GPS_TASK_STACK, GPS_TASK_PRIORITY, GPS_TASK_CORE, MEM_GPS },
+    { "ui", timerTask, UI_TASK_STACK, UI_TASK_PRIORITY, UI_TASK_CORE, MEM_UI },
+    { "comms", timerTask, COMMS_TASK_STACK, COMMS_TASK_PRIORITY, COMMS_TASK_CORE, MEM_COMMS },
+};
+
+static const char *const perfStageNames[PERF_STAGE_COUNT] = {
+    "dmr.update", "link sampler", "scanner", "hopping", "gps read", "bluetooth",
+    "keypad", "key events", "display", "config", "gsm poll", "lora poll", "mem sample",
+};
+
+// Each stage is recorded by the one task that runs it (all of them by loop() without tasks)
+static DMRPerfProfiler profiler(perfStageNames, PERF_STAGE_COUNT);
+
+// Periodic work, run from the owning task's timer service; the stage names the timer
+struct TaskJob {
+    TaskId task;
+    PerfStage stage;
+    uint32_t periodMs;
+    void (*run)();
+};
+
+static void readAndPublishGPS() {
+    readGPS();
+    publishGPSTime();
+    publishGPSFix();
+}
+
+static void updateConfigAndPublish() {
+    updateConfigStore();
+    publishSoldierID();
+}
+
+static void pollGSMAndPublish() {
+    checkIncomingGSMSMS();
+    publishPhoneNumber();
+}
+
+static const TaskJob taskJobs[] = {
+    { TASK_GPS, PERF_GPS_READ, GPS_READ_MS, readAndPublishGPS },
+    { TASK_UI, PERF_BLUETOOTH, BLUETOOTH_POLL_MS, handleBluetoothCommands },
+    { TASK_UI, PERF_KEYPAD, KEY_SCAN_MS, scanKeyboard },
+    { TASK_UI, PERF_KEY_EVENTS, KEY_SCAN_MS, handleKeyEvents },
+    { TASK_UI, PERF_DISPLAY, DISPLAY_REFRESH_MS, updateDisplay },
+    { TASK_UI, PERF_CONFIG, CONFIG_CHECK_MS, updateConfigAndPublish },
+    { TASK_COMMS, PERF_GSM_POLL, GSM_POLL_MS, pollGSMAndPublish },
+    { TASK_COMMS, PERF_LORA_POLL, LORA_POLL_MS, checkLoRaMessages },
+    { TASK_UI, PERF_MEMORY, MEM_SAMPLE_MS, sampleMemory },
+};
+
+static QueueHandle_t commandQueues[TASK_COUNT];
+static TaskHandle_t taskHandles[TASK_COUNT];
+static DMRSPSCQueue<GPSTimeSync, 4> gpsTimeQueue;    // GPS task -> radio task
+static DMRSPSCQueue<LinkSnapshot, 4> linkQueue;      // Radio task -> UI task
+static DMRTimerService timerServices[TASK_COUNT];
+static unsigned long timerStatsSince = 0;
+static unsigned long perfSince = 0;
+
+// Stalls are pushed by whichever task stalled and drained by the 'stalls' command
+static DMRMPSCQueue<StallRecord, STALL_HISTORY> stallQueue;
+static StallRecord stallHistory[STALL_HISTORY];     // Ring, owned by the 'stalls' reader
+static uint8_t stallHead = 0;
+static uint32_t stallsShown = 0;
+static std::atomic<uint32_t> stallsDropped{0};      // Queue full: nobody ran 'stalls' for a while
+static uint32_t stallBudgetUs = STALL_BUDGET_MS * 1000UL;
+static uint32_t lastStallUs[TASK_COUNT + 1];        // Per context, for nesting
+static bool stalled[TASK_COUNT + 1];
+
+static void onStageOverBudget(uint8_t stage, uint32_t ticks, void *context);
+
+void initializeTasks() {
+    for (uint8_t i = 0; i < TASK_COUNT; i++) {
+        commandQueues[i] = xQueueCreate(TASK_QUEUE_DEPTH, sizeof(TaskCommand));
+    }
+    profiler.setBudget(stallBudgetUs, onStageOverBudget);
+}
+
+bool startTasks() {
+    startTaskTimers();
+    // Every task starts with copies of what boot left behind
+    publishGPSFix();
+    publishSoldierID();
+    publishPhoneNumber();
+    
+    // Handles are stored before a task first runs, so routing works from its first pass
+    taskState.running = true;
+    bool ok = true;
+    for (uint8_t i = 0; i < TASK_COUNT; i++) {
+        const TaskSpec &spec = taskSpecs[i];
+        if (!commandQueues[i] ||
+            xTaskCreatePinnedToCore(spec.entry, spec.name, spec.stack, (void *)(intptr_t)i,
+                                    spec.priority, &taskHandles[i], spec.core) != pdPASS) {
+            taskHandles[i] = nullptr;
+            SerialBT.print("❌ Could not start task: ");
+            SerialBT.println(spec.name);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+static int8_t currentTask() {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    for (uint8_t i = 0; i < TASK_COUNT; i++) {
+        if (taskHandles[i] == self) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+TaskId commandOwner(const String &command) {
+    // Both modems answer AT commands with multi-second delays; smartsend tries LoRa, then GSM
+    if (command.startsWith("gsm") || command.startsWith("lora") || command.startsWith("smartsend ")) {
+        return TASK_COMMS;
+    }
+    // gpsinfo reads the GPS UART itself for 2 s
+    if (command == "gpsinfo" || command.startsWith("gpsauto ") || command == "gpsstop") {
+        return TASK_GPS;
+    }
+    if (command == "help" || command == "bt" || command == "boottime" || command.startsWith("config") ||
+        command.startsWith("soldierid ") || command == "i2cscan" || command == "keytest" || command == "keyscan") {
+        return TASK_UI;
+    }
+    // Everything else talks to the DMR module
+    return TASK_RADIO;
+}
+
+static bool queueCommand(TaskId task, Stream* stream, const String &command,
+                         RoutedStream *routed, TickType_t wait) {
+    TaskCommand item;
+    item.command = new String(command);
+    item.stream = routed ? routed : stream;
+    item.routed = routed;
+    item.postedUs = micros();
+    if (xQueueSend(commandQueues[task], &item, wait) != pdTRUE) {
+        delete item.command;
+        taskState.stats[task].refused++;
+        stream->print("❌ ");
+        stream->print(taskSpecs[task].name);
+        stream->println(" task busy - command dropped");
+        return false;
+    }
+    if (task == TASK_RADIO) {
+        // The radio task sleeps on the receive semaphore, not on its command queue
+        dmr.getLowLevel().wakeRx();
+    }
+    return true;
+}
+
+bool routeCommand(Stream* stream, const String &command) {
+    if (!taskState.running) {
+        return false;
+    }
+    TaskId owner = commandOwner(command);
+    if (!taskHandles[owner] || currentTask() == owner) {
+        return false;
+    }
+    
+    RoutedStream *routed = new RoutedStream(stream);
+    if (!routed->ready()) {
+        routed->release();
+        routed->release();
+        return false;
+    }
+    if (!queueCommand(owner, stream, command, routed, pdMS_TO_TICKS(TASK_POST_TIMEOUT_MS))) {
+        routed->release();              // The owner's reference too: it never got it
+    } else if (xSemaphoreTake(routed->done, pdMS_TO_TICKS(TASK_ROUTE_TIMEOUT_MS)) != pdTRUE) {
+        // A stuck owner must not hang this task too; it finishes on its own
+        routed->detach();
+        stream->print("⏰ ");
+        stream->print(taskSpecs[owner].name);
+        stream->println(" task still running it - output dropped");
+    }
+    routed->release();
+    return true;
+}
+
+void postCommand(TaskId task, Stream* stream, const String &command) {
+    if (!taskState.running || !taskHandles[task]) {
+        processCommand(stream, command);
+        return;
+    }
+    queueCommand(task, stream, command, nullptr, 0);
+}
+
+// Runs commands queued for this task, waiting up to waitMs for the first
+static void serviceCommands(TaskId task, uint32_t waitMs) {
+    TaskStats &stats = taskState.stats[task];
+    TaskCommand item;
+    // Capped so pdMS_TO_TICKS cannot overflow; a long deadline is just re-checked
+    if (waitMs > 60000) {
+        waitMs = 60000;
+    }
+    while (xQueueReceive(commandQueues[task], &item, pdMS_TO_TICKS(waitMs)) == pdTRUE) {
+        waitMs = 0;
+        uint32_t start = micros();
+        if (start - item.postedUs > stats.maxWaitUs) {
+            stats.maxWaitUs = start - item.postedUs;
+        }
+        processCommand(item.stream, *item.command);
+        delete item.command;
+        uint32_t ran = micros() - start;
+        if (ran > stats.maxRunUs) {
+            stats.maxRunUs = ran;
+        }
+        stats.commands++;
+        if (item.routed) {
+            xSemaphoreGive(item.routed->done);
+            item.routed->release();
+        }
+    }
+}
+
+static void notePass(TaskId task, uint32_t startUs) {
+    uint32_t us = micros() - startUs;
+    if (us > taskState.stats[task].maxPassUs) {
+        taskState.stats[task].maxPassUs = us;
+    }
+    checkPassBudget(startUs);
+}
+
+// =============== TASKS ===============
+
+static void radioTask(void *arg) {
+    for (;;) {
+        uint32_t start = micros();
+        updateRadio();
+        notePass(TASK_RADIO, start);
+        
+        serviceCommands(TASK_RADIO, 0);
+        
+        // Returns as soon as the receive task queues a frame or a command is queued
+        dmr.getLowLevel().waitForRx(radioWaitMs());
+    }
+}
+
+void updateRadio() {
+    DMR_MEM_SCOPE(MEM_RADIO);
+    {
+        DMR_PERF_SCOPE(profiler, PERF_DMR_UPDATE);
+        dmr.update();
+    }
+    {
+        DMR_PERF_SCOPE(profiler, PERF_LINK_SAMPLER);
+        linkSampler.update();
+        publishLinkSnapshot();
+    }
+    {
+        DMR_PERF_SCOPE(profiler, PERF_SCANNER);
+        channelScanner.update();
+    }
+    DMR_PERF_SCOPE(profiler, PERF_HOPPING);
+    updateFrequencyHopping();
+}
+
+uint32_t radioWaitMs() {
+    uint32_t hopMs = hopScheduler.msUntilUpdate();
+    return hopMs < RADIO_POLL_MS ? hopMs : RADIO_POLL_MS;
+}
+
+// GPS, UI and comms: due jobs, then commands until the next deadline
+static void timerTask(void *arg) {
+    TaskId task = (TaskId)(intptr_t)arg;
+    DMRTimerService &timers = taskTimers(task);
+    for (;;) {
+        uint32_t start = micros();
+        uint32_t waitMs = timers.run();
+        notePass(task, start);
+        
+        serviceCommands(task, waitMs);
+    }
+}
+
+// =============== TIMERS ===============
+
+static void runJob(void *context) {
+    const TaskJob *job = (const TaskJob *)context;
+    DMR_PERF_SCOPE(profiler, job->stage);
+    DMR_MEM_SCOPE(taskSpecs[job->task].memSite);
+    job->run();
+}
+
+void startTaskTimers() {
+    for (uint8_t i = 0; i < sizeof(taskJobs) / sizeof(taskJobs[0]); i++) {
+        const TaskJob &job = taskJobs[i];
+        taskTimers(job.task).startPeriodic(job.periodMs, runJob, (void *)&job, perfStageNames[job.stage]);
+    }
+    timerStatsSince = millis();
+}
+
+DMRTimerService &taskTimers(TaskId task) {
+#if WT_USE_TASKS
+    return timerServices[task];
+#else
+    return timerServices[TASK_RADIO];
+#endif
+}
+
+uint32_t runTaskTimers() {
+    return taskTimers(TASK_RADIO).run();
+}
+
+// =============== GPS TIME ===============
+
+void publishGPSTime() {
+    static unsigned long lastSync = 0;
+    if (!gpsState.hasUtc || gpsState.utcAtMillis == lastSync) {
+        return;
+    }
+    lastSync = gpsState.utcAtMillis;
+    
+    // Copied whole on this side, so the radio task never sees a half-written 64-bit time.
+    // Fixes come once a second and are taken within ms; a full queue only means no consumer.
+    GPSTimeSync sync;
+    sync.utcMillis = gpsState.utcMillis;
+    sync.atMillis = gpsState.utcAtMillis;
+    gpsTimeQueue.push(sync);
+}
+
+bool receiveGPSTime(GPSTimeSync &sync) {
+    // Only the newest fix matters
+    bool received = false;
+    while (gpsTimeQueue.pop(sync)) {
+        received = true;
+    }
+    return received;
+}
+
+// =============== SHARED STATE ===============
+
+// A value one task owns, copied to each of the others through its own
+// one-deep mailbox. Each mailbox is a triple buffer: the owner overwrites the
+// pending copy rather than waiting for a slow reader, and a reader always takes
+// the newest one, neither side locking. The owner publishes from a periodic job
+// and skips a value equal to the last one.
+template <typename T>
+class TaskCopies {
+public:
+    // Owner side
+    void publish(TaskId owner, const T &value) {
+        if (published && sameCopy(last, value)) {
+            return;
+        }
+        last = value;
+        published = true;
+        for (uint8_t i = 0; i < TASK_COUNT; i++) {
+            if (i == owner) {
+                continue;
+            }
+            Mailbox &box = boxes[i];
+            box.slots[box.back] = value;
+            box.back = box.pending.exchange(box.back | FRESH, std::memory_order_acq_rel) & SLOT;
+        }
+    }
+    
+    // Reader side: valid until this task's next call
+    const T &receive(TaskId task) {
+        Mailbox &box = boxes[task];
+        if (box.pending.load(std::memory_order_relaxed) & FRESH) {
+            box.front = box.pending.exchange(box.front, std::memory_order_acq_rel) & SLOT;
+        }
+        return box.slots[box.front];
+    }
+
+private:
+    static const uint8_t SLOT = 0x03;
+    static const uint8_t FRESH = 0x04;  // pending holds a copy the reader has not taken
+    
+    struct Mailbox {
+        T slots[3];
+        std::atomic<uint8_t> pending{1};    // Slot handed between the two sides
+        uint8_t back = 0;                   // Owner's slot
+        uint8_t front = 2;                  // Reader's slot
+    };
+    
+    Mailbox boxes[TASK_COUNT];
+    T last;                             // Owner's: the last value published
+    bool published = false;
+};
+
+static bool sameCopy(const GPSFixSnapshot &a, const GPSFixSnapshot &b) {
+    return a.valid == b.valid && a.latitude == b.latitude && a.longitude == b.longitude &&
+           a.hasLast == b.hasLast && a.lastLatitude == b.lastLatitude && a.lastLongitude == b.lastLongitude &&
+           a.hasTime == b.hasTime && a.second == b.second && a.minute == b.minute && a.hour == b.hour &&
+           a.day == b.day && a.month == b.month && a.year == b.year;
+}
+
+static bool sameCopy(const IdentityText &a, const IdentityText &b) {
+    return strcmp(a.text, b.text) == 0;
+}
+
+static TaskCopies<GPSFixSnapshot> gpsFixes;
+static TaskCopies<IdentityText> soldierIDs;
+static TaskCopies<IdentityText> phoneNumbers;
+
+// The owner's own state, or a copy of it on any other task. Without tasks
+// (and during boot) there is only one context and the state is read directly.
+static bool readsOwnState(TaskId owner, int8_t &task) {
+    task = currentTask();
+    return task < 0 || task == owner;
+}
+
+static GPSFixSnapshot copyGPSFix() {
+    GPSFixSnapshot fix;
+    fix.valid = gpsState.hasValidFix;
+    fix.latitude = gpsState.latitude;
+    fix.longitude = gpsState.longitude;
+    fix.hasLast = gpsState.hasLastLocation;
+    fix.lastLatitude = gpsState.lastLatitude;
+    fix.lastLongitude = gpsState.lastLongitude;
+    fix.hasTime = gpsState.hasValidTime;
+    fix.year = gpsState.gpsYear;
+    fix.month = gpsState.gpsMonth;
+    fix.day = gpsState.gpsDay;
+    fix.hour = gpsState.gpsHour;
+    fix.minute = gpsState.gpsMinute;
+    fix.second = gpsState.gpsSecond;
+    return fix;
+}
+
+static IdentityText copyText(const String &text) {
+    IdentityText copy;
+    snprintf(copy.text, sizeof(copy.text), "%s", text.c_str());
+    return copy;
+}
+
+void publishGPSFix() {
+    gpsFixes.publish(TASK_GPS, copyGPSFix());
+}
+
+void publishSoldierID() {
+    soldierIDs.publish(TASK_UI, copyText(wtState.soldierID));
+}
+
+void publishPhoneNumber() {
+    phoneNumbers.publish(TASK_COMMS, copyText(gsmState.phoneNumber));
+}
+
+GPSFixSnapshot currentGPSFix() {
+    int8_t task;
+    if (readsOwnState(TASK_GPS, task)) {
+        return copyGPSFix();
+    }
+    return gpsFixes.receive((TaskId)task);
+}
+
+String currentSoldierID() {
+    int8_t task;
+    if (readsOwnState(TASK_UI, task)) {
+        return wtState.soldierID;
+    }
+    return String(soldierIDs.receive((TaskId)task).text);
+}
+
+String currentPhoneNumber() {
+    int8_t task;
+    if (readsOwnState(TASK_COMMS, task)) {
+        return gsmState.phoneNumber;
+    }
+    return String(phoneNumbers.receive((TaskId)task).text);
+}
+
+// =============== DISPLAY SNAPSHOTS ===============
+
+// The UI task draws from these copies and never reads wtState or the link
+// sampler itself. A full queue only means the display is behind; the change
+// is published again on the next one.
+void publishLinkSnapshot() {
+    static LinkSnapshot last;
+    static bool published = false;
+    LinkSnapshot link;
+    link.channel = wtState.currentChannel;
+    link.volume = wtState.volume;
+    link.radioID = wtState.myRadioID;
+    link.sampling = linkSampler.isRunning();
+    link.recent = getRecentLinkSample(link.sample);
+    if (published && link.channel == last.channel && link.volume == last.volume &&
+        link.radioID == last.radioID && link.sampling == last.sampling && link.recent == last.recent &&
+        link.sample.time == last.sample.time) {
+        return;
+    }
+    // Statistics only when something changed: they sort the sample window
+    link.hasStats = linkSampler.getStats(link.stats);
+    if (linkQueue.push(link)) {
+        last = link;
+        published = true;
+    }
+}
+
+bool receiveLinkSnapshot(LinkSnapshot &link) {
+    bool received = false;
+    while (linkQueue.pop(link)) {
+        received = true;
+    }
+    return received;
+}
+
+// =============== STALLS ===============
+
+// Runs in the stalled task once the handler returns, so the backlog shown is
+// what built up while it blocked
+static void recordStall(uint8_t source, uint32_t us, const String *command) {
+    int8_t task = currentTask();
+    uint8_t context = task < 0 ? TASK_COUNT : task;
+    uint32_t now = micros();
+    // A handler inside this one already reported the same stall
+    if (stalled[context] && now - lastStallUs[context] <= us) {
+        return;
+    }
+    stalled[context] = true;
+    lastStallUs[context] = now;
+    
+    DMR828S_Utils &lowLevel = dmr.getLowLevel();
+    const DMRParserStats &parser = lowLevel.getParserStats();
+    StallRecord record;
+    record.source = source;
+    record.task = context;
+    record.ms = us / 1000;
+    record.atMs = millis();
+    record.uartBytes = lowLevel.getRxBacklogBytes();
+    record.queuedFrames = lowLevel.getRxQueuedFrames();
+    record.rxLost = parser.overflows + parser.queueDrops;
+    if (command) {
+        snprintf(record.command, sizeof(record.command), "%s", command->c_str());
+    }
+    DMR_TRACE_ERROR(TRACE_STALL, source, record.ms, record.uartBytes, record.queuedFrames);
+    if (!stallQueue.push(record)) {
+        stallsDropped++;
+    }
+}
+
+static void onStageOverBudget(uint8_t stage, uint32_t ticks, void *context) {
+    recordStall(stage, DMRPerfProfiler::ticksToNs(ticks) / 1000, nullptr);
+}
+
+StallWatch::~StallWatch() {
+    uint32_t us = micros() - startUs;
+    if (stallBudgetUs && us > stallBudgetUs) {
+        recordStall(STALL_COMMAND, us, &command);
+    }
+}
+
+void checkPassBudget(uint32_t startUs) {
+    uint32_t us = micros() - startUs;
+    if (stallBudgetUs && us > stallBudgetUs) {
+        recordStall(STALL_PASS, us, nullptr);
+    }
+}
+
+void setStallBudget(uint32_t ms) {
+    stallBudgetUs = ms * 1000;
+    profiler.setBudget(stallBudgetUs, onStageOverBudget);
+}
+
+static const char *stallSourceName(uint8_t source) {
+    if (source < PERF_STAGE_COUNT) {
+        return perfStageNames[source];
+    }
+    return source == STALL_COMMAND ? "command" : "task pass";
+}
+
+void showStallsTo(Stream* stream) {
+    StallRecord record;
+    while (stallQueue.pop(record)) {
+        stallHistory[stallHead] = record;
+        stallHead = (stallHead + 1) % STALL_HISTORY;
+        stallsShown++;
+    }
+    
+    stream->print("\n🐢 Stalls over ");
+    stream->print(stallBudgetUs / 1000);
+    stream->print(" ms: ");
+    stream->print(stallsShown + stallsDropped);
+    if (stallsDropped > 0) {
+        stream->print(" (");
+        stream->print((uint32_t)stallsDropped);
+        stream->print(" not captured)");
+    }
+    stream->println();
+    uint8_t kept = stallsShown < STALL_HISTORY ? stallsShown : STALL_HISTORY;
+    if (kept == 0) {
+        return;
+    }
+    stream->println("  At (s)  Task   Handler          ms  UART B  Frames  Lost  Command");
+    for (uint8_t i = 0; i < kept; i++) {
+        const StallRecord &r = stallHistory[(stallHead + STALL_HISTORY - 1 - i) % STALL_HISTORY];
+        char line[120];
+        snprintf(line, sizeof(line), "%6lu.%lu  %-6s %-12s %6lu %7lu %7u %5lu  %s",
+                 (unsigned long)(r.atMs / 1000), (unsigned long)(r.atMs % 1000 / 100),
+                 r.task < TASK_COUNT ? taskSpecs[r.task].name : "loop", stallSourceName(r.source),
+                 (unsigned long)r.ms, (unsigned long)r.uartBytes, (unsigned)r.queuedFrames,
+                 (unsigned long)r.rxLost, r.command);
+        stream->println(line);
+    }
+}
+
+void clearStalls() {
+    StallRecord record;
+    while (stallQueue.pop(record)) {
+    }
+    stallHead = 0;
+    stallsShown = 0;
+    stallsDropped = 0;
+}
+
+// =============== REPORT ===============
+
+void showTasksTo(Stream* stream) {
+    if (taskState.running) {
+        stream->println("\n⚙️ Tasks:");
+        stream->println("Task   Core Prio  Free stack  Cmds  Wait max   Run max  Pass max (us)");
+        for (uint8_t i = 0; i < TASK_COUNT; i++) {
+            const TaskSpec &spec = taskSpecs[i];
+            const TaskStats &s = taskState.stats[i];
+            char line[100];
+            snprintf(line, sizeof(line), "%-6s %4d %4u  %10u %5lu %9lu %9lu %9lu", spec.name,
+                     (int)spec.core, (unsigned)spec.priority,
+                     taskHandles[i] ? (unsigned)uxTaskGetStackHighWaterMark(taskHandles[i]) : 0,
+                     (unsigned long)s.commands, (unsigned long)s.maxWaitUs,
+                     (unsigned long)s.maxRunUs, (unsigned long)s.maxPassUs);
+            stream->print(line);
+            stream->println(taskHandles[i] ? "" : "  NOT RUNNING");
+            if (s.refused > 0) {
+                stream->print("       ");
+                stream->print(s.refused);
+                stream->println(" commands refused (queue full)");
+            }
+        }
+    } else {
+        stream->println("\n⚙️ Tasks not running - cooperative loop()");
+    }
+    
+    // Same measurement in both builds: compare WT_USE_TASKS 1 against 0
+    DMR828S_Utils &lowLevel = dmr.getLowLevel();
+    if (!lowLevel.isEventRxActive()) {
+        stream->println("DMR event latency: not measured (receive task not running)");
+        return;
+    }
+    const DMRRxLatency &latency = lowLevel.getRxLatency();
+    stream->print("DMR event latency (frame queued -> handled), ");
+    stream->print(latency.frames);
+    stream->println(" frames:");
+    stream->print("  last "); stream->print(latency.lastUs);
+    stream->print(" us, mean "); stream->print(latency.meanUs());
+    stream->print(" us, worst "); stream->print(latency.maxUs);
+    stream->println(" us");
+}
+
+void showTimersTo(Stream* stream) {
+    unsigned long elapsed = millis() - timerStatsSince;
+    stream->print("\n⏱️ Timers (");
+    stream->print(elapsed / 1000);
+    stream->println(" s):");
+    for (uint8_t t = 0; t < TASK_COUNT; t++) {
+        const DMRTimerService &timers = timerServices[t];
+        if (timers.getCount() == 0) {
+            continue;
+        }
+        stream->print(WT_USE_TASKS ? taskSpecs[t].name : "loop");
+        stream->print(": ");
+        stream->print(timers.getRuns());
+        stream->print(" wakeups, ");
+        stream->print(elapsed ? timers.getRuns() * 1000UL / elapsed : 0);
+        stream->println("/s");
+        stream->println("  Timer      Period  Fired Missed  Late last/mean/max (us)");
+        for (uint8_t i = 0; i < timers.getCount(); i++) {
+            DMRTimerId id;
+            const char *name;
+            uint32_t periodMs;
+            DMRTimerStats stats;
+            timers.getTimer(i, id, name, periodMs, stats);
+            char line[100];
+            snprintf(line, sizeof(line), "  %-10s %6lu %6lu %6lu  %lu/%lu/%lu", name ? name : "?",
+                     (unsigned long)periodMs, (unsigned long)stats.fired, (unsigned long)stats.missed,
+                     (unsigned long)stats.lastLateUs, (unsigned long)stats.meanLateUs(),
+                     (unsigned long)stats.maxLateUs);
+            stream->println(line);
+        }
+    }
+}
+
+void showPerfTo(Stream* stream) {
+    stream->print("\n📊 Stage latency over ");
+    stream->print((millis() - perfSince) / 1000);
+    stream->println(" s (bucket upper bounds):");
+    profiler.printTo(*stream);
+}
+
+void resetPerf() {
+    profiler.reset();
+    perfSince = millis();
+}
+
+void resetTaskStats() {
+    for (uint8_t i = 0; i < TASK_COUNT; i++) {
+        taskState.stats[i] = TaskStats();
+        timerServices[i].clearStats();
+    }
+    timerStatsSince = millis();
+    dmr.getLowLevel().resetRxLatency();
+}
\ No newline at end of file
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <Arduino.h>
+#include "DMR828S_queue.h"
+#include "DMR828S_timer.h"
+#include "DMR828S_perf.h"
+#include "DMR828S_link.h"
+
+// Each subsystem runs in its own task, pinned so radio I/O never shares a
+// core with the Bluetooth stack or a blocking GSM exchange. A command is
+// executed by the task that owns what it touches, and anything may log to the
+// display through its message queue. State other tasks need whole is handed
+// over as copies, through queues or per-task mailboxes: the GPS task publishes
+// its fix, time and UTC clock, the radio task a link snapshot for the display,
+// the UI task the soldier ID and the comms task the fallback phone number.
+// Single-word flags and counters (gsmState.initialized, wtState.currentChannel,
+// ...) are still read across tasks directly; they can be stale, never torn.
+// Periodic work runs from per-task timer services and tasks sleep until the
+// next deadline, a queued command or (radio) a received frame.
+// Set WT_USE_TASKS to 0 for the old cooperative loop() (to compare latency).
+#ifndef WT_USE_TASKS
+#define WT_USE_TASKS 1
+#endif
+
+// Core 1: radio I/O (above GPS, below the DMR receive task so frames are parsed first)
+#define RADIO_TASK_CORE 1
+#define RADIO_TASK_PRIORITY 2
+#define RADIO_TASK_STACK 6144
+#define RADIO_POLL_MS 20                // Longest sleep with no frame: request timeouts, sampler, scan
+
+#define GPS_TASK_CORE 1
+#define GPS_TASK_PRIORITY 1
+#define GPS_TASK_STACK 4096
+
+// Core 0, alongside the Bluetooth stack
+#define UI_TASK_CORE 0
+#define UI_TASK_PRIORITY 2
+#define UI_TASK_STACK 8192
+
+#define COMMS_TASK_CORE 0
+#define COMMS_TASK_PRIORITY 1
+#define COMMS_TASK_STACK 6144
+
+// Timer periods. Equal periods share a wakeup.
+#define GPS_READ_MS 20                  // 9600 baud NMEA: ~20 bytes; also bounds the hop clock's skew
+#define BLUETOOTH_POLL_MS 50
+#define KEY_SCAN_MS 50                  // Also the debounce interval
+#define DISPLAY_REFRESH_MS 500
+#define CONFIG_CHECK_MS 1000            // Saves land 0-1 s after CONFIG_SAVE_DELAY_MS
+#define GSM_POLL_MS 100                 // 9600 baud: ~96 bytes, well inside the UART buffer
+#define LORA_POLL_MS 100                // A packet waits in the radio's FIFO until read
+
+// A profiled stage, a command or a whole task pass running longer than this
+// is a stall: the DMR receive path is not being drained meanwhile
+#define STALL_BUDGET_MS 100
+#define STALL_HISTORY 8                 // Newest stalls kept for the 'stalls' command
+#define STALL_COMMAND_LEN 24
+
+#define TASK_QUEUE_DEPTH 4
+#define TASK_POST_TIMEOUT_MS 1000       // Owner's queue full this long: command refused
+// A routed command still running after this is abandoned by its caller and its
+// further output dropped; longer than any command (GSM exchanges take seconds)
+#define TASK_ROUTE_TIMEOUT_MS 15000
+#define IDENTITY_TEXT_LEN 24            // Soldier ID or phone number, with its terminator
+
+enum TaskId : uint8_t {
+    TASK_RADIO,                         // DMR module, link sampler, scanner, hopping
+    TASK_GPS,                           // GPS UART and gpsState
+    TASK_UI,                            // Bluetooth input, keypad, display, stored config
+    TASK_COMMS,                         // GSM and LoRa
+    TASK_COUNT
+};
+
+// Profiled stages for the 'perf' command; names in TaskManager.cpp
+enum PerfStage : uint8_t {
+    PERF_DMR_UPDATE,
+    PERF_LINK_SAMPLER,
+    PERF_SCANNER,
+    PERF_HOPPING,
+    PERF_GPS_READ,
+    PERF_BLUETOOTH,
+    PERF_KEYPAD,
+    PERF_KEY_EVENTS,
+    PERF_DISPLAY,
+    PERF_CONFIG,
+    PERF_GSM_POLL,
+    PERF_LORA_POLL,
+    PERF_MEMORY,
+    PERF_STAGE_COUNT,
+    STALL_COMMAND = PERF_STAGE_COUNT,   // Stall sources beyond the profiled stages
+    STALL_PASS
+};
+
+// UTC fix handed from the GPS task to the radio task
+struct GPSTimeSync {
+    uint64_t utcMillis = 0;
+    unsigned long atMillis = 0;
+};
+
+// Radio state for the display, published by the radio task
+struct LinkSnapshot {
+    uint8_t channel = 0;
+    uint8_t volume = 0;
+    uint32_t radioID = 0;
+    bool sampling = false;              // Link sampler running
+    bool recent = false;                // sample is fresh (getRecentLinkSample)
+    DMRLinkSample sample;
+    bool hasStats = false;
+    DMRLinkStats stats;
+};
+
+// GPS position and time, published by the GPS task for the other tasks
+struct GPSFixSnapshot {
+    bool valid = false;                 // latitude/longitude are a current fix
+    double latitude = 0;
+    double longitude = 0;
+    bool hasLast = false;               // lastLatitude/lastLongitude hold an earlier fix
+    double lastLatitude = 0;
+    double lastLongitude = 0;
+    bool hasTime = false;
+    int year = 2025;
+    int month = 1;
+    int day = 1;
+    int hour = 0;
+    int minute = 0;
+    int second = 0;
+};
+
+// Soldier ID or phone number, copied out of its owner's String
+struct IdentityText {
+    char text[IDENTITY_TEXT_LEN] = "";
+};
+
+// Per-task counters for the 'tasks' command
+struct TaskStats {
+    uint32_t commands = 0;              // Commands executed for other tasks
+    uint32_t refused = 0;               // Not queued: owner's queue stayed full
+    uint32_t maxWaitUs = 0;             // Longest a command sat in the queue
+    uint32_t maxRunUs = 0;              // Longest command run on this task
+    uint32_t maxPassUs = 0;             // Longest pass through the task's own work
+};
+
+// One budget overrun, captured by the stalled task as it ends
+struct StallRecord {
+    uint8_t source = 0;                 // PerfStage, STALL_COMMAND or STALL_PASS
+    uint8_t task = 0;                   // TaskId, TASK_COUNT for loop() and boot
+    uint32_t ms = 0;
+    uint32_t atMs = 0;                  // millis() when it ended
+    uint32_t uartBytes = 0;             // DMR receive backlog at that moment
+    uint16_t queuedFrames = 0;
+    uint32_t rxLost = 0;                // Receive overflows and queue drops since boot
+    char command[STALL_COMMAND_LEN] = "";
+};
+
+// Times a command against the stall budget (nested handlers are reported once, innermost)
+class StallWatch {
+public:
+    StallWatch(const String &command) : command(command), startUs(micros()) {}
+    ~StallWatch();
+private:
+    const String &command;
+    uint32_t startUs;
+};
+
+struct TaskState {
+    bool running = false;
+    TaskStats stats[TASK_COUNT];
+};
+
+extern TaskState taskState;
+
+// Task functions
+void initializeTasks();                 // Command queues; before anything may post (start of boot)
+bool startTasks();                      // After boot; the Arduino loop() is then unused
+void startTaskTimers();                 // Periodic jobs; from startTasks(), or end of setup() without tasks
+// The task's timer service; one shared service in the cooperative build.
+// Only use it from that task (gpsauto runs on the GPS task).
+DMRTimerService &taskTimers(TaskId task);
+uint32_t runTaskTimers();               // Cooperative loop(): fire due jobs, ms until the next
+uint32_t radioWaitMs();                 // Radio side: longest sleep before dmr/hop work is due
+void updateRadio();                     // One radio pass: dmr.update(), sampler, scanner, hopping
+void checkPassBudget(uint32_t startUs); // End of a loop() pass begun at startUs (tasks check their own)
+TaskId commandOwner(const String &command);
+// Runs the command on its owner and waits for it, so output is complete when this
+// returns (up to TASK_ROUTE_TIMEOUT_MS; later output is dropped). False when no
+// hand-off is needed (caller is the owner, or no tasks yet).
+bool routeCommand(Stream* stream, const String &command);
+// Same without waiting, for callers that must not block (radio event callbacks).
+// Without tasks the command runs inline.
+void postCommand(TaskId task, Stream* stream, const String &command);
+void publishGPSTime();                  // GPS side: latest UTC fix, if new
+bool receiveGPSTime(GPSTimeSync &sync); // Radio side: true once per new fix
+void publishGPSFix();                   // GPS side: fix and time for the other tasks, if changed
+void publishSoldierID();                // UI side: wtState.soldierID, if changed
+void publishPhoneNumber();              // Comms side: gsmState.phoneNumber, if changed
+// Any task: the newest copy it has been sent (the owner, or any caller
+// without tasks, reads the state itself)
+GPSFixSnapshot currentGPSFix();
+String currentSoldierID();
+String currentPhoneNumber();
+void publishLinkSnapshot();             // Radio side: after the sampler, if anything shown changed
+bool receiveLinkSnapshot(LinkSnapshot &link);   // UI side: true when a newer one arrived
+void showTasksTo(Stream* stream);
+void showTimersTo(Stream* stream);
+void showPerfTo(Stream* stream);
+void resetPerf();
+void setStallBudget(uint32_t ms);       // 0 turns the watchdog off
+void showStallsTo(Stream* stream);
+void clearStalls();
+void resetTaskStats();
\ No newline at end of file